@@ -0,0 +1,260 @@
+﻿
+/// @file AigBalance.cc
+/// @brief AIG のトポロジカルソートと段数削減を行う関数の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "AigBalance.h"
+#include <queue>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 極性を正にした AIG を返す．
+inline
+Aig
+regular(Aig aig)
+{
+  return aig.inv() ? ~aig : aig;
+}
+
+// 段数と AIG の組
+typedef pair<ymuint, Aig> LevelAig;
+
+// 段数の小さいものを先に取り出すための比較関数
+struct LevelGt
+{
+  bool
+  operator()(const LevelAig& left,
+	     const LevelAig& right) const
+  {
+    return left.first > right.first;
+  }
+};
+
+// AIG の段数を返す．
+// level_map にないものは入力か定数なので 0 となる．
+ymuint
+level_of(Aig aig,
+	 const unordered_map<Aig, ymuint>& level_map)
+{
+  if ( !aig.is_and() ) {
+    return 0;
+  }
+  unordered_map<Aig, ymuint>::const_iterator p = level_map.find(regular(aig));
+  if ( p == level_map.end() ) {
+    return 0;
+  }
+  return p->second;
+}
+
+// 元の AIG を新しい AIG に置き換える．
+Aig
+map_aig(Aig aig,
+	const unordered_map<Aig, Aig>& new_map)
+{
+  if ( !aig.is_and() ) {
+    return aig;
+  }
+  unordered_map<Aig, Aig>::const_iterator p = new_map.find(regular(aig));
+  ASSERT_COND( p != new_map.end() );
+  Aig new_aig = p->second;
+  return aig.inv() ? ~new_aig : new_aig;
+}
+
+// 多入力 AND を段数の小さいものから2つずつ組み合わせて作る．
+Aig
+make_balanced_and(AigMgr& aig_mgr,
+		  const vector<Aig>& leaf_list,
+		  unordered_map<Aig, ymuint>& level_map)
+{
+  // 重複を除き，定数と相補な入力を処理する．
+  unordered_set<Aig> leaf_set;
+  priority_queue<LevelAig, vector<LevelAig>, LevelGt> queue;
+  for (vector<Aig>::const_iterator p = leaf_list.begin();
+       p != leaf_list.end(); ++ p) {
+    Aig leaf = *p;
+    if ( leaf.is_zero() || leaf_set.count(~leaf) > 0 ) {
+      return aig_mgr.make_zero();
+    }
+    if ( leaf.is_one() ) {
+      continue;
+    }
+    if ( leaf_set.insert(leaf).second ) {
+      queue.push(LevelAig(level_of(leaf, level_map), leaf));
+    }
+  }
+  if ( queue.empty() ) {
+    return aig_mgr.make_one();
+  }
+
+  while ( queue.size() > 1 ) {
+    LevelAig left = queue.top();
+    queue.pop();
+    LevelAig right = queue.top();
+    queue.pop();
+    Aig aig = aig_mgr.make_and(left.second, right.second);
+    if ( aig.is_and() ) {
+      // 構造ハッシュで既存のノードが返された時はその段数を用いる．
+      ymuint level = (left.first > right.first ? left.first : right.first) + 1;
+      level_map.insert(make_pair(regular(aig), level));
+    }
+    queue.push(LevelAig(level_of(aig, level_map), aig));
+  }
+  return queue.top().second;
+}
+
+END_NONAMESPACE
+
+
+// @brief 出力から到達可能な AND ノードをトポロジカル順に並べる．
+// @param[in] output_list 出力の AIG のリスト
+// @param[out] node_list AND ノードのリスト(極性は正)
+void
+aig_sort(const vector<Aig>& output_list,
+	 vector<Aig>& node_list)
+{
+  node_list.clear();
+
+  // 2番目の要素はファンインを積んだ後の時 true
+  unordered_set<Aig> mark;
+  vector<pair<Aig, bool> > stack;
+  for (vector<Aig>::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    Aig aig = *p;
+    if ( aig.is_and() ) {
+      stack.push_back(make_pair(regular(aig), false));
+    }
+    while ( !stack.empty() ) {
+      Aig node = stack.back().first;
+      bool expanded = stack.back().second;
+      stack.pop_back();
+      if ( expanded ) {
+	node_list.push_back(node);
+	continue;
+      }
+      if ( !mark.insert(node).second ) {
+	continue;
+      }
+      stack.push_back(make_pair(node, true));
+      Aig fanin1 = node.fanin1();
+      if ( fanin1.is_and() && mark.count(regular(fanin1)) == 0 ) {
+	stack.push_back(make_pair(regular(fanin1), false));
+      }
+      Aig fanin0 = node.fanin0();
+      if ( fanin0.is_and() && mark.count(regular(fanin0)) == 0 ) {
+	stack.push_back(make_pair(regular(fanin0), false));
+      }
+    }
+  }
+}
+
+// @brief AIG の段数を求める．
+// @param[in] output_list 出力の AIG のリスト
+// @param[in] node_list aig_sort() で求めた AND ノードのリスト
+// @return 入力から出力までの AND ノードの段数の最大値を返す．
+ymuint
+aig_depth(const vector<Aig>& output_list,
+	  const vector<Aig>& node_list)
+{
+  unordered_map<Aig, ymuint> level_map;
+  for (vector<Aig>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    Aig node = *p;
+    ymuint level0 = level_of(node.fanin0(), level_map);
+    ymuint level1 = level_of(node.fanin1(), level_map);
+    ymuint level = (level0 > level1 ? level0 : level1) + 1;
+    level_map.insert(make_pair(node, level));
+  }
+
+  ymuint depth = 0;
+  for (vector<Aig>::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    ymuint level = level_of(*p, level_map);
+    if ( depth < level ) {
+      depth = level;
+    }
+  }
+  return depth;
+}
+
+// @brief AIG の段数を削減する．
+// @param[in] aig_mgr AIG マネージャ
+// @param[in] output_list 出力の AIG のリスト
+// @param[in] node_list aig_sort() で求めた AND ノードのリスト
+// @param[out] new_output_list 段数を削減した出力の AIG のリスト
+void
+aig_balance(AigMgr& aig_mgr,
+	    const vector<Aig>& output_list,
+	    const vector<Aig>& node_list,
+	    vector<Aig>& new_output_list)
+{
+  // 多入力 AND の根となるノードを求める．
+  // 反転して参照されるか，2つ以上のファンアウトを持つか，
+  // 出力から参照されるノードが根となる．
+  unordered_map<Aig, ymuint> fanout_map;
+  unordered_set<Aig> root_set;
+  for (vector<Aig>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    Aig node = *p;
+    Aig fanin[2] = { node.fanin0(), node.fanin1() };
+    for (ymuint i = 0; i < 2; ++ i) {
+      if ( fanin[i].is_and() ) {
+	Aig r = regular(fanin[i]);
+	if ( ++ fanout_map[r] > 1 || fanin[i].inv() ) {
+	  root_set.insert(r);
+	}
+      }
+    }
+  }
+  for (vector<Aig>::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    if ( p->is_and() ) {
+      root_set.insert(regular(*p));
+    }
+  }
+
+  // 根ごとに葉を集めて作り直す．
+  // node_list はトポロジカル順なので葉の根は作り直し済みになっている．
+  unordered_map<Aig, Aig> new_map;
+  unordered_map<Aig, ymuint> level_map;
+  vector<Aig> stack;
+  vector<Aig> leaf_list;
+  for (vector<Aig>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    Aig node = *p;
+    if ( root_set.count(node) == 0 ) {
+      continue;
+    }
+    leaf_list.clear();
+    stack.push_back(node.fanin1());
+    stack.push_back(node.fanin0());
+    while ( !stack.empty() ) {
+      Aig aig = stack.back();
+      stack.pop_back();
+      if ( aig.is_and() && !aig.inv() && root_set.count(aig) == 0 ) {
+	stack.push_back(aig.fanin1());
+	stack.push_back(aig.fanin0());
+      }
+      else {
+	leaf_list.push_back(map_aig(aig, new_map));
+      }
+    }
+    Aig new_aig = make_balanced_and(aig_mgr, leaf_list, level_map);
+    new_map.insert(make_pair(node, new_aig));
+  }
+
+  new_output_list.clear();
+  new_output_list.reserve(output_list.size());
+  for (vector<Aig>::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    new_output_list.push_back(map_aig(*p, new_map));
+  }
+}
+
+END_NAMESPACE_YM
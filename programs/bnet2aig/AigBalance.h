@@ -0,0 +1,51 @@
+﻿#ifndef AIGBALANCE_H
+#define AIGBALANCE_H
+
+/// @file AigBalance.h
+/// @brief AIG のトポロジカルソートと段数削減を行う関数のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+///
+/// 数百万ノードの AIG を扱うので，どの関数も再帰を用いずにたどる．
+
+
+#include "YmLogic/AigMgr.h"
+#include "YmLogic/Aig.h"
+
+
+BEGIN_NAMESPACE_YM
+
+/// @brief 出力から到達可能な AND ノードをトポロジカル順に並べる．
+/// @param[in] output_list 出力の AIG のリスト
+/// @param[out] node_list AND ノードのリスト(極性は正)
+void
+aig_sort(const vector<Aig>& output_list,
+	 vector<Aig>& node_list);
+
+/// @brief AIG の段数を求める．
+/// @param[in] output_list 出力の AIG のリスト
+/// @param[in] node_list aig_sort() で求めた AND ノードのリスト
+/// @return 入力から出力までの AND ノードの段数の最大値を返す．
+ymuint
+aig_depth(const vector<Aig>& output_list,
+	  const vector<Aig>& node_list);
+
+/// @brief AIG の段数を削減する．
+/// @param[in] aig_mgr AIG マネージャ
+/// @param[in] output_list 出力の AIG のリスト
+/// @param[in] node_list aig_sort() で求めた AND ノードのリスト
+/// @param[out] new_output_list 段数を削減した出力の AIG のリスト
+/// @note 反転せずにファンアウトが1つの AND ノードをまとめて多入力 AND
+/// とみなし，段数の小さいものから2つずつ組み合わせて作り直す．
+/// @note 新しいノードは同じ aig_mgr に作るので構造ハッシュで共有される．
+void
+aig_balance(AigMgr& aig_mgr,
+	    const vector<Aig>& output_list,
+	    const vector<Aig>& node_list,
+	    vector<Aig>& new_output_list);
+
+END_NAMESPACE_YM
+
+#endif // AIGBALANCE_H
@@ -0,0 +1,444 @@
+﻿
+/// @file AigFrag.cc
+/// @brief AigFrag の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "AigFrag.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// リテラルのコードを返す．
+inline
+ymuint32
+literal(const Expr& expr)
+{
+  ymuint32 lit = (expr.varid().val() + 1) * 2;
+  if ( expr.is_negaliteral() ) {
+    lit |= 1U;
+  }
+  return lit;
+}
+
+// 符号の種類を返す．
+inline
+ymuint32
+code_type(ymuint32 code)
+{
+  return code & 3U;
+}
+
+// 符号の値(リテラルか子供の数)を返す．
+inline
+ymuint32
+code_val(ymuint32 code)
+{
+  return code >> 2;
+}
+
+// 符号がリテラル(定数は含まない)の時 true を返す．
+inline
+bool
+is_literal_code(ymuint32 code)
+{
+  return code_type(code) == AigFrag::kCodeLit && code_val(code) > 1;
+}
+
+// 符号列の先頭がリテラルかリテラルの AND の時 true を返す．
+// true の時は cube にリテラルを入れ，code を次に進める．
+bool
+get_cube(const ymuint32*& code,
+	 vector<ymuint32>& cube)
+{
+  cube.clear();
+  ymuint32 head = *code;
+  if ( is_literal_code(head) ) {
+    cube.push_back(code_val(head));
+    ++ code;
+    return true;
+  }
+  if ( code_type(head) != AigFrag::kCodeAnd ) {
+    return false;
+  }
+  ymuint nc = code_val(head);
+  cube.reserve(nc);
+  for (ymuint i = 0; i < nc; ++ i) {
+    ymuint32 child = code[i + 1];
+    if ( !is_literal_code(child) ) {
+      return false;
+    }
+    cube.push_back(code_val(child));
+  }
+  code += nc + 1;
+  // 同じリテラルが複数回現れても1回と数えるように重複を除く．
+  sort(cube.begin(), cube.end());
+  cube.erase(unique(cube.begin(), cube.end()), cube.end());
+  return true;
+}
+
+// 符号列が積和形(リテラルか，リテラルの AND か，それらの OR)の時 true を返す．
+// true の時は cube_list にキューブを入れる．
+bool
+get_sop(const ymuint32* code,
+	vector<vector<ymuint32> >& cube_list)
+{
+  cube_list.clear();
+  ymuint32 head = *code;
+  if ( is_literal_code(head) || code_type(head) == AigFrag::kCodeAnd ) {
+    cube_list.resize(1);
+    return get_cube(code, cube_list[0]);
+  }
+  if ( code_type(head) != AigFrag::kCodeOr ) {
+    return false;
+  }
+  ymuint nc = code_val(head);
+  cube_list.resize(nc);
+  ++ code;
+  for (ymuint i = 0; i < nc; ++ i) {
+    if ( !get_cube(code, cube_list[i]) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス AigFrag
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+AigFrag::AigFrag() :
+  mInputNum(0),
+  mRoot(0)
+{
+}
+
+// @brief デストラクタ
+AigFrag::~AigFrag()
+{
+}
+
+// @brief 論理式を符号列に変換する．
+// @param[in] expr 論理式
+// @param[inout] code_list 符号列を追加するリスト
+void
+AigFrag::encode(const Expr& expr,
+		vector<ymuint32>& code_list)
+{
+  if ( expr.is_zero() ) {
+    code_list.push_back((0U << 2) | kCodeLit);
+    return;
+  }
+  if ( expr.is_one() ) {
+    code_list.push_back((1U << 2) | kCodeLit);
+    return;
+  }
+  if ( expr.is_posiliteral() || expr.is_negaliteral() ) {
+    code_list.push_back((literal(expr) << 2) | kCodeLit);
+    return;
+  }
+
+  ymuint32 type;
+  if ( expr.is_and() ) {
+    type = kCodeAnd;
+  }
+  else if ( expr.is_or() ) {
+    type = kCodeOr;
+  }
+  else {
+    ASSERT_COND( expr.is_xor() );
+    type = kCodeXor;
+  }
+  ymuint nc = expr.child_num();
+  code_list.push_back((nc << 2) | type);
+  for (ymuint i = 0; i < nc; ++ i) {
+    encode(expr.child(i), code_list);
+  }
+}
+
+// @brief 符号化した論理式から作る．
+// @param[in] code encode() で作った符号列の先頭
+// @param[in] ni ファンイン数
+void
+AigFrag::set(const ymuint32* code,
+	     ymuint ni)
+{
+  clear();
+  mInputNum = ni;
+
+  vector<vector<ymuint32> > cube_list;
+  if ( get_sop(code, cube_list) ) {
+    mRoot = make_factor(cube_list);
+  }
+  else {
+    mRoot = make_expr(code);
+  }
+
+  // 構造ハッシュは作る時にしか使わないので解放しておく．
+  unordered_map<ymuint64, ymuint32> tmp;
+  mHash.swap(tmp);
+}
+
+// @brief 内容をクリアする．
+void
+AigFrag::clear()
+{
+  mInputNum = 0;
+  mFaninArray.clear();
+  mRoot = 0;
+  mHash.clear();
+}
+
+// @brief AigMgr 上に AIG を作る．
+// @param[in] aig_mgr AIG マネージャ
+// @param[in] fanins ファンインの AIG の配列
+// @return 根の AIG を返す．
+Aig
+AigFrag::to_aig(AigMgr& aig_mgr,
+		const vector<Aig>& fanins) const
+{
+  ASSERT_COND( fanins.size() == mInputNum );
+
+  // 変数番号から AIG を得る配列
+  ymuint n = and_num();
+  vector<Aig> var_array(mInputNum + n + 1);
+  var_array[0] = aig_mgr.make_zero();
+  for (ymuint i = 0; i < mInputNum; ++ i) {
+    var_array[i + 1] = fanins[i];
+  }
+  for (ymuint i = 0; i < n; ++ i) {
+    ymuint32 lit0 = mFaninArray[i * 2 + 0];
+    ymuint32 lit1 = mFaninArray[i * 2 + 1];
+    Aig aig0 = var_array[lit0 >> 1];
+    if ( lit0 & 1U ) {
+      aig0 = ~aig0;
+    }
+    Aig aig1 = var_array[lit1 >> 1];
+    if ( lit1 & 1U ) {
+      aig1 = ~aig1;
+    }
+    var_array[mInputNum + i + 1] = aig_mgr.make_and(aig0, aig1);
+  }
+
+  Aig root = var_array[mRoot >> 1];
+  if ( mRoot & 1U ) {
+    root = ~root;
+  }
+  return root;
+}
+
+// @brief 論理式をそのままの構造で作る．
+// @param[inout] code 符号列の現在位置(作った部分の次に進める)
+ymuint32
+AigFrag::make_expr(const ymuint32*& code)
+{
+  ymuint32 head = *code;
+  ++ code;
+  ymuint32 type = code_type(head);
+  if ( type == kCodeLit ) {
+    return code_val(head);
+  }
+
+  ymuint nc = code_val(head);
+  vector<ymuint32> child_array(nc);
+  bool child_inv = (type == kCodeOr);
+  for (ymuint i = 0; i < nc; ++ i) {
+    child_array[i] = make_expr(code);
+    if ( child_inv ) {
+      child_array[i] ^= 1U;
+    }
+  }
+
+  if ( type == kCodeAnd ) {
+    return make_and_tree(child_array, 0, nc);
+  }
+  if ( type == kCodeOr ) {
+    return make_and_tree(child_array, 0, nc) ^ 1U;
+  }
+  return make_xor_tree(child_array, 0, nc);
+}
+
+// @brief 積和形をくくり出しながら作る．
+// @param[in] cube_list キューブのリスト(キューブはリテラルのリスト)
+// @note 2つ以上のキューブに現れるリテラルのうち最も頻度の高いものを
+// 選び，F = lit & (F / lit) | (残り) として再帰的に作る．
+ymuint32
+AigFrag::make_factor(const vector<vector<ymuint32> >& cube_list)
+{
+  ymuint nc = cube_list.size();
+  if ( nc == 0 ) {
+    return 0;
+  }
+  for (ymuint i = 0; i < nc; ++ i) {
+    if ( cube_list[i].empty() ) {
+      return 1;
+    }
+  }
+  if ( nc == 1 ) {
+    const vector<ymuint32>& cube = cube_list[0];
+    return make_and_tree(cube, 0, cube.size());
+  }
+
+  // リテラルの出現回数を数える．
+  vector<ymuint> count_array((mInputNum + 1) * 2, 0);
+  ymuint32 best_lit = 0;
+  ymuint best_count = 1;
+  for (ymuint i = 0; i < nc; ++ i) {
+    const vector<ymuint32>& cube = cube_list[i];
+    for (vector<ymuint32>::const_iterator p = cube.begin();
+	 p != cube.end(); ++ p) {
+      ymuint32 lit = *p;
+      ymuint c = ++ count_array[lit];
+      if ( best_count < c || (best_count == c && lit < best_lit) ) {
+	best_lit = lit;
+	best_count = c;
+      }
+    }
+  }
+
+  if ( best_count <= 1 ) {
+    // 共通のリテラルがないので各キューブの OR を作る．
+    vector<ymuint32> lit_list(nc);
+    for (ymuint i = 0; i < nc; ++ i) {
+      const vector<ymuint32>& cube = cube_list[i];
+      lit_list[i] = make_and_tree(cube, 0, cube.size()) ^ 1U;
+    }
+    return make_and_tree(lit_list, 0, nc) ^ 1U;
+  }
+
+  // best_lit を含むキューブの商と残りに分ける．
+  vector<vector<ymuint32> > quo_list;
+  vector<vector<ymuint32> > rem_list;
+  quo_list.reserve(best_count);
+  rem_list.reserve(nc - best_count);
+  for (ymuint i = 0; i < nc; ++ i) {
+    const vector<ymuint32>& cube = cube_list[i];
+    vector<ymuint32>::const_iterator p = find(cube.begin(), cube.end(),
+					      best_lit);
+    if ( p == cube.end() ) {
+      rem_list.push_back(cube);
+    }
+    else {
+      quo_list.push_back(vector<ymuint32>());
+      vector<ymuint32>& quo = quo_list.back();
+      quo.reserve(cube.size() - 1);
+      for (vector<ymuint32>::const_iterator q = cube.begin();
+	   q != cube.end(); ++ q) {
+	if ( *q != best_lit ) {
+	  quo.push_back(*q);
+	}
+      }
+    }
+  }
+
+  ymuint32 quo = make_factor(quo_list);
+  ymuint32 lit = make_and(best_lit, quo);
+  if ( rem_list.empty() ) {
+    return lit;
+  }
+  ymuint32 rem = make_factor(rem_list);
+  return make_or(lit, rem);
+}
+
+// @brief リテラルの AND の木を作る．
+ymuint32
+AigFrag::make_and_tree(const vector<ymuint32>& lit_list,
+		       ymuint begin,
+		       ymuint end)
+{
+  ymuint n = end - begin;
+  if ( n == 0 ) {
+    return 1;
+  }
+  if ( n == 1 ) {
+    return lit_list[begin];
+  }
+
+  ymuint h = n / 2;
+  ymuint32 l = make_and_tree(lit_list, begin, begin + h);
+  ymuint32 r = make_and_tree(lit_list, begin + h, end);
+  return make_and(l, r);
+}
+
+// @brief リテラルの XOR の木を作る．
+ymuint32
+AigFrag::make_xor_tree(const vector<ymuint32>& lit_list,
+		       ymuint begin,
+		       ymuint end)
+{
+  ymuint n = end - begin;
+  if ( n == 0 ) {
+    return 0;
+  }
+  if ( n == 1 ) {
+    return lit_list[begin];
+  }
+
+  ymuint h = n / 2;
+  ymuint32 l = make_xor_tree(lit_list, begin, begin + h);
+  ymuint32 r = make_xor_tree(lit_list, begin + h, end);
+  return make_xor(l, r);
+}
+
+// @brief AND ノードを作る．
+ymuint32
+AigFrag::make_and(ymuint32 lit0,
+		  ymuint32 lit1)
+{
+  if ( lit0 == 0 || lit1 == 0 || lit0 == (lit1 ^ 1U) ) {
+    return 0;
+  }
+  if ( lit0 == 1 || lit0 == lit1 ) {
+    return lit1;
+  }
+  if ( lit1 == 1 ) {
+    return lit0;
+  }
+  if ( lit0 > lit1 ) {
+    ymuint32 tmp = lit0;
+    lit0 = lit1;
+    lit1 = tmp;
+  }
+
+  ymuint64 key = (static_cast<ymuint64>(lit0) << 32) | lit1;
+  unordered_map<ymuint64, ymuint32>::iterator p = mHash.find(key);
+  if ( p != mHash.end() ) {
+    return p->second;
+  }
+
+  ymuint32 lit = (mInputNum + and_num() + 1) * 2;
+  mFaninArray.push_back(lit0);
+  mFaninArray.push_back(lit1);
+  mHash.insert(make_pair(key, lit));
+  return lit;
+}
+
+// @brief OR ノードを作る．
+ymuint32
+AigFrag::make_or(ymuint32 lit0,
+		 ymuint32 lit1)
+{
+  return make_and(lit0 ^ 1U, lit1 ^ 1U) ^ 1U;
+}
+
+// @brief XOR ノードを作る．
+ymuint32
+AigFrag::make_xor(ymuint32 lit0,
+		  ymuint32 lit1)
+{
+  ymuint32 tmp0 = make_and(lit0, lit1 ^ 1U);
+  ymuint32 tmp1 = make_and(lit0 ^ 1U, lit1);
+  return make_or(tmp0, tmp1);
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,167 @@
+﻿#ifndef AIGFRAG_H
+#define AIGFRAG_H
+
+/// @file AigFrag.h
+/// @brief AigFrag のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmLogic/AigMgr.h"
+#include "YmLogic/Aig.h"
+#include "YmLogic/Expr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class AigFrag AigFrag.h "AigFrag.h"
+/// @brief 1つのノードの論理式を表す局所的な AIG
+///
+/// AigMgr を用いずに作るので，異なるノードの AigFrag を別々のスレッドで
+/// 作ることができる．
+/// ただし Expr の参照回数はスレッドセーフではないので，論理式は
+/// あらかじめ1つのスレッドで encode() を用いて符号列に変換しておき，
+/// 各スレッドは符号列だけを読む．
+/// リテラルは 0 が定数0，1 が定数1，それ以外は 変数番号 * 2 + 極性 で，
+/// 変数番号 1 〜 ni がファンイン 0 〜 ni - 1，それ以降が AND ノードを表す．
+//////////////////////////////////////////////////////////////////////
+class AigFrag
+{
+public:
+
+  /// @brief 符号の種類
+  enum tCode {
+    kCodeLit = 0,
+    kCodeAnd = 1,
+    kCodeOr  = 2,
+    kCodeXor = 3
+  };
+
+  /// @brief コンストラクタ
+  AigFrag();
+
+  /// @brief デストラクタ
+  ~AigFrag();
+
+
+public:
+
+  /// @brief 論理式を符号列に変換する．
+  /// @param[in] expr 論理式
+  /// @param[inout] code_list 符号列を追加するリスト
+  /// @note 符号列は前置記法で，1つの要素が論理式の1つのノードを表す．
+  /// 下位2ビットが種類(kCodeLit, kCodeAnd, kCodeOr, kCodeXor)で，
+  /// 残りはリテラル(定数を含む)の時はそのリテラル，それ以外の時は
+  /// 子供の数を表す．子供の符号はその後に順に並ぶ．
+  static
+  void
+  encode(const Expr& expr,
+	 vector<ymuint32>& code_list);
+
+  /// @brief 符号化した論理式から作る．
+  /// @param[in] code encode() で作った符号列の先頭
+  /// @param[in] ni ファンイン数
+  /// @note 積和形の論理式は頻度の高いリテラルでくくり出して作る．
+  void
+  set(const ymuint32* code,
+      ymuint ni);
+
+  /// @brief 内容をクリアする．
+  void
+  clear();
+
+  /// @brief AND ノード数を返す．
+  ymuint
+  and_num() const;
+
+  /// @brief AigMgr 上に AIG を作る．
+  /// @param[in] aig_mgr AIG マネージャ
+  /// @param[in] fanins ファンインの AIG の配列
+  /// @return 根の AIG を返す．
+  Aig
+  to_aig(AigMgr& aig_mgr,
+	 const vector<Aig>& fanins) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 論理式をそのままの構造で作る．
+  /// @param[inout] code 符号列の現在位置(作った部分の次に進める)
+  ymuint32
+  make_expr(const ymuint32*& code);
+
+  /// @brief 積和形をくくり出しながら作る．
+  /// @param[in] cube_list キューブのリスト(キューブはリテラルのリスト)
+  ymuint32
+  make_factor(const vector<vector<ymuint32> >& cube_list);
+
+  /// @brief リテラルの AND の木を作る．
+  ymuint32
+  make_and_tree(const vector<ymuint32>& lit_list,
+		ymuint begin,
+		ymuint end);
+
+  /// @brief リテラルの XOR の木を作る．
+  ymuint32
+  make_xor_tree(const vector<ymuint32>& lit_list,
+		ymuint begin,
+		ymuint end);
+
+  /// @brief AND ノードを作る．
+  ymuint32
+  make_and(ymuint32 lit0,
+	   ymuint32 lit1);
+
+  /// @brief OR ノードを作る．
+  ymuint32
+  make_or(ymuint32 lit0,
+	  ymuint32 lit1);
+
+  /// @brief XOR ノードを作る．
+  ymuint32
+  make_xor(ymuint32 lit0,
+	   ymuint32 lit1);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ファンイン数
+  ymuint32 mInputNum;
+
+  // AND ノードのファンインのリテラルの配列
+  // ノード i のファンインは mFaninArray[i * 2] と mFaninArray[i * 2 + 1]
+  vector<ymuint32> mFaninArray;
+
+  // 根のリテラル
+  ymuint32 mRoot;
+
+  // 構造ハッシュ
+  unordered_map<ymuint64, ymuint32> mHash;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief AND ノード数を返す．
+inline
+ymuint
+AigFrag::and_num() const
+{
+  return mFaninArray.size() / 2;
+}
+
+END_NAMESPACE_YM
+
+#endif // AIGFRAG_H
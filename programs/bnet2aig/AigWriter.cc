@@ -0,0 +1,230 @@
+﻿
+/// @file AigWriter.cc
+/// @brief AIG をバイナリ AIGER 形式で書き出す関数の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "AigWriter.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 書き出しバッファのサイズ
+const ymuint kBufSize = 1024 * 1024;
+
+//////////////////////////////////////////////////////////////////////
+// バッファ付きの出力
+// ofstream に1バイトずつ書くと遅いので自前のバッファにためて書く．
+//////////////////////////////////////////////////////////////////////
+class AigOutBuf
+{
+public:
+
+  // コンストラクタ
+  AigOutBuf(ofstream& s) :
+    mS(s)
+  {
+    mBuf.reserve(kBufSize);
+  }
+
+  // デストラクタ
+  ~AigOutBuf()
+  {
+    flush();
+  }
+
+
+public:
+
+  // 1バイト書き出す．
+  void
+  put(ymuint8 c)
+  {
+    mBuf.push_back(static_cast<char>(c));
+    if ( mBuf.size() >= kBufSize ) {
+      flush();
+    }
+  }
+
+  // 文字列を書き出す．
+  void
+  put(const string& str)
+  {
+    for (string::const_iterator p = str.begin(); p != str.end(); ++ p) {
+      put(static_cast<ymuint8>(*p));
+    }
+  }
+
+  // 10進数を書き出す．
+  void
+  put_dec(ymuint64 val)
+  {
+    char tmp[24];
+    ymuint n = 0;
+    do {
+      tmp[n] = '0' + (val % 10);
+      ++ n;
+      val /= 10;
+    } while ( val > 0 );
+    for ( ; n > 0; -- n) {
+      put(static_cast<ymuint8>(tmp[n - 1]));
+    }
+  }
+
+  // 7ビットずつの可変長符号で書き出す．
+  void
+  put_delta(ymuint64 val)
+  {
+    while ( val & ~0x7FULL ) {
+      put(static_cast<ymuint8>((val & 0x7F) | 0x80));
+      val >>= 7;
+    }
+    put(static_cast<ymuint8>(val));
+  }
+
+  // バッファの内容を書き出す．
+  void
+  flush()
+  {
+    if ( !mBuf.empty() ) {
+      mS.write(&mBuf[0], mBuf.size());
+      mBuf.clear();
+    }
+  }
+
+
+private:
+
+  // 出力先
+  ofstream& mS;
+
+  // バッファ
+  vector<char> mBuf;
+
+};
+
+// AIGER のリテラル番号を返す．
+ymuint64
+aiger_lit(Aig aig,
+	  const unordered_map<Aig, ymuint64>& var_map)
+{
+  if ( aig.is_zero() ) {
+    return 0;
+  }
+  if ( aig.is_one() ) {
+    return 1;
+  }
+  ymuint64 inv = aig.inv() ? 1 : 0;
+  if ( aig.is_input() ) {
+    return (aig.input_id().val() + 1) * 2 + inv;
+  }
+  Aig node = aig.inv() ? ~aig : aig;
+  unordered_map<Aig, ymuint64>::const_iterator p = var_map.find(node);
+  ASSERT_COND( p != var_map.end() );
+  return p->second * 2 + inv;
+}
+
+END_NONAMESPACE
+
+
+// @brief AIG をバイナリ AIGER 形式で書き出す．
+// @param[in] filename ファイル名
+// @param[in] input_num 入力数
+// @param[in] output_list 出力の AIG のリスト
+// @param[in] node_list aig_sort() で求めた AND ノードのリスト
+// @param[in] input_name_list 入力名のリスト(空の時は書かない)
+// @param[in] output_name_list 出力名のリスト(空の時は書かない)
+// @retval true 成功した．
+// @retval false ファイルが書けなかった．
+bool
+write_aiger(const string& filename,
+	    ymuint input_num,
+	    const vector<Aig>& output_list,
+	    const vector<Aig>& node_list,
+	    const vector<string>& input_name_list,
+	    const vector<string>& output_name_list)
+{
+  ofstream s(filename.c_str(), ios::out | ios::binary);
+  if ( !s ) {
+    cerr << "Could not create " << filename << endl;
+    return false;
+  }
+
+  // AND ノードの変数番号は入力の後に node_list の順でつける．
+  ymuint64 and_num = node_list.size();
+  unordered_map<Aig, ymuint64> var_map;
+  ymuint64 var = input_num + 1;
+  for (vector<Aig>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p, ++ var) {
+    var_map.insert(make_pair(*p, var));
+  }
+
+  {
+    AigOutBuf buf(s);
+
+    // ヘッダ: aig M I L O A
+    buf.put(string("aig "));
+    buf.put_dec(input_num + and_num);
+    buf.put(' ');
+    buf.put_dec(input_num);
+    buf.put(string(" 0 "));
+    buf.put_dec(output_list.size());
+    buf.put(' ');
+    buf.put_dec(and_num);
+    buf.put('\n');
+
+    // 出力は10進数で1行に1つ書く．
+    for (vector<Aig>::const_iterator p = output_list.begin();
+	 p != output_list.end(); ++ p) {
+      buf.put_dec(aiger_lit(*p, var_map));
+      buf.put('\n');
+    }
+
+    // AND ノードは lhs > rhs0 >= rhs1 として差分を書く．
+    var = input_num + 1;
+    for (vector<Aig>::const_iterator p = node_list.begin();
+	 p != node_list.end(); ++ p, ++ var) {
+      Aig node = *p;
+      ymuint64 lhs = var * 2;
+      ymuint64 rhs0 = aiger_lit(node.fanin0(), var_map);
+      ymuint64 rhs1 = aiger_lit(node.fanin1(), var_map);
+      if ( rhs0 < rhs1 ) {
+	ymuint64 tmp = rhs0;
+	rhs0 = rhs1;
+	rhs1 = tmp;
+      }
+      ASSERT_COND( lhs > rhs0 );
+      buf.put_delta(lhs - rhs0);
+      buf.put_delta(rhs0 - rhs1);
+    }
+
+    // シンボルテーブル
+    for (ymuint i = 0; i < input_name_list.size(); ++ i) {
+      buf.put('i');
+      buf.put_dec(i);
+      buf.put(' ');
+      buf.put(input_name_list[i]);
+      buf.put('\n');
+    }
+    for (ymuint i = 0; i < output_name_list.size(); ++ i) {
+      buf.put('o');
+      buf.put_dec(i);
+      buf.put(' ');
+      buf.put(output_name_list[i]);
+      buf.put('\n');
+    }
+  }
+
+  if ( !s ) {
+    cerr << "Error in writing " << filename << endl;
+    return false;
+  }
+  return true;
+}
+
+END_NAMESPACE_YM
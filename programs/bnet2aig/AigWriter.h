@@ -0,0 +1,39 @@
+﻿#ifndef AIGWRITER_H
+#define AIGWRITER_H
+
+/// @file AigWriter.h
+/// @brief AIG をバイナリ AIGER 形式で書き出す関数のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmLogic/Aig.h"
+
+
+BEGIN_NAMESPACE_YM
+
+/// @brief AIG をバイナリ AIGER 形式で書き出す．
+/// @param[in] filename ファイル名
+/// @param[in] input_num 入力数
+/// @param[in] output_list 出力の AIG のリスト
+/// @param[in] node_list aig_sort() で求めた AND ノードのリスト
+/// @param[in] input_name_list 入力名のリスト(空の時は書かない)
+/// @param[in] output_name_list 出力名のリスト(空の時は書かない)
+/// @retval true 成功した．
+/// @retval false ファイルが書けなかった．
+/// @note 入力の AIG の input_id() は 0 から input_num - 1 でなければならない．
+/// @note AND ノードは node_list の順に番号をつけるので，ファンインの
+/// 番号は必ず自分より小さくなる．
+bool
+write_aiger(const string& filename,
+	    ymuint input_num,
+	    const vector<Aig>& output_list,
+	    const vector<Aig>& node_list,
+	    const vector<string>& input_name_list,
+	    const vector<string>& output_name_list);
+
+END_NAMESPACE_YM
+
+#endif // AIGWRITER_H
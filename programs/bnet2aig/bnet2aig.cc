@@ -1,6 +1,6 @@
 ﻿
 /// @file bnet2aig.cc
-/// @brief bnet から aig を作るテスト
+/// @brief bnet から aig を作るプログラム
 /// @author Yusuke Matsunaga (松永 裕介)
 ///
 /// Copyright (C) 2005-2011 Yusuke Matsunaga
@@ -11,21 +11,164 @@
 #include "YmNetworks/BNetBlifReader.h"
 #include "YmLogic/AigMgr.h"
 #include "YmLogic/Aig.h"
+#include "YmLogic/Expr.h"
 
-//#include "aig/AigSatMgr.h"
-//#include "sat/SatSolver.h"
+#include "AigBalance.h"
+#include "AigFrag.h"
+#include "AigWriter.h"
 
-#include "YmUtils/HashMap.h"
 #include "YmUtils/MsgMgr.h"
 #include "YmUtils/MsgHandler.h"
+#include "YmUtils/StopWatch.h"
+
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
 
 
 BEGIN_NAMESPACE_YM
 
-// BNetwork から AIG をつくるコンストラクタ
+BEGIN_NONAMESPACE
+
+// 1つの仕事で AigFrag を作るノード数
+const ymuint kChunkSize = 1024;
+
+// 並列に AigFrag を作るワーカーの共有データ
+struct FragQueue
+{
+  // コンストラクタ
+  FragQueue(const vector<ymuint32>& code_list,
+	    const vector<ymuint>& code_top,
+	    const vector<ymuint32>& fanin_num,
+	    ymuint node_num,
+	    ymuint window) :
+    mCodeList(code_list),
+    mCodeTop(code_top),
+    mFaninNum(fanin_num),
+    mNodeNum(node_num),
+    mChunkNum((node_num + kChunkSize - 1) / kChunkSize),
+    mWindow(window),
+    mFragList(mChunkNum),
+    mDone(mChunkNum, false),
+    mNext(0),
+    mMerged(0)
+  {
+  }
+
+  // 全ノードの論理式の符号列
+  const vector<ymuint32>& mCodeList;
+
+  // ノードごとの mCodeList 中の先頭位置
+  const vector<ymuint>& mCodeTop;
+
+  // ノードごとのファンイン数
+  const vector<ymuint32>& mFaninNum;
+
+  // 論理ノード数
+  ymuint mNodeNum;
+
+  // 仕事の数
+  ymuint mChunkNum;
+
+  // マージ済みの仕事から先に進んでよい仕事の数
+  ymuint mWindow;
+
+  // 仕事ごとの AigFrag のリスト
+  vector<vector<AigFrag> > mFragList;
+
+  // 仕事ごとの終了フラグ
+  vector<bool> mDone;
+
+  // 次に取り出す仕事の番号
+  ymuint mNext;
+
+  // マージ済みの仕事の数
+  ymuint mMerged;
+
+  // 上のデータを守るミューテックス
+  mutex mMutex;
+
+  // mDone と mMerged の変化を知らせる条件変数
+  condition_variable mCond;
+};
+
+// @brief AigFrag を作るワーカーの本体
+// @param[in] queue 共有データ
+// @note 論理式のくくり出しはノードごとに独立なので，ワーカーの間で
+// 共有するのは仕事の番号と終了フラグだけ．
+// また BNode や Expr には触らず，あらかじめ作った符号列だけを読む．
+void
+frag_worker(FragQueue* queue)
+{
+  for ( ; ; ) {
+    ymuint chunk;
+    {
+      unique_lock<mutex> lock(queue->mMutex);
+      if ( queue->mNext >= queue->mChunkNum ) {
+	break;
+      }
+      chunk = queue->mNext;
+      ++ queue->mNext;
+      // マージが追いつくまで待つ．
+      while ( chunk >= queue->mMerged + queue->mWindow ) {
+	queue->mCond.wait(lock);
+      }
+    }
+
+    ymuint begin = chunk * kChunkSize;
+    ymuint end = begin + kChunkSize;
+    if ( end > queue->mNodeNum ) {
+      end = queue->mNodeNum;
+    }
+    vector<AigFrag>& frag_list = queue->mFragList[chunk];
+    frag_list.resize(end - begin);
+    for (ymuint i = begin; i < end; ++ i) {
+      const ymuint32* code = &queue->mCodeList[queue->mCodeTop[i]];
+      frag_list[i - begin].set(code, queue->mFaninNum[i]);
+    }
+
+    {
+      lock_guard<mutex> lock(queue->mMutex);
+      queue->mDone[chunk] = true;
+    }
+    queue->mCond.notify_all();
+  }
+}
+
+// AigFrag を AigMgr 上の AIG にする．
+void
+merge_frag(const AigFrag& frag,
+	   BNode* bnode,
+	   AigMgr& aig_mgr,
+	   vector<Aig>& aig_map,
+	   vector<Aig>& fanins)
+{
+  ymuint ni = bnode->fanin_num();
+  fanins.resize(ni);
+  for (ymuint pos = 0; pos < ni; ++ pos) {
+    fanins[pos] = aig_map[bnode->fanin(pos)->id()];
+  }
+  aig_map[bnode->id()] = frag.to_aig(aig_mgr, fanins);
+}
+
+END_NONAMESPACE
+
+// BNetwork から AIG をつくる．
+// @param[in] network 対象のネットワーク
+// @param[in] aig_mgr AIG マネージャ
+// @param[in] thread_num 論理式のくくり出しを行うスレッド数
+// @param[out] output_list 出力の AIG のリスト
+// @note 論理式のくくり出しは thread_num 個のスレッドで並列に行い，
+// AigMgr へのマージだけをトポロジカル順に1つのスレッドで行う．
 void
 bnet2aig(const BNetwork& network,
-	 AigMgr& aig_mgr)
+	 AigMgr& aig_mgr,
+	 ymuint thread_num,
+	 vector<Aig>& output_list)
 {
   // BNetwork 中のノードと AIG 中のノードの対応を持つ配列
   vector<Aig> aig_map(network.max_node_id());
@@ -41,47 +184,101 @@ bnet2aig(const BNetwork& network,
 
   // 内部ノードを作る．
   // まず入力からのトポロジカル順にソートし buff に入れる．
+  // 論理式の変数 i をファンイン i の AIG に置き換えて作る．
   BNodeVector node_list;
   network.tsort(node_list);
   ymuint nv = network.logic_node_num();
-  for (ymuint i = 0; i < nv; ++ i) {
-    BNode* bnode = node_list[i];
-    ymuint ni = bnode->fanin_num();
-    HashMap<VarId, Aig> input_map;
-    for (ymuint pos = 0; pos < ni; ++ pos) {
-      Aig iaig = aig_map[bnode->fanin(pos)->id()];
-      input_map.add(VarId(pos), iaig);
-      cout << "input_map[" << pos << "] = " << iaig << endl;
-    }
-    cout << "bnode->func() = " << bnode->func() << endl;
-    Aig anode = aig_mgr.make_logic(bnode->func(), input_map);
-    cout << "anode = " << anode << endl;
-    aig_map[bnode->id()] = anode;
+  vector<Aig> fanins;
+  if ( thread_num <= 1 ) {
+    AigFrag frag;
+    vector<ymuint32> code_list;
+    for (ymuint i = 0; i < nv; ++ i) {
+      BNode* bnode = node_list[i];
+      code_list.clear();
+      AigFrag::encode(bnode->func(), code_list);
+      frag.set(&code_list[0], bnode->fanin_num());
+      merge_frag(frag, bnode, aig_mgr, aig_map, fanins);
+    }
+  }
+  else {
+    // Expr の参照回数はスレッドセーフではないので，ワーカーを動かす前に
+    // 全ノードの論理式をこのスレッドで符号列に変換しておく．
+    vector<ymuint32> code_list;
+    vector<ymuint> code_top(nv);
+    vector<ymuint32> fanin_num(nv);
+    for (ymuint i = 0; i < nv; ++ i) {
+      BNode* bnode = node_list[i];
+      code_top[i] = code_list.size();
+      AigFrag::encode(bnode->func(), code_list);
+      fanin_num[i] = bnode->fanin_num();
+    }
+
+    // ワーカーが先に進みすぎてメモリを使い切らないように
+    // マージ済みの仕事からスレッド数の4倍先までに制限する．
+    FragQueue queue(code_list, code_top, fanin_num, nv, thread_num * 4);
+    vector<thread> thread_list;
+    thread_list.reserve(thread_num);
+    for (ymuint i = 0; i < thread_num; ++ i) {
+      thread_list.push_back(thread(frag_worker, &queue));
+    }
+
+    for (ymuint chunk = 0; chunk < queue.mChunkNum; ++ chunk) {
+      {
+	unique_lock<mutex> lock(queue.mMutex);
+	while ( !queue.mDone[chunk] ) {
+	  queue.mCond.wait(lock);
+	}
+      }
+      vector<AigFrag>& frag_list = queue.mFragList[chunk];
+      ymuint begin = chunk * kChunkSize;
+      for (ymuint i = 0; i < frag_list.size(); ++ i) {
+	merge_frag(frag_list[i], node_list[begin + i], aig_mgr,
+		   aig_map, fanins);
+      }
+      vector<AigFrag> tmp;
+      frag_list.swap(tmp);
+      {
+	lock_guard<mutex> lock(queue.mMutex);
+	++ queue.mMerged;
+      }
+      queue.mCond.notify_all();
+    }
+
+    for (ymuint i = 0; i < thread_num; ++ i) {
+      thread_list[i].join();
+    }
   }
 
   // 外部出力を作る．
-  list<Aig> output_handle_list;
-  const BNodeList& output_list = network.outputs();
-  for (BNodeList::const_iterator p = output_list.begin();
-       p != output_list.end(); ++ p) {
+  output_list.clear();
+  output_list.reserve(network.output_num());
+  const BNodeList& bnode_output_list = network.outputs();
+  for (BNodeList::const_iterator p = bnode_output_list.begin();
+       p != bnode_output_list.end(); ++ p) {
     BNode* obnode = *p;
     BNode* ibnode = obnode->fanin(0);
-    Aig ianode = aig_map[ibnode->id()];
-    output_handle_list.push_back(ianode);
+    output_list.push_back(aig_map[ibnode->id()]);
   }
+}
+
+END_NAMESPACE_YM
+
 
-  aig_mgr.print_handles(cout, output_handle_list);
+BEGIN_NONAMESPACE
+
+void
+usage(const char* argv0)
+{
+  using namespace std;
 
-#if 0
-  SatSolver* solver = SatSolverFactory::gen_solver();
-  AigSatMgr aigsat(aig_mgr, *solver);
-  Aig root = output_handle_list.front();
-  vector<Bool3> model;
-  Bool3 stat = aigsat.sat(root, model);
-#endif
+  cerr << "USAGE : " << argv0 << " [options] blif-file" << endl
+       << "  -o, --output <file>   write binary AIGER to file" << endl
+       << "  --no-balance          do not balance the AIG" << endl
+       << "  --no-symbols          do not write the symbol table" << endl
+       << "  -t, --threads <n>     factor node functions on n threads" << endl;
 }
 
-END_NAMESPACE_YM
+END_NONAMESPACE
 
 
 int
@@ -91,26 +288,122 @@ main(int argc,
   using namespace std;
   using namespace nsYm;
 
-  if ( argc != 2 ) {
-    cerr << "USAGE : " << argv[0] << " blif-file" << endl;
+  const char* filename = NULL;
+  const char* out_filename = NULL;
+  bool balance = true;
+  bool symbols = true;
+  ymuint thread_num = 1;
+  for (int i = 1; i < argc; ++ i) {
+    const char* arg = argv[i];
+    // 引数をとるオプション
+    bool has_arg = i + 1 < argc;
+    if ( (strcmp(arg, "-o") == 0 || strcmp(arg, "--output") == 0) && has_arg ) {
+      out_filename = argv[++ i];
+    }
+    else if ( strcmp(arg, "--no-balance") == 0 ) {
+      balance = false;
+    }
+    else if ( strcmp(arg, "--no-symbols") == 0 ) {
+      symbols = false;
+    }
+    else if ( (strcmp(arg, "-t") == 0 || strcmp(arg, "--threads") == 0) && has_arg ) {
+      const char* num_str = argv[++ i];
+      char* end;
+      errno = 0;
+      long val = strtol(num_str, &end, 10);
+      if ( errno != 0 || end == num_str || *end != '\0' ||
+	   val <= 0 || val > INT_MAX ) {
+	cerr << arg << ": positive integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      thread_num = val;
+    }
+    else if ( arg[0] == '-' || filename != NULL ) {
+      usage(argv[0]);
+      return 2;
+    }
+    else {
+      filename = arg;
+    }
+  }
+  if ( filename == NULL ) {
+    usage(argv[0]);
     return 2;
   }
 
-  string filename = argv[1];
-
   try {
     MsgHandler* msg_handler = new StreamMsgHandler(&cerr);
     MsgMgr::reg_handler(msg_handler);
 
+    StopWatch sw;
+    sw.start();
     BNetwork network;
     BNetBlifReader read;
     if ( !read(filename, network) ) {
       cerr << "Error in reading " << filename << endl;
       return 4;
     }
+    sw.stop();
+    USTime read_time = sw.time();
 
+    sw.reset();
+    sw.start();
     AigMgr aig_mgr;
-    bnet2aig(network, aig_mgr);
+    vector<Aig> output_list;
+    bnet2aig(network, aig_mgr, thread_num, output_list);
+    vector<Aig> node_list;
+    aig_sort(output_list, node_list);
+    sw.stop();
+    USTime conv_time = sw.time();
+
+    cout << "Inputs:           \t" << network.input_num() << endl
+	 << "Outputs:          \t" << network.output_num() << endl
+	 << "Logic nodes:      \t" << network.logic_node_num() << endl
+	 << "AND nodes:        \t" << node_list.size() << endl
+	 << "Levels:           \t" << aig_depth(output_list, node_list) << endl;
+
+    if ( balance ) {
+      sw.reset();
+      sw.start();
+      vector<Aig> new_output_list;
+      aig_balance(aig_mgr, output_list, node_list, new_output_list);
+      output_list.swap(new_output_list);
+      aig_sort(output_list, node_list);
+      sw.stop();
+
+      cout << "Balanced AND nodes:\t" << node_list.size() << endl
+	   << "Balanced levels:  \t" << aig_depth(output_list, node_list) << endl;
+      cout << "Balance time:     \t" << sw.time() << endl;
+    }
+
+    cout << "Read time:        \t" << read_time << endl
+	 << "Convert time:     \t" << conv_time << endl;
+
+    if ( out_filename != NULL ) {
+      vector<string> input_name_list;
+      vector<string> output_name_list;
+      if ( symbols ) {
+	for (BNodeList::const_iterator p = network.inputs_begin();
+	     p != network.inputs_end(); ++ p) {
+	  input_name_list.push_back((*p)->name());
+	}
+	const BNodeList& bnode_output_list = network.outputs();
+	for (BNodeList::const_iterator p = bnode_output_list.begin();
+	     p != bnode_output_list.end(); ++ p) {
+	  output_name_list.push_back((*p)->name());
+	}
+      }
+
+      sw.reset();
+      sw.start();
+      if ( !write_aiger(out_filename, network.input_num(), output_list,
+			node_list, input_name_list, output_name_list) ) {
+	return 1;
+      }
+      sw.stop();
+      cout << "Write time:       \t" << sw.time() << endl;
+    }
   }
   catch ( AssertError x) {
     cout << x << endl;
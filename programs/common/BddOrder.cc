@@ -0,0 +1,428 @@
+﻿
+/// @file BddOrder.cc
+/// @brief makebdd と lsim の変数順を求める関数の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "BddOrder.h"
+#include "YmNetworks/BdnNode.h"
+#include "YmNetworks/BdnPort.h"
+#include "YmLogic/Bdd.h"
+#include "YmLogic/BddMgr.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 未定義の値
+const ymuint32 kNone = 0xFFFFFFFFU;
+
+// sifting で1つの変数を動かす時に，ノード数が最良の時の何倍を
+// 超えたらその方向に動かすのをやめるか
+const double kMaxGrowth = 1.2;
+
+// 1回の sift_order() で BDD を作り直す回数の上限
+const ymuint kMaxBuildNum = 2000;
+
+// @brief node_list の先頭の BDD を作って生きているノード数を求める．
+// @param[in] network 対象のネットワーク
+// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+// @param[in] prefix_num node_list の先頭から何個までを作るか
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @param[in] limit 生きているノード数の上限(0 の時は制限なし)
+// @param[out] live prefix_num 個作った時点で生きているノード数
+// @retval true 最後まで作った．
+// @retval false 途中で limit を超えたので中断した．
+// @note makebdd() と同じく全てのファンアウトを作り終えた BDD は解放する．
+bool
+calc_live(const BdnMgr& network,
+	  const vector<const BdnNode*>& node_list,
+	  ymuint prefix_num,
+	  const vector<ymuint32>& input_var,
+	  ymuint64 limit,
+	  ymuint64& live)
+{
+  ymuint n = network.max_node_id();
+
+  vector<ymuint> ref_count(n, 0);
+  for (vector<const BdnNode*>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    ++ ref_count[node->fanin0()->id()];
+    ++ ref_count[node->fanin1()->id()];
+  }
+  const BdnNodeList& output_list = network.output_list();
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = (*p)->output_fanin();
+    if ( node != NULL ) {
+      ++ ref_count[node->id()];
+    }
+  }
+
+  // 変数順ごとに新しい BddMgr を用いる．
+  BddMgr mgr("bmc", "Bdd Manager");
+  ymuint64 base = mgr.node_num();
+
+  vector<Bdd> bddmap(n);
+  ymuint i = 0;
+  const BdnNodeList& input_list = network.input_list();
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    bddmap[node->id()] = mgr.make_posiliteral(VarId(input_var[i]));
+  }
+
+  live = 0;
+  for (ymuint k = 0; k < prefix_num; ++ k) {
+    const BdnNode* node = node_list[k];
+    const BdnNode* fanin0 = node->fanin0();
+    const BdnNode* fanin1 = node->fanin1();
+    Bdd bdd0 = bddmap[fanin0->id()];
+    if ( node->fanin0_inv() ) {
+      bdd0 = ~bdd0;
+    }
+    Bdd bdd1 = bddmap[fanin1->id()];
+    if ( node->fanin1_inv() ) {
+      bdd1 = ~bdd1;
+    }
+    if ( node->is_xor() ) {
+      bddmap[node->id()] = bdd0 ^ bdd1;
+    }
+    else {
+      bddmap[node->id()] = bdd0 & bdd1;
+    }
+    bdd0 = Bdd();
+    bdd1 = Bdd();
+    if ( -- ref_count[fanin0->id()] == 0 ) {
+      bddmap[fanin0->id()] = Bdd();
+    }
+    if ( -- ref_count[fanin1->id()] == 0 ) {
+      bddmap[fanin1->id()] = Bdd();
+    }
+
+    live = mgr.node_num() - mgr.garbage_num() - base;
+    if ( limit > 0 && live > limit ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// 深さの大きい順に並べるための比較関数
+struct DepthGt
+{
+  bool
+  operator()(const BdnNode* left,
+	     const BdnNode* right) const
+  {
+    return left->level() > right->level();
+  }
+};
+
+END_NONAMESPACE
+
+
+// @brief ネットワークの構造から静的に変数順を求める．
+// @param[in] network 対象のネットワーク
+// @param[in] method 手法名
+// @param[out] input_var 入力番号から変数番号を得る配列
+// @retval true 成功した．
+// @retval false method が未知の手法だった．
+bool
+static_order(const BdnMgr& network,
+	     const string& method,
+	     vector<ymuint32>& input_var)
+{
+  bool depth_first;
+  if ( method == "dfs" ) {
+    depth_first = false;
+  }
+  else if ( method == "depth" ) {
+    depth_first = true;
+  }
+  else {
+    return false;
+  }
+
+  ymuint n = network.max_node_id();
+
+  // BdnNode の ID 番号から入力番号を得る配列
+  vector<ymuint32> input_pos(n, kNone);
+  const BdnNodeList& input_list = network.input_list();
+  ymuint ni = input_list.size();
+  ymuint i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    input_pos[node->id()] = i;
+  }
+
+  // 出力から順にたどる．
+  vector<const BdnNode*> root_list;
+  const BdnNodeList& output_list = network.output_list();
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    if ( inode != NULL ) {
+      root_list.push_back(inode);
+    }
+  }
+  if ( depth_first ) {
+    stable_sort(root_list.begin(), root_list.end(), DepthGt());
+  }
+
+  input_var.clear();
+  input_var.resize(ni, kNone);
+  ymuint32 next_var = 0;
+  vector<bool> mark(n, false);
+  vector<const BdnNode*> stack;
+  for (vector<const BdnNode*>::iterator p = root_list.begin();
+       p != root_list.end(); ++ p) {
+    // 再帰呼び出しの代わりにスタックを用いる．
+    stack.push_back(*p);
+    while ( !stack.empty() ) {
+      const BdnNode* node = stack.back();
+      stack.pop_back();
+      if ( mark[node->id()] ) {
+	continue;
+      }
+      mark[node->id()] = true;
+      if ( node->is_input() ) {
+	input_var[input_pos[node->id()]] = next_var;
+	++ next_var;
+	continue;
+      }
+      // 先にたどるファンインを後に積む．
+      const BdnNode* first = node->fanin0();
+      const BdnNode* second = node->fanin1();
+      if ( depth_first && first->level() < second->level() ) {
+	std::swap(first, second);
+      }
+      stack.push_back(second);
+      stack.push_back(first);
+    }
+  }
+
+  // どの出力からも到達しない入力は最後に並べる．
+  for (ymuint i = 0; i < ni; ++ i) {
+    if ( input_var[i] == kNone ) {
+      input_var[i] = next_var;
+      ++ next_var;
+    }
+  }
+
+  return true;
+}
+
+// @brief 変数順をファイルから読み込む．
+// @param[in] filename ファイル名
+// @param[in] network 対象のネットワーク
+// @param[out] input_var 入力番号から変数番号を得る配列
+// @retval true 成功した．
+// @retval false ファイルが読めないか入力名が一致しなかった．
+bool
+read_order(const char* filename,
+	   const BdnMgr& network,
+	   vector<ymuint32>& input_var)
+{
+  ifstream fs;
+  fs.open(filename);
+  if ( !fs ) {
+    cerr << "Could not open " << filename << endl;
+    return false;
+  }
+
+  unordered_map<string, ymuint32> var_map;
+  ymuint32 var = 0;
+  string name;
+  while ( fs >> name ) {
+    var_map.insert(make_pair(name, var));
+    ++ var;
+  }
+
+  const BdnNodeList& input_list = network.input_list();
+  ymuint ni = input_list.size();
+  input_var.clear();
+  input_var.resize(ni);
+  vector<bool> used(ni, false);
+  ymuint i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    string name = node->port()->name();
+    unordered_map<string, ymuint32>::iterator q = var_map.find(name);
+    if ( q == var_map.end() || q->second >= ni || used[q->second] ) {
+      cerr << filename << ": no valid order for " << name << endl;
+      return false;
+    }
+    input_var[i] = q->second;
+    used[q->second] = true;
+  }
+
+  return true;
+}
+
+// @brief 変数順をファイルに書き出す．
+// @param[in] filename ファイル名
+// @param[in] network 対象のネットワーク
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @retval true 成功した．
+// @retval false ファイルが書けなかった．
+bool
+write_order(const char* filename,
+	    const BdnMgr& network,
+	    const vector<ymuint32>& input_var)
+{
+  ofstream fs;
+  fs.open(filename);
+  if ( !fs ) {
+    cerr << "Could not create " << filename << endl;
+    return false;
+  }
+
+  const BdnNodeList& input_list = network.input_list();
+  vector<string> name_list(input_list.size());
+  ymuint i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    ASSERT_COND( input_var[i] < name_list.size() );
+    name_list[input_var[i]] = node->port()->name();
+  }
+  for (vector<string>::iterator p = name_list.begin();
+       p != name_list.end(); ++ p) {
+    fs << *p << endl;
+  }
+
+  return true;
+}
+
+// @brief 変数順に対する生きている BDD のノード数を求める．
+// @param[in] network 対象のネットワーク
+// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+// @param[in] prefix_num node_list の先頭から何個までを作るか
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @return prefix_num 個作った時点で生きているノード数を返す．
+ymuint64
+bdd_live_num(const BdnMgr& network,
+	     const vector<const BdnNode*>& node_list,
+	     ymuint prefix_num,
+	     const vector<ymuint32>& input_var)
+{
+  ymuint64 live;
+  calc_live(network, node_list, prefix_num, input_var, 0, live);
+  return live;
+}
+
+// @brief sifting で変数順を改善する．
+// @param[in] network 対象のネットワーク
+// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+// @param[in] prefix_num node_list の先頭から何個までを作るか
+// @param[inout] input_var 入力番号から変数番号を得る配列
+// @param[in] window 1つの変数を動かす範囲(0 の時は全範囲)
+// @param[in] max_pass 全変数を動かす処理を繰り返す最大回数
+// @return 最良の変数順の時の生きている BDD のノード数を返す．
+// @note 変数は今の位置から上下それぞれの方向に1つずつ動かし，
+// ノード数が最良の時の kMaxGrowth 倍を超えたらその方向はやめる．
+// 途中のノード数が最良の時の2倍を超えた時も作るのを中断して
+// その方向はやめる．
+// @note 作り直す回数が全体で kMaxBuildNum を超えたらそこで終わる．
+ymuint64
+sift_order(const BdnMgr& network,
+	   const vector<const BdnNode*>& node_list,
+	   ymuint prefix_num,
+	   vector<ymuint32>& input_var,
+	   ymuint window,
+	   ymuint max_pass)
+{
+  ymuint ni = input_var.size();
+
+  // 変数番号の順に並べた入力番号のリスト
+  vector<ymuint32> var_list(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    ASSERT_COND( input_var[i] < ni );
+    var_list[input_var[i]] = i;
+  }
+
+  ymuint64 best_live;
+  calc_live(network, node_list, prefix_num, input_var, 0, best_live);
+  cout << "Sifting:          \tinitial live nodes = " << best_live << endl;
+
+  ymuint nbuild = 0;
+  for (ymuint pass = 0; pass < max_pass; ++ pass) {
+    ymuint64 old_live = best_live;
+
+    // 入力順に1つずつ動かす．
+    for (ymuint i = 0; i < ni; ++ i) {
+      ymuint cur_pos = input_var[i];
+      ymuint lo = 0;
+      ymuint hi = ni - 1;
+      if ( window > 0 ) {
+	if ( cur_pos > window ) {
+	  lo = cur_pos - window;
+	}
+	if ( cur_pos + window < hi ) {
+	  hi = cur_pos + window;
+	}
+      }
+
+      // 上下の順に動かす．
+      ymuint best_pos = cur_pos;
+      for (int dir = -1; dir <= 1; dir += 2) {
+	for (ymuint pos = cur_pos; ; ) {
+	  if ( (dir < 0 ? pos == lo : pos == hi) || nbuild >= kMaxBuildNum ) {
+	    break;
+	  }
+	  pos += dir;
+	  ++ nbuild;
+
+	  // var_list から i を取り除いて pos に入れる．
+	  vector<ymuint32> var_list1(var_list);
+	  var_list1.erase(var_list1.begin() + cur_pos);
+	  var_list1.insert(var_list1.begin() + pos, i);
+	  vector<ymuint32> input_var1(ni);
+	  for (ymuint v = 0; v < ni; ++ v) {
+	    input_var1[var_list1[v]] = v;
+	  }
+
+	  ymuint64 live;
+	  if ( !calc_live(network, node_list, prefix_num, input_var1,
+			  best_live * 2 + 1000, live) ||
+	       live > best_live * kMaxGrowth ) {
+	    break;
+	  }
+	  if ( live < best_live ) {
+	    best_live = live;
+	    best_pos = pos;
+	  }
+	}
+      }
+
+      if ( best_pos != cur_pos ) {
+	var_list.erase(var_list.begin() + cur_pos);
+	var_list.insert(var_list.begin() + best_pos, i);
+	for (ymuint v = 0; v < ni; ++ v) {
+	  input_var[var_list[v]] = v;
+	}
+      }
+    }
+
+    cout << "Sifting:          \tpass " << (pass + 1)
+	 << ", live nodes = " << best_live << endl;
+    if ( best_live >= old_live || nbuild >= kMaxBuildNum ) {
+      break;
+    }
+  }
+
+  return best_live;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,94 @@
+﻿#ifndef BDDORDER_H
+#define BDDORDER_H
+
+/// @file BddOrder.h
+/// @brief makebdd と lsim の変数順を求める関数のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+///
+/// 変数順は入力番号から変数番号を得る配列(input_var)の形で表す．
+
+
+#include "YmNetworks/BdnMgr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+/// @brief ネットワークの構造から静的に変数順を求める．
+/// @param[in] network 対象のネットワーク
+/// @param[in] method 手法名
+/// @param[out] input_var 入力番号から変数番号を得る配列
+/// @retval true 成功した．
+/// @retval false method が未知の手法だった．
+/// @note method は以下のいずれか
+///  - "dfs"   出力から深さ優先でたどり，現れた順に入力を並べる．
+///  - "depth" 深い出力から順に，深いファンインを先にたどる．
+bool
+static_order(const BdnMgr& network,
+	     const string& method,
+	     vector<ymuint32>& input_var);
+
+/// @brief 変数順をファイルから読み込む．
+/// @param[in] filename ファイル名
+/// @param[in] network 対象のネットワーク
+/// @param[out] input_var 入力番号から変数番号を得る配列
+/// @retval true 成功した．
+/// @retval false ファイルが読めないか入力名が一致しなかった．
+/// @note ファイルは lsim の read_order() と同じく変数順に入力名を並べたもの
+bool
+read_order(const char* filename,
+	   const BdnMgr& network,
+	   vector<ymuint32>& input_var);
+
+/// @brief 変数順をファイルに書き出す．
+/// @param[in] filename ファイル名
+/// @param[in] network 対象のネットワーク
+/// @param[in] input_var 入力番号から変数番号を得る配列
+/// @retval true 成功した．
+/// @retval false ファイルが書けなかった．
+bool
+write_order(const char* filename,
+	    const BdnMgr& network,
+	    const vector<ymuint32>& input_var);
+
+/// @brief sifting で変数順を改善する．
+/// @param[in] network 対象のネットワーク
+/// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+/// @param[in] prefix_num node_list の先頭から何個までを作るか
+/// @param[inout] input_var 入力番号から変数番号を得る配列
+/// @param[in] window 1つの変数を動かす範囲(0 の時は全範囲)
+/// @param[in] max_pass 全変数を動かす処理を繰り返す最大回数
+/// @return 最良の変数順の時の生きている BDD のノード数を返す．
+/// @note BddMgr は動的な変数順の変更ができないので，変数順を変える
+/// たびに node_list の先頭の prefix_num 個の BDD を作り直して，
+/// その時点で生きているノード数を比べる．
+/// @note 作り直す回数を抑えるため，1つの変数を動かす方向ごとに
+/// ノード数が増えすぎたらそれより先の位置は試さない．
+/// また作り直す回数の合計にも上限を設ける．
+ymuint64
+sift_order(const BdnMgr& network,
+	   const vector<const BdnNode*>& node_list,
+	   ymuint prefix_num,
+	   vector<ymuint32>& input_var,
+	   ymuint window,
+	   ymuint max_pass);
+
+/// @brief 変数順に対する生きている BDD のノード数を求める．
+/// @param[in] network 対象のネットワーク
+/// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+/// @param[in] prefix_num node_list の先頭から何個までを作るか
+/// @param[in] input_var 入力番号から変数番号を得る配列
+/// @return prefix_num 個作った時点で生きているノード数を返す．
+/// @note prefix_num が node_list の要素数の時は全出力の BDD の
+/// ノード数になる．
+ymuint64
+bdd_live_num(const BdnMgr& network,
+	     const vector<const BdnNode*>& node_list,
+	     ymuint prefix_num,
+	     const vector<ymuint32>& input_var);
+
+END_NAMESPACE_YM
+
+#endif // BDDORDER_H
@@ -0,0 +1,239 @@
+﻿
+/// @file Lsim.cc
+/// @brief Lsim の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Lsim.h"
+#include "LsimImage.h"
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+#include <thread>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// コア数が分からない時のスレッド数の上限
+const ymuint kMaxThreadNum = 16;
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス Lsim
+//////////////////////////////////////////////////////////////////////
+
+// @brief 評価に用いるノード数を返す．
+// @note ノードの意味(論理ノード，BDD ノード，LUT など)は実装ごとに異なる．
+// @note デフォルトの実装は 0 を返す．
+ymuint
+Lsim::node_num() const
+{
+  return 0;
+}
+
+// @brief 複数ワード分の論理シミュレーションをまとめて行う．
+// @param[in] iv_list 入力ベクタのリスト
+// @param[out] ov_list 出力ベクタのリスト
+// @param[in] thread_num スレッド数
+// @note iv_list[i] に対する結果が ov_list[i] に入る．
+// @note eval_mt() を実装していないクラスでは1スレッドで eval() を呼ぶ．
+// @note スレッド数はワード数とコア数で抑えられる．
+void
+Lsim::eval_batch(const vector<vector<ymuint64> >& iv_list,
+		 vector<vector<ymuint64> >& ov_list,
+		 ymuint thread_num)
+{
+  ymuint nw = iv_list.size();
+  ASSERT_COND( ov_list.size() == nw );
+
+  if ( !has_eval_mt() ) {
+    for (ymuint i = 0; i < nw; ++ i) {
+      eval(iv_list[i], ov_list[i]);
+    }
+    return;
+  }
+
+  if ( thread_num == 0 ) {
+    thread_num = 1;
+  }
+  // コア数を超えてスレッドを作っても速くならない．
+  // hardware_concurrency() が分からない(0 の)時は kMaxThreadNum で抑える．
+  ymuint max_thread = std::thread::hardware_concurrency();
+  if ( max_thread == 0 ) {
+    max_thread = kMaxThreadNum;
+  }
+  if ( thread_num > max_thread ) {
+    thread_num = max_thread;
+  }
+  if ( thread_num > nw ) {
+    thread_num = nw;
+  }
+  if ( thread_num <= 1 ) {
+    eval_worker(&iv_list, &ov_list, 0, nw);
+    return;
+  }
+
+  // ワードを連続した範囲ごとに各スレッドに割り当てる．
+  // 担当範囲が重ならないので ov_list への書き込みは排他制御不要
+  ymuint chunk = (nw + thread_num - 1) / thread_num;
+  vector<std::thread> thread_list;
+  thread_list.reserve(thread_num);
+  for (ymuint start = 0; start < nw; start += chunk) {
+    ymuint end = start + chunk;
+    if ( end > nw ) {
+      end = nw;
+    }
+    thread_list.push_back(std::thread(&Lsim::eval_worker, this,
+				      &iv_list, &ov_list, start, end));
+  }
+  for (vector<std::thread>::iterator p = thread_list.begin();
+       p != thread_list.end(); ++ p) {
+    p->join();
+  }
+}
+
+// @brief イメージファイルを用いてネットワークをセットする．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+// @param[in] cache_dir イメージファイルを置くディレクトリ
+// @note cache_dir に同じネットワークのイメージファイルがあれば
+// それを読み込み，なければ set_network() を行ってから書き出す．
+// @note image_name() が NULL のクラスでは set_network() を呼ぶだけ
+void
+Lsim::set_network_cached(const BdnMgr& bdn,
+			 const unordered_map<string, ymuint>& order_map,
+			 const string& cache_dir)
+{
+  const char* name = image_name();
+  if ( name == NULL || cache_dir == string() ) {
+    set_network(bdn, order_map);
+    return;
+  }
+
+  // ファイル名はシグネチャから作る．
+  ymuint64 signature = network_signature(bdn, order_map);
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx",
+	   static_cast<unsigned long long>(signature));
+  string filename = cache_dir + "/" + name + "_" + buf + ".img";
+
+  {
+    LsimImageReader reader;
+    if ( reader.open(filename, name, image_version()) &&
+	 reader.signature() == signature &&
+	 read_image(reader) ) {
+      cout << "Image cache:      \thit (" << filename << ")" << endl;
+      return;
+    }
+  }
+
+  cout << "Image cache:      \tmiss (" << filename << ")" << endl;
+  set_network(bdn, order_map);
+
+  // 書き出しに失敗してもシミュレーションは続けられる．
+  if ( mkdir(cache_dir.c_str(), 0755) != 0 && errno != EEXIST ) {
+    cerr << "Could not create " << cache_dir << endl;
+    return;
+  }
+  LsimImageWriter writer;
+  if ( !writer.open(filename, name, image_version(), signature) ) {
+    cerr << "Could not create " << filename << endl;
+    return;
+  }
+  write_image(writer);
+  if ( !writer.close() ) {
+    cerr << "Could not write " << filename << endl;
+  }
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+// @note イメージファイルに対応していない時は NULL を返す．
+// @note デフォルトの実装は NULL を返す．
+const char*
+Lsim::image_name() const
+{
+  return NULL;
+}
+
+// @brief イメージファイルの形式のバージョンを返す．
+// @note デフォルトの実装は 0 を返す．
+ymuint32
+Lsim::image_version() const
+{
+  return 0;
+}
+
+// @brief set_network() で作った内容をイメージファイルに書き出す．
+// @param[in] writer 書き出し用のオブジェクト
+void
+Lsim::write_image(LsimImageWriter& writer) const
+{
+  // image_name() が NULL の時には呼ばれないはず
+  ASSERT_NOT_REACHED;
+}
+
+// @brief イメージファイルの内容を読み込む．
+// @param[in] reader 読み込み用のオブジェクト
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+bool
+Lsim::read_image(LsimImageReader& reader)
+{
+  return false;
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+// @note デフォルトの実装は false を返す．
+bool
+Lsim::has_eval_mt() const
+{
+  return false;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+// @note デフォルトの実装は 0 を返す．
+ymuint
+Lsim::work_size() const
+{
+  return 0;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(サイズは work_size())
+void
+Lsim::eval_mt(const vector<ymuint64>& iv,
+	      vector<ymuint64>& ov,
+	      vector<ymuint64>& work) const
+{
+  // has_eval_mt() が false の時には呼ばれないはず
+  ASSERT_NOT_REACHED;
+}
+
+// @brief eval_batch() のワーカースレッドの本体
+// @param[in] iv_list 入力ベクタのリスト
+// @param[out] ov_list 出力ベクタのリスト
+// @param[in] start 担当する範囲の先頭
+// @param[in] end 担当する範囲の末尾の次
+void
+Lsim::eval_worker(const vector<vector<ymuint64> >* iv_list,
+		  vector<vector<ymuint64> >* ov_list,
+		  ymuint start,
+		  ymuint end) const
+{
+  // 作業領域はスレッドごとに持つ．
+  vector<ymuint64> work(work_size());
+  for (ymuint i = start; i < end; ++ i) {
+    eval_mt((*iv_list)[i], (*ov_list)[i], work);
+  }
+}
+
+END_NAMESPACE_YM
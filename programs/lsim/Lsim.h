@@ -14,6 +14,9 @@
 
 BEGIN_NAMESPACE_YM
 
+class LsimImageWriter;
+class LsimImageReader;
+
 //////////////////////////////////////////////////////////////////////
 /// @class Lsim Lsim.h "Lsim.h"
 /// @brief 論理シミュレータの基底クラス
@@ -48,6 +51,130 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov) = 0;
 
+  /// @brief 評価に用いるノード数を返す．
+  /// @note ノードの意味(論理ノード，BDD ノード，LUT など)は実装ごとに異なる．
+  /// @note デフォルトの実装は 0 を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 複数ワードの評価を行う関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 複数ワード分の論理シミュレーションをまとめて行う．
+  /// @param[in] iv_list 入力ベクタのリスト
+  /// @param[out] ov_list 出力ベクタのリスト
+  /// @param[in] thread_num スレッド数
+  /// @note iv_list[i] に対する結果が ov_list[i] に入る．
+  /// @note eval_mt() を実装していないクラスでは1スレッドで eval() を呼ぶ．
+  /// @note スレッド数はワード数とコア数で抑えられる．
+  void
+  eval_batch(const vector<vector<ymuint64> >& iv_list,
+	     vector<vector<ymuint64> >& ov_list,
+	     ymuint thread_num);
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイルを用いる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルを用いてネットワークをセットする．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] order_map 順序マップ
+  /// @param[in] cache_dir イメージファイルを置くディレクトリ
+  /// @note cache_dir に同じネットワークのイメージファイルがあれば
+  /// それを読み込み，なければ set_network() を行ってから書き出す．
+  /// @note image_name() が NULL のクラスでは set_network() を呼ぶだけ
+  void
+  set_network_cached(const BdnMgr& bdn,
+		     const unordered_map<string, ymuint>& order_map,
+		     const string& cache_dir);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイル用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルに記録する手法名を返す．
+  /// @note イメージファイルに対応していない時は NULL を返す．
+  /// @note デフォルトの実装は NULL を返す．
+  virtual
+  const char*
+  image_name() const;
+
+  /// @brief イメージファイルの形式のバージョンを返す．
+  /// @note 書き出す内容を変えた時には値を変えること．
+  /// @note デフォルトの実装は 0 を返す．
+  virtual
+  ymuint32
+  image_version() const;
+
+  /// @brief set_network() で作った内容をイメージファイルに書き出す．
+  /// @param[in] writer 書き出し用のオブジェクト
+  virtual
+  void
+  write_image(LsimImageWriter& writer) const;
+
+  /// @brief イメージファイルの内容を読み込む．
+  /// @param[in] reader 読み込み用のオブジェクト
+  /// @retval true 読み込みが成功した．
+  /// @retval false 読み込みが失敗した．
+  virtual
+  bool
+  read_image(LsimImageReader& reader);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  /// @note デフォルトの実装は false を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief eval_mt() で用いる作業領域のサイズを返す．
+  /// @note デフォルトの実装は 0 を返す．
+  virtual
+  ymuint
+  work_size() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(サイズは work_size())
+  /// @note ネットワークの構造は読み出すだけなので，異なる作業領域を
+  /// 用いれば複数のスレッドから同時に呼び出してもよい．
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_batch() のワーカースレッドの本体
+  /// @param[in] iv_list 入力ベクタのリスト
+  /// @param[out] ov_list 出力ベクタのリスト
+  /// @param[in] start 担当する範囲の先頭
+  /// @param[in] end 担当する範囲の末尾の次
+  void
+  eval_worker(const vector<vector<ymuint64> >* iv_list,
+	      vector<vector<ymuint64> >* ov_list,
+	      ymuint start,
+	      ymuint end) const;
+
 };
 
 END_NAMESPACE_YM
@@ -41,6 +41,14 @@ LsimBdd::set_network(const BdnMgr& bdn,
   vector<Bdd> bddmap(n);
 
   const BdnNodeList& input_list = bdn.input_list();
+  ymuint ni = input_list.size();
+  // 変数番号から入力番号を得る配列
+  // 順序マップがない時は変数番号と入力番号は等しい．
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[i] = i;
+  }
   if ( order_map.empty() ) {
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
@@ -52,8 +60,9 @@ LsimBdd::set_network(const BdnMgr& bdn,
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -62,6 +71,8 @@ LsimBdd::set_network(const BdnMgr& bdn,
 	abort();
       }
       ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      mVarInput[id] = i;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
       bddmap[node->id()] = bdd;
     }
@@ -132,9 +143,10 @@ BEGIN_NONAMESPACE
 
 ymuint64
 eval_bdd(Bdd bdd0,
-	 const vector<ymuint64>& iv)
+	 const vector<ymuint64>& iv,
+	 const vector<ymuint32>& var_input)
 {
-  ymuint val = 0U;
+  ymuint64 val = 0UL;
   for (ymuint b = 0; b < 64; ++ b) {
     Bdd bdd = bdd0;
     ymuint64 bit = 1UL << b;
@@ -149,7 +161,7 @@ eval_bdd(Bdd bdd0,
       Bdd bdd0;
       Bdd bdd1;
       VarId id = bdd.root_decomp(bdd0, bdd1);
-      ymuint64 ival = iv[id.val()];
+      ymuint64 ival = iv[var_input[id.val()]];
       if ( ival & bit ) {
 	bdd = bdd1;
       }
@@ -174,8 +186,15 @@ LsimBdd::eval(const vector<ymuint64>& iv,
   ymuint no = ov.size();
   for (ymuint i = 0; i < no; ++ i) {
     Bdd bdd = mOutputList[i];
-    ov[i] = eval_bdd(bdd, iv);
+    ov[i] = eval_bdd(bdd, iv, mVarInput);
   }
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimBdd::node_num() const
+{
+  return mOutputList.node_count();
+}
+
 END_NAMESPACE_YM
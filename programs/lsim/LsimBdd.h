@@ -55,6 +55,11 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov);
 
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -67,6 +72,9 @@ private:
   // 出力のBDDの配列
   BddVector mOutputList;
 
+  // 変数番号から入力番号を得る配列
+  vector<ymuint32> mVarInput;
+
 };
 
 END_NAMESPACE_YM
@@ -68,6 +68,14 @@ LsimBdd1::set_network(const BdnMgr& bdn,
 
   const BdnNodeList& input_list = bdn.input_list();
 
+  ymuint ni = input_list.size();
+  // 変数番号から入力番号を得る配列
+  // 順序マップがない時は変数番号と入力番号は等しい．
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[i] = i;
+  }
   if ( order_map.empty() ) {
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
@@ -79,8 +87,9 @@ LsimBdd1::set_network(const BdnMgr& bdn,
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -89,6 +98,8 @@ LsimBdd1::set_network(const BdnMgr& bdn,
 	abort();
       }
       ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      mVarInput[id] = i;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
       bddmap[node->id()] = bdd;
     }
@@ -191,7 +202,8 @@ LsimBdd1::make_node(Bdd bdd,
   mNodeList.push_back(Bdd1Node(varid0, varid1, node00, node01, node10, node11));
   ympuint ptr = encode(&mNodeList.back(), false);
 #else
-  Bdd1Node* node = new Bdd1Node(varid0, node0, node1);
+  // 評価時に入力ベクタを直接引けるように入力番号を入れる．
+  Bdd1Node* node = new Bdd1Node(VarId(mVarInput[varid0.val()]), node0, node1);
   mNodeList.push_back(node);
   ympuint ptr = encode(node, false);
 #endif
@@ -207,7 +219,7 @@ ymuint64
 eval_bdd(ympuint ptr0,
 	 const vector<ymuint64>& iv)
 {
-  ymuint val = 0U;
+  ymuint64 val = 0UL;
   for (ymuint b = 0; b < 64; ++ b) {
     ympuint ptr = ptr0;
     ymuint64 bit = 1UL << b;
@@ -253,4 +265,35 @@ LsimBdd1::eval(const vector<ymuint64>& iv,
   }
 }
 
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimBdd1::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(使わない)
+// @note Bdd1Node は読み出すだけなので eval() と同じでよい．
+void
+LsimBdd1::eval_mt(const vector<ymuint64>& iv,
+		  vector<ymuint64>& ov,
+		  vector<ymuint64>& work) const
+{
+  ymuint no = ov.size();
+  for (ymuint i = 0; i < no; ++ i) {
+    ympuint ptr = mOutputList[i];
+    ov[i] = eval_bdd(ptr, iv);
+  }
+}
+
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimBdd1::node_num() const
+{
+  return mNodeList.size();
+}
+
 END_NAMESPACE_YM
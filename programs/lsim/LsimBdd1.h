@@ -54,6 +54,32 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov);
 
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(使わない)
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -80,6 +106,7 @@ public:
       mFanins[1] = node1;
     }
 
+    // 入力番号
     VarId mId;
     ympuint mFanins[2];
   };
@@ -93,6 +120,9 @@ private:
   // BDD の管理用オブジェクト
   BddMgr mBddMgr;
 
+  // 変数番号から入力番号を得る配列
+  vector<ymuint32> mVarInput;
+
   // ノードの配列
   vector<Bdd1Node*> mNodeList;
 
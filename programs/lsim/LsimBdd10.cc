@@ -68,6 +68,14 @@ LsimBdd10::set_network(const BdnMgr& bdn,
 
   const BdnNodeList& input_list = bdn.input_list();
 
+  ymuint ni = input_list.size();
+  // 変数番号から入力番号を得る配列
+  // 順序マップがない時は変数番号と入力番号は等しい．
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[i] = i;
+  }
   if ( order_map.empty() ) {
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
@@ -79,8 +87,9 @@ LsimBdd10::set_network(const BdnMgr& bdn,
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -89,6 +98,8 @@ LsimBdd10::set_network(const BdnMgr& bdn,
 	abort();
       }
       ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      mVarInput[id] = i;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
       bddmap[node->id()] = bdd;
     }
@@ -189,7 +200,8 @@ LsimBdd10::make_node(Bdd bdd,
     if ( i >= 10 ) {
       break;
     }
-    node->mId[i] = sup_list[i].val();
+    // 評価時に入力ベクタを直接引けるように入力番号を入れる．
+    node->mId[i] = mVarInput[sup_list[i].val()];
   }
   for (ymuint i = n; i < 10; ++ i) {
     node->mId[i] = 0;
@@ -241,7 +253,7 @@ ymuint64
 eval_bdd(ympuint ptr0,
 	 const vector<ymuint64>& iv)
 {
-  ymuint val = 0U;
+  ymuint64 val = 0UL;
   for (ymuint b = 0; b < 64; ++ b) {
     ympuint ptr = ptr0;
     ymuint64 bit = 1UL << b;
@@ -297,4 +309,11 @@ LsimBdd10::eval(const vector<ymuint64>& iv,
 #endif
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimBdd10::node_num() const
+{
+  return mNodeList.size();
+}
+
 END_NAMESPACE_YM
@@ -54,6 +54,11 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov);
 
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -71,6 +76,7 @@ public:
   //////////////////////////////////////////////////////////////////////
 
   struct Bdd10Node {
+    // 入力番号
     ymuint mId[10];
     ympuint mFanins[1024];
   };
@@ -84,6 +90,9 @@ private:
   // BDD の管理用オブジェクト
   BddMgr mBddMgr;
 
+  // 変数番号から入力番号を得る配列
+  vector<ymuint32> mVarInput;
+
   // ノードの配列
   vector<Bdd10Node*> mNodeList;
 
@@ -32,27 +32,8 @@ LsimBdd2::~LsimBdd2()
 
 BEGIN_NONAMESPACE
 
-inline
-ympuint
-encode(LsimBdd2::Bdd2Node* node,
-       bool inv)
-{
-  return reinterpret_cast<ympuint>(node) | inv;
-}
-
-inline
-LsimBdd2::Bdd2Node*
-decode_node(ympuint val)
-{
-  return reinterpret_cast<LsimBdd2::Bdd2Node*>(val & ~1UL);
-}
-
-inline
-bool
-decode_inv(ympuint val)
-{
-  return static_cast<bool>(val & 1UL);
-}
+// 1つのノードの語数
+const ymuint kNodeSize = 6;
 
 END_NONAMESPACE
 
@@ -68,6 +49,14 @@ LsimBdd2::set_network(const BdnMgr& bdn,
 
   const BdnNodeList& input_list = bdn.input_list();
 
+  ymuint ni = input_list.size();
+  // 変数番号から入力番号を得る配列
+  // 順序マップがない時は変数番号と入力番号は等しい．
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[i] = i;
+  }
   if ( order_map.empty() ) {
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
@@ -79,8 +68,9 @@ LsimBdd2::set_network(const BdnMgr& bdn,
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -89,6 +79,8 @@ LsimBdd2::set_network(const BdnMgr& bdn,
 	abort();
       }
       ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      mVarInput[id] = i;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
       bddmap[node->id()] = bdd;
     }
@@ -131,13 +123,13 @@ LsimBdd2::set_network(const BdnMgr& bdn,
 
   mBddMgr.disable_gc();
 
-  unordered_map<Bdd, ympuint> node_map;
+  unordered_map<Bdd, ymuint32> node_map;
 
   const BdnNodeList& output_list = bdn.output_list();
   ymuint no = output_list.size();
   mOutputList.clear();
   mOutputList.reserve(no);
-  mNodeList.clear();
+  mNodeArray.clear();
   for (BdnNodeList::const_iterator p = output_list.begin();
        p != output_list.end(); ++ p) {
     BdnNode* node = *p;
@@ -152,32 +144,36 @@ LsimBdd2::set_network(const BdnMgr& bdn,
     if ( node->output_fanin_inv() ) {
       bdd = ~bdd;
     }
-    ympuint ptr = make_node(bdd, node_map);
-    mOutputList.push_back(ptr);
+    ymuint32 code = make_node(bdd, node_map);
+    mOutputList.push_back(code);
   }
 
-  cout << "Node size: " << mNodeList.size() << endl;
+  cout << "Node size: " << node_num() << endl;
 }
 
-ympuint
+// @brief BDD に対応するノードを作る．
+// @param[in] bdd 対象の BDD
+// @param[inout] node_map BDD からノードの番号を得るマップ
+// @return ノードの番号と極性を返す．
+ymuint32
 LsimBdd2::make_node(Bdd bdd,
-		    unordered_map<Bdd, ympuint>& node_map)
+		    unordered_map<Bdd, ymuint32>& node_map)
 {
   if ( bdd.is_zero() ) {
-    return 0UL;
+    return 0U;
   }
   if ( bdd.is_one() ) {
-    return 1UL;
+    return 1U;
   }
 
-  unordered_map<Bdd, ympuint>::iterator p = node_map.find(bdd);
+  unordered_map<Bdd, ymuint32>::iterator p = node_map.find(bdd);
   if ( p != node_map.end() ) {
     return p->second;
   }
 
   p = node_map.find(~bdd);
   if ( p != node_map.end() ) {
-    return p->second ^ 1UL;
+    return p->second ^ 1U;
   }
 
   Bdd bdd0;
@@ -187,13 +183,13 @@ LsimBdd2::make_node(Bdd bdd,
   VarId varid2(0);
   Bdd bdd00;
   Bdd bdd01;
-  ympuint node00;
-  ympuint node01;
+  ymuint32 node00;
+  ymuint32 node01;
   if ( bdd0.is_zero() ) {
-    node00 = node01 = 0UL;
+    node00 = node01 = 0U;
   }
   else if ( bdd0.is_one() ) {
-    node00 = node01 = 1UL;
+    node00 = node01 = 1U;
   }
   else {
     varid2 = bdd0.root_decomp(bdd00, bdd01);
@@ -202,13 +198,13 @@ LsimBdd2::make_node(Bdd bdd,
   VarId varid3(0);
   Bdd bdd10;
   Bdd bdd11;
-  ympuint node10;
-  ympuint node11;
+  ymuint32 node10;
+  ymuint32 node11;
   if ( bdd1.is_zero() ) {
-    node10 = node11 = 0UL;
+    node10 = node11 = 0U;
   }
   else if ( bdd1.is_one() ) {
-    node10 = node11 = 1UL;
+    node10 = node11 = 1U;
   }
   else {
     varid3 = bdd1.root_decomp(bdd10, bdd11);
@@ -237,63 +233,100 @@ LsimBdd2::make_node(Bdd bdd,
     node11 = make_node(bdd11, node_map);
   }
 
-#if 0
-  mNodeList.push_back(Bdd2Node(varid0, varid1, node00, node01, node10, node11));
-  ympuint ptr = encode(&mNodeList.back(), false);
-#else
-  Bdd2Node* node = new Bdd2Node(varid0, varid1, node00, node01, node10, node11);
-  mNodeList.push_back(node);
-  ympuint ptr = encode(node, false);
-#endif
+  // 評価時に入力ベクタを直接引けるように入力番号を入れる．
+  ymuint32 idx = mNodeArray.size() / kNodeSize;
+  mNodeArray.push_back(mVarInput[varid0.val()]);
+  mNodeArray.push_back(mVarInput[varid1.val()]);
+  mNodeArray.push_back(node00);
+  mNodeArray.push_back(node01);
+  mNodeArray.push_back(node10);
+  mNodeArray.push_back(node11);
+  ymuint32 code = (idx + 1) << 1;
 
-  node_map.insert(make_pair(bdd, ptr));
+  node_map.insert(make_pair(bdd, code));
 
-  return ptr;
+  return code;
 }
 
 BEGIN_NONAMESPACE
 
-ymuint total_step;
-ymuint total_num;
-
+// @brief mask の立っているビットのパタンをまとめて評価する．
+// @param[in] node_array ノードの配列
+// @param[in] code 根のノードの番号と極性
+// @param[in] iv 入力ベクタ
+// @param[in] mask 評価するビットのマスク
+// @return mask の範囲の評価結果を返す．
+// @note 同じ枝をたどるパタンは1度にまとめて進めるので，
+// パタンごとにたどるよりもノードを訪れる回数が少なくなる．
+// 行き先が1つにまとまる時は再帰せずにそのまま進む．
 ymuint64
-eval_bdd(ympuint ptr0,
-	 const vector<ymuint64>& iv)
+eval_bdd(const ymuint32* node_array,
+	 ymuint32 code,
+	 const ymuint64* iv,
+	 ymuint64 mask)
 {
-  ymuint val = 0U;
-  for (ymuint b = 0; b < 64; ++ b) {
-    ympuint ptr = ptr0;
-    ymuint64 bit = 1UL << b;
-    ++ total_num;
-    for ( ; ; ) {
-      ++ total_step;
-      if ( ptr == 0UL ) {
-	break;
+  ymuint64 val = 0UL;
+  for ( ; ; ) {
+    if ( code < 2U ) {
+      if ( code == 1U ) {
+	val |= mask;
       }
-      else if ( ptr == 1UL ) {
-	val |= bit;
-	break;
-      }
-      LsimBdd2::Bdd2Node* node = decode_node(ptr);
-      bool inv = decode_inv(ptr);
-      VarId id0 = node->mId[0];
-      VarId id1 = node->mId[1];
-      ymuint64 ival0 = iv[id0.val()];
-      ymuint64 ival1 = iv[id1.val()];
-      ymuint addr = 0U;
-      if ( ival0 & bit ) {
-	addr |= 2U;
-      }
-      if ( ival1 & bit ) {
-	addr |= 1U;
+      return val;
+    }
+
+    const ymuint32* node = node_array + ((code >> 1) - 1) * kNodeSize;
+    ymuint32 inv = code & 1U;
+    ymuint64 ival0 = iv[node[0]];
+    ymuint64 ival1 = iv[node[1]];
+
+    // 2段目の変数に依存しない枝は1つにまとめる．
+    ymuint64 mask_list[4];
+    ymuint32 code_list[4];
+    ymuint n = 0;
+    if ( node[2] == node[3] ) {
+      mask_list[n] = mask & ~ival0;
+      code_list[n] = node[2] ^ inv;
+      ++ n;
+    }
+    else {
+      mask_list[n] = mask & ~ival0 & ~ival1;
+      code_list[n] = node[2] ^ inv;
+      ++ n;
+      mask_list[n] = mask & ~ival0 & ival1;
+      code_list[n] = node[3] ^ inv;
+      ++ n;
+    }
+    if ( node[4] == node[5] ) {
+      mask_list[n] = mask & ival0;
+      code_list[n] = node[4] ^ inv;
+      ++ n;
+    }
+    else {
+      mask_list[n] = mask & ival0 & ~ival1;
+      code_list[n] = node[4] ^ inv;
+      ++ n;
+      mask_list[n] = mask & ival0 & ival1;
+      code_list[n] = node[5] ^ inv;
+      ++ n;
+    }
+
+    // 最後の空でない枝以外は再帰で評価し，最後の枝はこのまま進む．
+    ymuint last = n;
+    for (ymuint i = 0; i < n; ++ i) {
+      if ( mask_list[i] == 0UL ) {
+	continue;
       }
-      ptr = node->mFanins[addr];
-      if ( inv ) {
-	ptr = ptr ^ 1UL;
+      if ( last < n ) {
+	val |= eval_bdd(node_array, code_list[last], iv, mask_list[last]);
       }
+      last = i;
     }
+    if ( last == n ) {
+      return val;
+    }
+    code = code_list[last];
+    mask = mask_list[last];
   }
-  return val;
 }
 
 END_NONAMESPACE
@@ -305,18 +338,48 @@ void
 LsimBdd2::eval(const vector<ymuint64>& iv,
 	       vector<ymuint64>& ov)
 {
-  total_step = 0;
-  total_num = 0;
+  vector<ymuint64> dummy;
+  eval_mt(iv, ov, dummy);
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimBdd2::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(用いない)
+void
+LsimBdd2::eval_mt(const vector<ymuint64>& iv,
+		  vector<ymuint64>& ov,
+		  vector<ymuint64>& work) const
+{
+  if ( mNodeArray.empty() ) {
+    // 定数出力のみ
+    ymuint no = ov.size();
+    for (ymuint i = 0; i < no; ++ i) {
+      ov[i] = (mOutputList[i] == 1U) ? ~0UL : 0UL;
+    }
+    return;
+  }
+
+  const ymuint32* node_array = &mNodeArray[0];
+  const ymuint64* ivp = iv.empty() ? NULL : &iv[0];
   ymuint no = ov.size();
   for (ymuint i = 0; i < no; ++ i) {
-    ympuint ptr = mOutputList[i];
-    ov[i] = eval_bdd(ptr, iv);
+    ov[i] = eval_bdd(node_array, mOutputList[i], ivp, ~0UL);
   }
-#if 0
-  cout << "total_step = " << total_step << endl
-       << "total_num  = " << total_num << endl
-       << "ave. step  = " << static_cast<double>(total_step) / total_num << endl;
-#endif
+}
+
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimBdd2::node_num() const
+{
+  return mNodeArray.size() / kNodeSize;
 }
 
 END_NAMESPACE_YM
@@ -54,41 +54,45 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov);
 
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
 
-private:
+
+protected:
   //////////////////////////////////////////////////////////////////////
-  // 内部で用いられる関数
+  // 並列評価用の仮想関数
   //////////////////////////////////////////////////////////////////////
 
-  ympuint
-  make_node(Bdd bdd,
-	    unordered_map<Bdd, ympuint>& node_map);
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
 
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(用いない)
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
 
-public:
+
+private:
   //////////////////////////////////////////////////////////////////////
-  // 内部で用いられるデータ構造
+  // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
-  struct Bdd2Node {
-    Bdd2Node(VarId id0,
-	     VarId id1,
-	     ympuint node00,
-	     ympuint node01,
-	     ympuint node10,
-	     ympuint node11)
-    {
-      mId[0] = id0;
-      mId[1] = id1;
-      mFanins[0] = node00;
-      mFanins[1] = node01;
-      mFanins[2] = node10;
-      mFanins[3] = node11;
-    }
-
-    VarId mId[2];
-    ympuint mFanins[4];
-  };
+  /// @brief BDD に対応するノードを作る．
+  /// @param[in] bdd 対象の BDD
+  /// @param[inout] node_map BDD からノードの番号を得るマップ
+  /// @return ノードの番号と極性を返す．
+  ymuint32
+  make_node(Bdd bdd,
+	    unordered_map<Bdd, ymuint32>& node_map);
 
 
 private:
@@ -99,11 +103,21 @@ private:
   // BDD の管理用オブジェクト
   BddMgr mBddMgr;
 
-  // ノードの配列
-  vector<Bdd2Node*> mNodeList;
+  // 変数番号から入力番号を得る配列
+  vector<ymuint32> mVarInput;
 
-  // 出力のノードの配列
-  vector<ympuint> mOutputList;
+  // ノードの配列
+  // 1つのノードは 6 語からなり，
+  //   [0] 1段目の入力番号
+  //   [1] 2段目の入力番号
+  //   [2] - [5] 2つの入力値を (1段目 * 2 + 2段目) とした時の行き先
+  // を持つ．
+  // 行き先はノードの位置を idx として (idx + 1) * 2 + 極性で表す．
+  // 定数は 0 か 1 になる．
+  vector<ymuint32> mNodeArray;
+
+  // 出力のノードの番号と極性の配列
+  vector<ymuint32> mOutputList;
 
 };
 
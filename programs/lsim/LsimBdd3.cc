@@ -8,152 +8,282 @@
 
 
 #include "LsimBdd3.h"
+#include "LsimImage.h"
 #include "YmNetworks/BdnNode.h"
 #include "YmNetworks/BdnPort.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 
 BEGIN_NAMESPACE_YM
 
-//////////////////////////////////////////////////////////////////////
-// クラス LsimBdd3
-//////////////////////////////////////////////////////////////////////
+BEGIN_NONAMESPACE
 
-// @brief コンストラクタ
-LsimBdd3::LsimBdd3() :
-  mBddMgr("bmc", "Bdd Manager")
-{
-}
+// 1つの LUT のワード数
+const ymuint kLutSize = 1024;
 
-// @brief デストラクタ
-LsimBdd3::~LsimBdd3()
-{
-}
+// 1つのセグメントで LUT のアドレスに用いる変数の数
+const ymuint kSegVarNum = 10;
 
+// 最後のセグメントで LUT の値のビット位置に用いる変数の数の最大値
+const ymuint kBitVarNum = 5;
 
-BEGIN_NONAMESPACE
+// 葉を表す変数番号
+const ymuint32 kLeafVar = 0xFFFFFFFFU;
 
-void
-put_bdd(Bdd bdd,
+// BDD を平坦な配列で表したもののノード
+// 0 番目は定数0，1 番目は定数1を表す．
+// 子供は必ず自分より前にある．
+struct FlatNode
+{
+  // 変数番号
+  ymuint32 mVar;
+
+  // 子供の番号
+  ymuint32 mChild[2];
+};
+
+// @brief BDD を平坦な配列に変換する．
+// @note Bdd は参照回数を持つのでスレッドから触れないように
+// あらかじめ BDD の構造だけを取り出しておく．
+ymuint32
+flatten(Bdd bdd,
 	unordered_map<Bdd, ymuint32>& idmap,
-	vector<Bdd>& bdd_array)
+	vector<FlatNode>& node_array)
 {
-  if ( bdd.is_const() ) {
-    return;
+  if ( bdd.is_zero() ) {
+    return 0;
   }
-
-  unordered_map<Bdd, ymuint32>::iterator p = idmap.find(bdd);
-  if ( p == idmap.end() ) {
-    ymuint id = bdd_array.size();
-    bdd_array.push_back(bdd);
-    idmap.insert(make_pair(bdd, id));
-
-    Bdd bdd0;
-    Bdd bdd1;
-    (void) bdd.root_decomp(bdd0, bdd1);
-    put_bdd(bdd0, idmap, bdd_array);
-    put_bdd(bdd1, idmap, bdd_array);
+  if ( bdd.is_one() ) {
+    return 1;
   }
-}
 
-ymuint
-make_lut(Bdd bdd,
-	 const vector<ymuint>& cut_points,
-	 unordered_map<Bdd, ymuint32>& lutmap,
-	 ymuint& nlut);
-
-void
-make_lut_sub(Bdd bdd,
-	     const vector<ymuint>& cut_points,
-	     ymuint limit,
-	     unordered_map<Bdd, ymuint32>& lutmap,
-	     ymuint& nlut)
-{
-  if ( bdd.is_leaf() ) {
-    return;
+  unordered_map<Bdd, ymuint32>::iterator p = idmap.find(bdd);
+  if ( p != idmap.end() ) {
+    return p->second;
   }
 
   Bdd bdd0;
   Bdd bdd1;
   VarId var = bdd.root_decomp(bdd0, bdd1);
-  ymuint var_id = var.val();
-  if ( var_id >= limit ) {
-    make_lut(bdd, cut_points, lutmap, nlut);
-  }
-  else {
-    make_lut_sub(bdd0, cut_points, limit, lutmap, nlut);
-    make_lut_sub(bdd1, cut_points, limit, lutmap, nlut);
-  }
+  ymuint32 id0 = flatten(bdd0, idmap, node_array);
+  ymuint32 id1 = flatten(bdd1, idmap, node_array);
+
+  ymuint32 id = node_array.size();
+  FlatNode node;
+  node.mVar = var.val();
+  node.mChild[0] = id0;
+  node.mChild[1] = id1;
+  node_array.push_back(node);
+  idmap.insert(make_pair(bdd, id));
+  return id;
 }
 
-ymuint
-make_lut(Bdd bdd,
-	 const vector<ymuint>& cut_points,
-	 unordered_map<Bdd, ymuint32>& lutmap,
-	 ymuint& nlut)
+// @brief [lo, hi) の変数に値を割り当てた時のコファクターを求める．
+// @param[in] node_array ノードの配列
+// @param[in] id 根のノード番号
+// @param[in] lo, hi 変数の範囲
+// @param[in] a 割り当て(変数 v の値は (v - lo) ビット目)
+// @note id の関数は lo 未満の変数に依存していないこと．
+inline
+ymuint32
+cofactor(const FlatNode* node_array,
+	 ymuint32 id,
+	 ymuint lo,
+	 ymuint hi,
+	 ymuint a)
 {
-  {
-    unordered_map<Bdd, ymuint32>::iterator p = lutmap.find(bdd);
-    if ( p != lutmap.end() ) {
-    return p->second;
+  while ( id >= 2 ) {
+    const FlatNode& node = node_array[id];
+    if ( node.mVar >= hi ) {
+      break;
     }
+    id = node.mChild[(a >> (node.mVar - lo)) & 1U];
   }
+  return id;
+}
 
-  ymuint addr = nlut * 1024;
-  ++ nlut,
-  lutmap.insert(make_pair(bdd, addr));
+// 一度に取り出すブロック数
+const ymuint kChunkSize = 16;
 
-  Bdd bdd0;
-  Bdd bdd1;
-  VarId var = bdd.root_decomp(bdd0, bdd1);
-  ymuint var_id = var.val();
+// 途中のセグメントの LUT を作るワーカー
+// ブロックごとに 1024 個のコファクターを求め，初めて現れたものを
+// 次のセグメントのブロックとして new_list に入れる．
+// 重複の判定は mStampArray にセグメントごとのタグを書き込んで行う．
+struct CofactorWorker
+{
+  CofactorWorker(const vector<FlatNode>& node_array,
+		 const vector<ymuint32>& block_list,
+		 ymuint lo,
+		 ymuint hi,
+		 ymuint32 tag,
+		 vector<std::atomic<ymuint32> >& stamp_array,
+		 vector<ymuint32>& cof_array,
+		 vector<vector<ymuint32> >& new_list_array) :
+    mNodeArray(node_array),
+    mBlockList(block_list),
+    mLo(lo),
+    mHi(hi),
+    mTag(tag),
+    mStampArray(stamp_array),
+    mCofArray(cof_array),
+    mNewListArray(new_list_array),
+    mNext(0)
+  {
+  }
 
-  ymuint limit = 0;
-  for (vector<ymuint>::const_iterator p = cut_points.begin();
-       p != cut_points.end(); ++ p) {
-    limit = *p;
-    if ( limit > var_id ) {
-      break;
+  void
+  operator()(ymuint tid)
+  {
+    const FlatNode* node_array = &mNodeArray[0];
+    vector<ymuint32>& new_list = mNewListArray[tid];
+    ymuint nb = mBlockList.size();
+    for ( ; ; ) {
+      ymuint start = mNext.fetch_add(kChunkSize);
+      if ( start >= nb ) {
+	break;
+      }
+      ymuint end = start + kChunkSize;
+      if ( end > nb ) {
+	end = nb;
+      }
+      for (ymuint i = start; i < end; ++ i) {
+	ymuint32 root = mBlockList[i];
+	ymuint32* dst = &mCofArray[i * kLutSize];
+	for (ymuint a = 0; a < kLutSize; ++ a) {
+	  ymuint32 id = cofactor(node_array, root, mLo, mHi, a);
+	  dst[a] = id;
+	  if ( mStampArray[id].exchange(mTag) != mTag ) {
+	    new_list.push_back(id);
+	  }
+	}
+      }
     }
   }
 
-  make_lut_sub(bdd0, cut_points, limit, lutmap, nlut);
-  make_lut_sub(bdd1, cut_points, limit, lutmap, nlut);
+  const vector<FlatNode>& mNodeArray;
+  const vector<ymuint32>& mBlockList;
+  ymuint mLo;
+  ymuint mHi;
+  ymuint32 mTag;
+  vector<std::atomic<ymuint32> >& mStampArray;
+  vector<ymuint32>& mCofArray;
+  vector<vector<ymuint32> >& mNewListArray;
+  std::atomic<ymuint> mNext;
+};
+
+// 最後のセグメントの LUT を作るワーカー
+// 先頭の10変数の値でワードを，残りの変数の値でビットを選ぶ．
+struct LeafWorker
+{
+  LeafWorker(const vector<FlatNode>& node_array,
+	     const vector<ymuint32>& block_list,
+	     ymuint lo,
+	     ymuint hi,
+	     ymuint32* lut) :
+    mNodeArray(node_array),
+    mBlockList(block_list),
+    mLo(lo),
+    mHi(hi),
+    mLUT(lut),
+    mNext(0)
+  {
+  }
 
-  return addr;
-}
+  void
+  operator()(ymuint tid)
+  {
+    const FlatNode* node_array = &mNodeArray[0];
+    ymuint mid = mLo + kSegVarNum;
+    ymuint nb = mBlockList.size();
+    for ( ; ; ) {
+      ymuint start = mNext.fetch_add(kChunkSize);
+      if ( start >= nb ) {
+	break;
+      }
+      ymuint end = start + kChunkSize;
+      if ( end > nb ) {
+	end = nb;
+      }
+      for (ymuint i = start; i < end; ++ i) {
+	ymuint32 root = mBlockList[i];
+	ymuint32* dst = mLUT + i * kLutSize;
+	for (ymuint a = 0; a < kLutSize; ++ a) {
+	  ymuint32 id = cofactor(node_array, root, mLo, mid, a);
+	  ymuint32 word = 0U;
+	  for (ymuint c = 0; c < (1U << kBitVarNum); ++ c) {
+	    if ( cofactor(node_array, id, mid, mHi, c) == 1 ) {
+	      word |= (1U << c);
+	    }
+	  }
+	  dst[a] = word;
+	}
+      }
+    }
+  }
 
+  const vector<FlatNode>& mNodeArray;
+  const vector<ymuint32>& mBlockList;
+  ymuint mLo;
+  ymuint mHi;
+  ymuint32* mLUT;
+  std::atomic<ymuint> mNext;
+};
+
+// @brief ワーカーを thread_num 個のスレッドで実行する．
+template<typename Worker>
 void
-make_lut2(Bdd bdd,
-	  const vector<ymuint>& cut_points,
-	  ymuint32* lut,
-	  const unordered_map<Bdd, ymuint32>& lutmap)
+run_workers(Worker& worker,
+	    ymuint thread_num)
 {
-#if 0
-  Bdd bdd0;
-  Bdd bdd1;
-  ymuint var = bdd.root_decomp(bdd0, bdd1);
-  ymuint pos;
-  for (pos = 1; pos < cut_points.size(); ++ pos) {
-    if ( var < cut_points[pos] ) {
-      break;
-    }
+  if ( thread_num <= 1 ) {
+    worker(0);
+    return;
   }
-  ymuint base = cut_points[pos - 1];
-  ymuint limit = cut_points[pos];
-  if ( limit - base == 10 ) {
-    for (ymuint b = 0U; b < 1024U; ++ b) {
-      Bdd leaf = eval_bdd(bdd, base, p);
-      unordered_map<Bdd, ymuint32>::const_iterator p = lutmap.find(leaf);
-      ASSERT_COND( p != lutmap.end() );
-    }
+
+  vector<std::thread> thread_list;
+  thread_list.reserve(thread_num);
+  for (ymuint i = 0; i < thread_num; ++ i) {
+    thread_list.push_back(std::thread(std::ref(worker), i));
   }
-  else {
+  for (vector<std::thread>::iterator p = thread_list.begin();
+       p != thread_list.end(); ++ p) {
+    p->join();
   }
-#endif
 }
 
 END_NONAMESPACE
 
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimBdd3
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] thread_num LUT を作る時のスレッド数
+// @note thread_num = 0 の時はハードウェアのスレッド数を用いる．
+LsimBdd3::LsimBdd3(ymuint thread_num) :
+  mBddMgr("bmc", "Bdd Manager"),
+  mThreadNum(thread_num),
+  mSignature(0UL),
+  mInputNum(0),
+  mLutPtr(NULL),
+  mLutNum(0)
+{
+  if ( mThreadNum == 0 ) {
+    mThreadNum = std::thread::hardware_concurrency();
+    if ( mThreadNum == 0 ) {
+      mThreadNum = 1;
+    }
+  }
+}
+
+// @brief デストラクタ
+LsimBdd3::~LsimBdd3()
+{
+}
+
 // @brief ネットワークをセットする．
 // @param[in] bdn 対象のネットワーク
 // @param[in] order_map 順序マップ
@@ -161,25 +291,20 @@ void
 LsimBdd3::set_network(const BdnMgr& bdn,
 		      const unordered_map<string, ymuint>& order_map)
 {
-  ymuint n = bdn.max_node_id();
-  vector<Bdd> bddmap(n);
-
   const BdnNodeList& input_list = bdn.input_list();
   ymuint ni = input_list.size();
 
+  // 入力ごとの変数番号を求める．
+  vector<ymuint32> input_var(ni);
   if ( order_map.empty() ) {
-    ymuint id = 0;
-    for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
-      const BdnNode* node = *p;
-      Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
-      ++ id;
-      bddmap[node->id()] = bdd;
+    for (ymuint i = 0; i < ni; ++ i) {
+      input_var[i] = i;
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -187,12 +312,47 @@ LsimBdd3::set_network(const BdnMgr& bdn,
 	cerr << "No map for " << name << endl;
 	abort();
       }
-      ymuint id = q->second;
-      Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
-      bddmap[node->id()] = bdd;
+      ASSERT_COND( q->second < ni );
+      input_var[i] = q->second;
     }
   }
 
+  ymuint64 signature = network_signature(bdn, order_map);
+  if ( mLutFile != string() ) {
+    if ( read_lut(mLutFile) && mSignature == signature ) {
+      cout << "LUT image:        \tloaded from " << mLutFile << endl;
+      return;
+    }
+  }
+  mSignature = signature;
+
+  mInputNum = ni;
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[input_var[i]] = i;
+  }
+
+  // セグメントに分ける．
+  // 最後のセグメントは kSegVarNum + kBitVarNum 個まで変数を持てる．
+  mSegTop.clear();
+  mSegTop.push_back(0);
+  for (ymuint i = kSegVarNum; i + kBitVarNum < ni; i += kSegVarNum) {
+    mSegTop.push_back(i);
+  }
+  mSegTop.push_back(ni);
+
+  ymuint n = bdn.max_node_id();
+  vector<Bdd> bddmap(n);
+
+  ymuint i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    Bdd bdd = mBddMgr.make_posiliteral(VarId(input_var[i]));
+    bddmap[node->id()] = bdd;
+  }
+
   vector<const BdnNode*> node_list;
   bdn.sort(node_list);
   for (vector<const BdnNode*>::const_iterator p = node_list.begin();
@@ -208,10 +368,6 @@ LsimBdd3::set_network(const BdnMgr& bdn,
     if ( node->fanin1_inv() ) {
       bdd1 = ~bdd1;
     }
-#if 0
-    cout << " " << bdd0.size() << " x " << bdd1.size();
-    cout.flush();
-#endif
     if ( node->is_and() ) {
       Bdd bdd = bdd0 & bdd1;
       bddmap[node->id()] = bdd;
@@ -223,66 +379,147 @@ LsimBdd3::set_network(const BdnMgr& bdn,
     else {
       ASSERT_NOT_REACHED;
     }
-#if 0
-    cout << " = " << bddmap[node->id()].size();
-#endif
   }
 
   mBddMgr.disable_gc();
 
-  unordered_map<Bdd, ymuint32> idmap;
-  vector<Bdd> bdd_array;
-
   const BdnNodeList& output_list = bdn.output_list();
-  ymuint no = output_list.size();
-  vector<int> output_id;
-  output_id.reserve(no);
+  vector<Bdd> output_bdd_list;
+  output_bdd_list.reserve(output_list.size());
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* node0 = node->output_fanin();
+    Bdd bdd;
+    if ( node0 != NULL ) {
+      bdd = bddmap[node0->id()];
+    }
+    else {
+      bdd = mBddMgr.make_zero();
+    }
+    if ( node->output_fanin_inv() ) {
+      bdd = ~bdd;
+    }
+    output_bdd_list.push_back(bdd);
+  }
 
-  unordered_map<Bdd, ymuint32> lutmap;
+  make_lut(output_bdd_list);
 
-  vector<ymuint> cut_points;
-  for (ymuint i = 0; i < ni; ) {
-    i += 10;
-    if ( i + 5 >= ni ) {
-      break;
+  cout << "LUT num:          \t" << mLutNum << endl;
+
+  if ( mLutFile != string() ) {
+    if ( write_lut(mLutFile) ) {
+      cout << "LUT image:        \tsaved to " << mLutFile << endl;
+    }
+    else {
+      cerr << "Could not write " << mLutFile << endl;
     }
-    cut_points.push_back(i);
   }
-  cut_points.push_back(ni);
+}
+
+// @brief BDD から LUT を作る．
+// @param[in] output_bdd_list 出力の BDD のリスト
+// @note セグメントごとにそのセグメントの全てのブロック(LUT)を
+// 複数のスレッドで並列に作る．
+void
+LsimBdd3::make_lut(const vector<Bdd>& output_bdd_list)
+{
+  // BDD を平坦な配列に変換する．
+  vector<FlatNode> node_array;
+  {
+    FlatNode leaf;
+    leaf.mVar = kLeafVar;
+    leaf.mChild[0] = 0;
+    leaf.mChild[1] = 0;
+    node_array.push_back(leaf);
+    leaf.mChild[0] = 1;
+    leaf.mChild[1] = 1;
+    node_array.push_back(leaf);
+  }
+  unordered_map<Bdd, ymuint32> idmap;
+  ymuint no = output_bdd_list.size();
+  vector<ymuint32> root_list(no);
+  for (ymuint i = 0; i < no; ++ i) {
+    root_list[i] = flatten(output_bdd_list[i], idmap, node_array);
+  }
+  ymuint nn = node_array.size();
+
+  // 最初のセグメントのブロックは各出力の根
+  vector<ymuint32> block_list(root_list);
+  sort(block_list.begin(), block_list.end());
+  block_list.erase(unique(block_list.begin(), block_list.end()),
+		   block_list.end());
+
+  // ノード番号からそのノードのブロック番号を得る配列
+  vector<ymuint32> block_id(nn, 0U);
+  for (ymuint i = 0; i < block_list.size(); ++ i) {
+    block_id[block_list[i]] = i;
+  }
 
   mOutputList.clear();
   mOutputList.reserve(no);
-  ymuint nlut = 0;
-  for (BdnNodeList::const_iterator p = output_list.begin();
-       p != output_list.end(); ++ p) {
-    BdnNode* node = *p;
-    BdnNode* node0 = node->output_fanin();
-    Bdd bdd = bddmap[node0->id()];
-    if ( node->output_fanin_inv() ) {
-      bdd = ~bdd;
-    }
-    put_bdd(bdd, idmap, bdd_array);
+  for (ymuint i = 0; i < no; ++ i) {
+    mOutputList.push_back(block_id[root_list[i]] * kLutSize);
+  }
 
-    unordered_map<Bdd, ymuint32>::iterator q = idmap.find(bdd);
-    ASSERT_COND( q != idmap.end() );
+  vector<std::atomic<ymuint32> > stamp_array(nn);
+  for (ymuint i = 0; i < nn; ++ i) {
+    stamp_array[i].store(0U);
+  }
 
-    output_id.push_back(q->second);
+  mLUT.clear();
+  mLutNum = 0;
+  ymuint ns = mSegTop.size() - 1;
+  for (ymuint s = 0; s < ns; ++ s) {
+    ymuint lo = mSegTop[s];
+    ymuint hi = mSegTop[s + 1];
+    ymuint nb = block_list.size();
+    ymuint base = mLutNum;
+    // アドレスは ymuint32 で表す．
+    ASSERT_COND( static_cast<ymuint64>(base + nb) * kLutSize <= 0xFFFFFFFFUL );
+    mLUT.resize((base + nb) * kLutSize);
+
+    if ( s == ns - 1 ) {
+      LeafWorker worker(node_array, block_list, lo, hi,
+			&mLUT[base * kLutSize]);
+      run_workers(worker, mThreadNum);
+    }
+    else {
+      vector<ymuint32> cof_array(nb * kLutSize);
+      vector<vector<ymuint32> > new_list_array(mThreadNum);
+      CofactorWorker worker(node_array, block_list, lo, hi, s + 1,
+			    stamp_array, cof_array, new_list_array);
+      run_workers(worker, mThreadNum);
+
+      // 結果がスレッド数によらないように番号順に並べる．
+      vector<ymuint32> new_list;
+      for (ymuint t = 0; t < mThreadNum; ++ t) {
+	const vector<ymuint32>& list1 = new_list_array[t];
+	new_list.insert(new_list.end(), list1.begin(), list1.end());
+      }
+      sort(new_list.begin(), new_list.end());
 
-    ymuint addr = make_lut(bdd, cut_points, lutmap, nlut);
-    mOutputList.push_back(addr);
+      ymuint next_base = base + nb;
+      for (ymuint i = 0; i < new_list.size(); ++ i) {
+	block_id[new_list[i]] = next_base + i;
+      }
+      ymuint32* dst = &mLUT[base * kLutSize];
+      for (ymuint i = 0; i < nb * kLutSize; ++ i) {
+	dst[i] = block_id[cof_array[i]] * kLutSize;
+      }
+      block_list.swap(new_list);
+    }
+    mLutNum += nb;
   }
 
-  mLUT = new ymuint32[nlut * 1024];
+  // 以前に読み込んだイメージは不要
+  mImage.close();
+  mLutPtr = &mLUT[0];
 
-  for (unordered_map<Bdd, ymuint32>::iterator p = lutmap.begin();
-       p != lutmap.end(); ++ p) {
-    Bdd bdd = p->first;
-    ymuint32 addr = p->second;
-    make_lut2(bdd, cut_points, &mLUT[addr], lutmap);
-  }
+  mAddrArray.clear();
+  mAddrArray.resize(work_size(), 0UL);
 }
 
-
 // @brief 論理シミュレーションを行う．
 // @param[in] iv 入力ベクタ
 // @param[out] ov 出力ベクタ
@@ -290,63 +527,293 @@ void
 LsimBdd3::eval(const vector<ymuint64>& iv,
 	       vector<ymuint64>& ov)
 {
+  eval_mt(iv, ov, mAddrArray);
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimBdd3::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+ymuint
+LsimBdd3::work_size() const
+{
+  // セグメントごとのワードアドレスと最後のセグメントのビット位置
+  return mSegTop.size() * 64;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(セグメントごとのアドレス)
+// @note LUT は読み出すだけなので複数のスレッドから呼んでもよい．
+void
+LsimBdd3::eval_mt(const vector<ymuint64>& iv,
+		  vector<ymuint64>& ov,
+		  vector<ymuint64>& work) const
+{
+  ASSERT_COND( iv.size() == mInputNum );
+
+  // LUT のアドレスは出力によらないので先に求めておく．
+  ymuint64* addr_array = &work[0];
+  calc_addr(iv, addr_array);
+
   ymuint no = ov.size();
   for (ymuint i = 0; i < no; ++ i) {
     ymuint addr0 = mOutputList[i];
-    ov[i] = eval_lut(addr0, iv);
+    ov[i] = eval_lut(addr0, addr_array);
   }
 }
 
-
-BEGIN_NONAMESPACE
-
-inline
-ymuint
-calc_addr(const vector<ymuint64>& iv,
-	  ymuint base)
+// @brief 各セグメントの LUT のアドレスを計算する．
+// @param[in] iv 入力ベクタ
+// @param[out] addr_array アドレスを格納する配列
+// @note s 番目のセグメントのビット b のパタンのアドレスは
+// addr_array[s * 64 + b] に入る．
+// 最後のセグメントのビット位置は addr_array[ns * 64 + b] に入る．
+void
+LsimBdd3::calc_addr(const vector<ymuint64>& iv,
+		    ymuint64* addr_array) const
 {
-  ymuint ni = iv.size();
-  ymuint next = base + 10;
-  ymuint end = (next < ni) ? next : ni;
-  ymuint addr = 0U;
-  for (ymuint i = base; i < end; ++ i) {
-    if ( iv[i] ) {
-      addr |= (1U << (next - i));
+  ymuint ns = mSegTop.size() - 1;
+  for (ymuint i = 0; i < (ns + 1) * 64; ++ i) {
+    addr_array[i] = 0UL;
+  }
+  for (ymuint s = 0; s < ns; ++ s) {
+    ymuint lo = mSegTop[s];
+    ymuint hi = mSegTop[s + 1];
+    for (ymuint v = lo; v < hi; ++ v) {
+      ymuint pos = v - lo;
+      ymuint64* dst = addr_array + s * 64;
+      if ( pos >= kSegVarNum ) {
+	// 最後のセグメントの残りの変数
+	pos -= kSegVarNum;
+	dst = addr_array + ns * 64;
+      }
+      ymuint64 w = iv[mVarInput[v]];
+      for (ymuint b = 0; b < 64; ++ b) {
+	dst[b] |= ((w >> b) & 1UL) << pos;
+      }
     }
   }
-  return addr;
 }
 
-END_NONAMESPACE
-
 // @brief 1つの出力に対する評価を行う．
+// @param[in] addr0 出力の LUT の先頭アドレス
+// @param[in] addr_array calc_addr() で計算したアドレスの配列
 ymuint64
 LsimBdd3::eval_lut(ymuint addr0,
-		   const vector<ymuint64>& iv)
+		   const ymuint64* addr_array) const
 {
-  ymuint ni = iv.size();
-  ymuint val = 0U;
+  const ymuint32* lut = mLutPtr;
+  ymuint ns = mSegTop.size() - 1;
+  const ymuint64* last_array = addr_array + (ns - 1) * 64;
+  const ymuint64* bit_array = addr_array + ns * 64;
+  ymuint64 val = 0UL;
   for (ymuint b = 0; b < 64; ++ b) {
-    ymuint base = 0;
     ymuint addr = addr0;
-    for ( ; ; ) {
-      ymuint next = base + 10;
-      if ( next + 5 < ni ) {
-	ymuint addr1 = calc_addr(iv, base);
-	addr = mLUT[addr + addr1];
-	base = next;
+    for (ymuint s = 0; s < ns - 1; ++ s) {
+      addr = lut[addr + addr_array[s * 64 + b]];
+    }
+    ymuint32 word = lut[addr + last_array[b]];
+    if ( (word >> bit_array[b]) & 1U ) {
+      val |= (1UL << b);
+    }
+  }
+  return val;
+}
+
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimBdd3::node_num() const
+{
+  return mLutNum;
+}
+
+// @brief LUT イメージのファイル名を設定する．
+// @param[in] filename ファイル名
+// @note 設定されていると set_network() はまずこのファイルを読み込み，
+// 同じネットワークのものならそれを用いる．そうでなければ LUT を作って
+// このファイルに書き出す．
+void
+LsimBdd3::set_lut_file(const string& filename)
+{
+  mLutFile = filename;
+}
+
+// @brief LUT イメージをファイルに書き出す．
+// @param[in] filename ファイル名
+// @retval true 書き出しが成功した．
+// @retval false 書き出しが失敗した．
+bool
+LsimBdd3::write_lut(const string& filename) const
+{
+  LsimImageWriter writer;
+  if ( !writer.open(filename, image_name(), image_version(), mSignature) ) {
+    return false;
+  }
+  write_image(writer);
+  return writer.close();
+}
+
+// @brief LUT イメージをファイルから読み込む．
+// @param[in] filename ファイル名
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+bool
+LsimBdd3::read_lut(const string& filename)
+{
+  LsimImageReader reader;
+  if ( !reader.open(filename, image_name(), image_version()) ) {
+    return false;
+  }
+  return read_image(reader);
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+const char*
+LsimBdd3::image_name() const
+{
+  return "bdd3";
+}
+
+// @brief イメージファイルの形式のバージョンを返す．
+ymuint32
+LsimBdd3::image_version() const
+{
+  return 1;
+}
+
+// @brief set_network() で作った内容をイメージファイルに書き出す．
+// @param[in] writer 書き出し用のオブジェクト
+void
+LsimBdd3::write_image(LsimImageWriter& writer) const
+{
+  writer.write_64(mInputNum);
+  writer.write_64(mLutNum);
+  writer.write_array(mSegTop);
+  writer.write_array(mVarInput);
+  writer.write_array(mOutputList);
+  writer.write_array(mLutPtr, static_cast<ymuint64>(mLutNum) * kLutSize);
+}
+
+// @brief イメージファイルの内容を読み込む．
+// @param[in] reader 読み込み用のオブジェクト
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+// @note LUT 本体はコピーせずに写像した領域をそのまま用いる．
+bool
+LsimBdd3::read_image(LsimImageReader& reader)
+{
+  ymuint64 ni;
+  ymuint64 nlut;
+  vector<ymuint32> seg_top;
+  vector<ymuint32> var_input;
+  vector<ymuint32> output_list;
+  const ymuint32* lut;
+  ymuint64 lut_size;
+  if ( !reader.read_64(ni) ||
+       !reader.read_64(nlut) ||
+       !reader.read_array(seg_top) ||
+       !reader.read_array(var_input) ||
+       !reader.read_array(output_list) ||
+       !reader.map_array(lut, lut_size) ) {
+    return false;
+  }
+  if ( seg_top.size() < 2 ||
+       var_input.size() != ni ||
+       nlut > 0xFFFFFFFFUL / kLutSize ||
+       lut_size != nlut * kLutSize ) {
+    return false;
+  }
+
+  // ファイルが壊れていても範囲外を参照しないように番号を確かめる．
+  ymuint ns = seg_top.size() - 1;
+  if ( seg_top[0] != 0U || seg_top[ns] != ni ) {
+    return false;
+  }
+  for (ymuint s = 0; s < ns; ++ s) {
+    // 最後のセグメント以外は LUT のアドレスの分の変数しか持たない．
+    ymuint max_num = kSegVarNum;
+    if ( s == ns - 1 ) {
+      max_num += kBitVarNum;
+    }
+    if ( seg_top[s] > seg_top[s + 1] ||
+	 seg_top[s + 1] - seg_top[s] > max_num ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < ni; ++ i) {
+    if ( var_input[i] >= ni ) {
+      return false;
+    }
+  }
+
+  // 出力から LUT をたどり，アドレスとして用いる値が LUT の先頭を指して
+  // いることを確かめる．
+  // 1つの LUT は決まったセグメントでしか参照されないはずなので，
+  // 各 LUT のセグメント番号を記録して異なる深さで参照されたら失敗とする．
+  const ymuint32 kNoSeg = 0xFFFFFFFFU;
+  vector<ymuint32> seg_of(nlut, kNoSeg);
+  vector<ymuint32> queue;
+  queue.reserve(nlut);
+  for (ymuint i = 0; i < output_list.size(); ++ i) {
+    ymuint32 addr = output_list[i];
+    if ( addr % kLutSize != 0 || addr >= lut_size ) {
+      return false;
+    }
+    ymuint32 b = addr / kLutSize;
+    if ( seg_of[b] == kNoSeg ) {
+      seg_of[b] = 0;
+      queue.push_back(b);
+    }
+    else if ( seg_of[b] != 0 ) {
+      return false;
+    }
+  }
+  for (ymuint rpos = 0; rpos < queue.size(); ++ rpos) {
+    ymuint32 b = queue[rpos];
+    ymuint32 s1 = seg_of[b] + 1;
+    if ( s1 == ns ) {
+      // 最後のセグメントの LUT の値はビットベクタ
+      continue;
+    }
+    const ymuint32* src = lut + b * kLutSize;
+    for (ymuint j = 0; j < kLutSize; ++ j) {
+      ymuint32 addr = src[j];
+      if ( addr % kLutSize != 0 || addr >= lut_size ) {
+	return false;
       }
-      else {
-	ymuint addr1 = calc_addr(iv, base);
-	ymuint addr2 = calc_addr(iv, next);
-	if ( (mLUT[addr + addr1] >> addr2) & 1UL ) {
-	  val |= (1U << b);
-	}
-	break;
+      ymuint32 b1 = addr / kLutSize;
+      if ( seg_of[b1] == kNoSeg ) {
+	seg_of[b1] = s1;
+	queue.push_back(b1);
+      }
+      else if ( seg_of[b1] != s1 ) {
+	return false;
       }
     }
   }
-  return val;
+
+  mSignature = reader.signature();
+  mInputNum = ni;
+  mLutNum = nlut;
+  mSegTop.swap(seg_top);
+  mVarInput.swap(var_input);
+  mOutputList.swap(output_list);
+  // 作った LUT は不要なので解放する．
+  vector<ymuint32>().swap(mLUT);
+  mLutPtr = lut;
+  mImage.swap(reader);
+  mAddrArray.clear();
+  mAddrArray.resize(work_size(), 0UL);
+
+  cout << "LUT num:          \t" << mLutNum << endl;
+
+  return true;
 }
 
 END_NAMESPACE_YM
@@ -10,6 +10,7 @@
 
 
 #include "Lsim.h"
+#include "LsimImage.h"
 #include "YmLogic/Bdd.h"
 #include "YmLogic/BddMgr.h"
 
@@ -19,6 +20,10 @@ BEGIN_NAMESPACE_YM
 //////////////////////////////////////////////////////////////////////
 /// @class LsimBdd3 LsimBdd3.h "LsimBdd3.h"
 /// @brief BDD を用いた Lsim の実装
+///
+/// 変数を10個ずつのセグメントに区切り，各セグメントの変数の値で
+/// 引く 1024 エントリの LUT で BDD をたどる．
+/// 最後のセグメントは 15 変数までで，LUT の値のビットが出力値となる．
 //////////////////////////////////////////////////////////////////////
 class LsimBdd3 :
   public Lsim
@@ -26,7 +31,10 @@ class LsimBdd3 :
 public:
 
   /// @brief コンストラクタ
-  LsimBdd3();
+  /// @param[in] thread_num LUT を作る時のスレッド数
+  /// @note thread_num = 0 の時はハードウェアのスレッド数を用いる．
+  explicit
+  LsimBdd3(ymuint thread_num = 0);
 
   /// @brief デストラクタ
   virtual
@@ -54,16 +62,119 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov);
 
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // LUT イメージの入出力
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief LUT イメージのファイル名を設定する．
+  /// @param[in] filename ファイル名
+  /// @note 設定されていると set_network() はまずこのファイルを読み込み，
+  /// 同じネットワークのものならそれを用いる．そうでなければ LUT を作って
+  /// このファイルに書き出す．
+  void
+  set_lut_file(const string& filename);
+
+  /// @brief LUT イメージをファイルに書き出す．
+  /// @param[in] filename ファイル名
+  /// @retval true 書き出しが成功した．
+  /// @retval false 書き出しが失敗した．
+  bool
+  write_lut(const string& filename) const;
+
+  /// @brief LUT イメージをファイルから読み込む．
+  /// @param[in] filename ファイル名
+  /// @retval true 読み込みが成功した．
+  /// @retval false 読み込みが失敗した．
+  bool
+  read_lut(const string& filename);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイル用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルに記録する手法名を返す．
+  virtual
+  const char*
+  image_name() const;
+
+  /// @brief イメージファイルの形式のバージョンを返す．
+  virtual
+  ymuint32
+  image_version() const;
+
+  /// @brief set_network() で作った内容をイメージファイルに書き出す．
+  /// @param[in] writer 書き出し用のオブジェクト
+  virtual
+  void
+  write_image(LsimImageWriter& writer) const;
+
+  /// @brief イメージファイルの内容を読み込む．
+  /// @param[in] reader 読み込み用のオブジェクト
+  /// @retval true 読み込みが成功した．
+  /// @retval false 読み込みが失敗した．
+  virtual
+  bool
+  read_image(LsimImageReader& reader);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief eval_mt() で用いる作業領域のサイズを返す．
+  virtual
+  ymuint
+  work_size() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(セグメントごとのアドレス)
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
 
 private:
   //////////////////////////////////////////////////////////////////////
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief BDD から LUT を作る．
+  /// @param[in] output_bdd_list 出力の BDD のリスト
+  void
+  make_lut(const vector<Bdd>& output_bdd_list);
+
+  /// @brief 各セグメントの LUT のアドレスを計算する．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] addr_array アドレスを格納する配列
+  void
+  calc_addr(const vector<ymuint64>& iv,
+	    ymuint64* addr_array) const;
+
   /// @brief 1つの出力に対する評価を行う．
+  /// @param[in] addr0 出力の LUT の先頭アドレス
+  /// @param[in] addr_array calc_addr() で計算したアドレスの配列
   ymuint64
   eval_lut(ymuint addr0,
-	   const vector<ymuint64>& iv);
+	   const ymuint64* addr_array) const;
 
 
 private:
@@ -74,12 +185,45 @@ private:
   // BDD の管理用オブジェクト
   BddMgr mBddMgr;
 
-  // 巨大な Look-Up Table
-  ymuint32* mLUT;
+  // LUT を作る時のスレッド数
+  ymuint32 mThreadNum;
+
+  // LUT イメージのファイル名
+  string mLutFile;
+
+  // ネットワークの構造と変数順から求めたハッシュ値
+  ymuint64 mSignature;
+
+  // 入力数
+  ymuint32 mInputNum;
+
+  // 各セグメントの先頭の変数番号
+  // 末尾には入力数が入る．
+  vector<ymuint32> mSegTop;
+
+  // 変数番号から入力番号を得る配列
+  vector<ymuint32> mVarInput;
+
+  // make_lut() で作った Look-Up Table
+  vector<ymuint32> mLUT;
+
+  // 読み込んだ LUT イメージ
+  LsimImageReader mImage;
+
+  // 評価に用いる LUT の先頭
+  // mLUT か mImage の写像した領域を指す．
+  const ymuint32* mLutPtr;
+
+  // LUT の数
+  // 1つの LUT は 1024 ワード
+  ymuint32 mLutNum;
 
   // 出力の LUT のエントリポイント
   vector<ymuint32> mOutputList;
 
+  // eval() 用の作業領域
+  vector<ymuint64> mAddrArray;
+
 };
 
 END_NAMESPACE_YM
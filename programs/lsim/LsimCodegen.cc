@@ -0,0 +1,450 @@
+﻿
+/// @file LsimCodegen.cc
+/// @brief LsimCodegen の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimCodegen.h"
+#include "YmNetworks/BdnNode.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 生成する関数の名前
+const char* kFuncName = "lsim_eval";
+
+// 文字列のハッシュ値を求める(FNV-1a)．
+ymuint64
+hash_func(const string& str)
+{
+  ymuint64 h = 14695981039346656037UL;
+  for (string::const_iterator p = str.begin(); p != str.end(); ++ p) {
+    h ^= static_cast<ymuint8>(*p);
+    h *= 1099511628211UL;
+  }
+  return h;
+}
+
+// ハッシュ値を16進数の文字列にする．
+string
+hash_str(ymuint64 h)
+{
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx",
+	   static_cast<unsigned long long>(h));
+  return string(buf);
+}
+
+// ファイルが存在する時 true を返す．
+// シンボリックリンクはたどらない．
+bool
+file_exists(const string& filename)
+{
+  struct stat sbuf;
+  return lstat(filename.c_str(), &sbuf) == 0;
+}
+
+// path が自分の所有するディレクトリ(dir が true の時)か通常ファイルで，
+// 他のユーザーが書き込めない時 true を返す．
+// そうでない時はエラーメッセージを出力して false を返す．
+// シンボリックリンクはたどらずに拒否する．
+bool
+check_owner(const string& path,
+	    bool dir)
+{
+  struct stat sbuf;
+  if ( lstat(path.c_str(), &sbuf) != 0 ) {
+    cerr << "Could not stat " << path << endl;
+    return false;
+  }
+  bool type_ok = dir ? S_ISDIR(sbuf.st_mode) : S_ISREG(sbuf.st_mode);
+  if ( !type_ok || sbuf.st_uid != geteuid() ||
+       (sbuf.st_mode & (S_IWGRP | S_IWOTH)) != 0 ) {
+    cerr << path << " is not owned by the current user "
+	 << "or is writable by others" << endl;
+    return false;
+  }
+  return true;
+}
+
+// 既定のキャッシュディレクトリを返す．
+// $XDG_CACHE_HOME/lsim，$HOME/.cache/lsim，/tmp/lsim_cache-<uid> の順に
+// 用いる．$XDG_CACHE_HOME や $HOME/.cache はなければ作っておく．
+string
+default_cache_dir()
+{
+  string base;
+  const char* xdg = getenv("XDG_CACHE_HOME");
+  const char* home = getenv("HOME");
+  if ( xdg != NULL && xdg[0] == '/' ) {
+    base = xdg;
+  }
+  else if ( home != NULL && home[0] == '/' ) {
+    base = string(home) + "/.cache";
+  }
+  if ( !base.empty() &&
+       (mkdir(base.c_str(), 0700) == 0 || errno == EEXIST) ) {
+    return base + "/lsim";
+  }
+  ostringstream buf;
+  buf << "/tmp/lsim_cache-" << geteuid();
+  return buf.str();
+}
+
+// シェルのコマンド行に埋め込むために文字列をクォートする．
+// 全体を ' で囲み，中の ' は '\'' に置き換える．
+string
+shell_quote(const string& str)
+{
+  string ans("'");
+  for (string::const_iterator p = str.begin(); p != str.end(); ++ p) {
+    if ( *p == '\'' ) {
+      ans += "'\\''";
+    }
+    else {
+      ans += *p;
+    }
+  }
+  ans += "'";
+  return ans;
+}
+
+// 文字列を空白で区切り，単語ごとにクォートしてつなげる．
+// CC="ccache gcc" のように複数の単語からなるコマンドのために用いる．
+string
+shell_quote_words(const string& str)
+{
+  string ans;
+  string::size_type pos = 0;
+  for ( ; ; ) {
+    string::size_type begin = str.find_first_not_of(" \t", pos);
+    if ( begin == string::npos ) {
+      break;
+    }
+    string::size_type end = str.find_first_of(" \t", begin);
+    if ( end == string::npos ) {
+      end = str.size();
+    }
+    if ( !ans.empty() ) {
+      ans += " ";
+    }
+    ans += shell_quote(str.substr(begin, end - begin));
+    pos = end;
+  }
+  return ans;
+}
+
+// ロード済みの評価関数
+// 同じプロセス内で同じネットリストを何度もセットした時に用いる．
+unordered_map<ymuint64, LsimCodegen::EvalFunc> func_cache;
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimCodegen
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] cache_dir キャッシュディレクトリ
+// @note cache_dir が空の時は環境変数 LSIM_CACHE_DIR の値を用いる．
+// それもない時は default_cache_dir() を用いる．
+LsimCodegen::LsimCodegen(const string& cache_dir) :
+  mCacheDir(cache_dir),
+  mInputNum(0),
+  mOutputNum(0),
+  mNodeNum(0),
+  mEvalFunc(NULL)
+{
+  if ( mCacheDir == string() ) {
+    const char* env = getenv("LSIM_CACHE_DIR");
+    if ( env != NULL ) {
+      mCacheDir = env;
+    }
+    else {
+      mCacheDir = default_cache_dir();
+    }
+  }
+}
+
+// @brief デストラクタ
+LsimCodegen::~LsimCodegen()
+{
+  // ロードした共有ライブラリは func_cache で使い回すので閉じない．
+}
+
+// @brief ネットワークをセットする．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+void
+LsimCodegen::set_network(const BdnMgr& bdn,
+			 const unordered_map<string, ymuint>& order_map)
+{
+  mInputNum = bdn.input_num();
+  mOutputNum = bdn.output_num();
+  mNodeNum = bdn.lnode_num();
+
+  ostringstream buf;
+  gen_code(bdn, buf);
+  mEvalFunc = load_code(buf.str());
+  if ( mEvalFunc == NULL ) {
+    cerr << "Falling back to soa" << endl;
+    LsimSoa::set_network(bdn, order_map);
+  }
+}
+
+// @brief 論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+void
+LsimCodegen::eval(const vector<ymuint64>& iv,
+		  vector<ymuint64>& ov)
+{
+  if ( mEvalFunc == NULL ) {
+    LsimSoa::eval(iv, ov);
+    return;
+  }
+
+  ASSERT_COND( iv.size() == mInputNum );
+  ASSERT_COND( ov.size() == mOutputNum );
+  // 入力や出力がない時は配列が空なので先頭の要素を参照できない．
+  // その時は生成された関数もその配列を読み書きしない．
+  (*mEvalFunc)(iv.empty() ? NULL : &iv[0], ov.empty() ? NULL : &ov[0]);
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+const char*
+LsimCodegen::image_name() const
+{
+  // LsimSoa のイメージを読むと mEvalFunc が作られないので使わない．
+  return NULL;
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimCodegen::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+ymuint
+LsimCodegen::work_size() const
+{
+  if ( mEvalFunc == NULL ) {
+    return LsimSoa::work_size();
+  }
+  // 生成された関数は局所変数しか使わない．
+  return 0;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(LsimSoa で評価する時のみ使う)
+void
+LsimCodegen::eval_mt(const vector<ymuint64>& iv,
+		     vector<ymuint64>& ov,
+		     vector<ymuint64>& work) const
+{
+  if ( mEvalFunc == NULL ) {
+    LsimSoa::eval_mt(iv, ov, work);
+    return;
+  }
+
+  (*mEvalFunc)(iv.empty() ? NULL : &iv[0], ov.empty() ? NULL : &ov[0]);
+}
+
+// @brief 評価関数の C のコードを生成する．
+// @param[in] bdn 対象のネットワーク
+// @param[in] s 出力先のストリーム
+// @note 生成されるコードはネットリストの構造だけで決まるので
+// ハッシュ値のキーとして用いることができる．
+void
+LsimCodegen::gen_code(const BdnMgr& bdn,
+		      ostream& s)
+{
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+
+  s << "typedef unsigned long long word_t;" << endl
+    << endl
+    << "void" << endl
+    << kFuncName << "(const word_t* ivals," << endl
+    << "          word_t* ovals)" << endl
+    << "{" << endl;
+
+  // 値は全て局所変数 v<ID> に入れる．
+  ymuint input_id = 0;
+  const BdnNodeList& input_list = bdn.input_list();
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ input_id) {
+    const BdnNode* node = *p;
+    s << "  const word_t v" << node->id()
+      << " = ivals[" << input_id << "];" << endl;
+  }
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    s << "  const word_t v" << node->id() << " = ";
+    if ( node->fanin_inv(0) ) {
+      s << "~";
+    }
+    s << "v" << node->fanin(0)->id();
+    if ( node->is_xor() ) {
+      s << " ^ ";
+    }
+    else {
+      s << " & ";
+    }
+    if ( node->fanin_inv(1) ) {
+      s << "~";
+    }
+    s << "v" << node->fanin(1)->id() << ";" << endl;
+  }
+
+  ymuint output_id = 0;
+  const BdnNodeList& output_list = bdn.output_list();
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p, ++ output_id) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    s << "  ovals[" << output_id << "] = ";
+    if ( inode != NULL ) {
+      if ( node->output_fanin_inv() ) {
+	s << "~";
+      }
+      s << "v" << inode->id();
+    }
+    else if ( node->output_fanin_inv() ) {
+      s << "~0ULL";
+    }
+    else {
+      s << "0ULL";
+    }
+    s << ";" << endl;
+  }
+  s << "}" << endl;
+}
+
+// @brief コードをコンパイルしてロードする．
+// @param[in] code C のコード
+// @return 評価関数を返す．
+// @note 失敗した時はエラーメッセージを出力して NULL を返す．
+LsimCodegen::EvalFunc
+LsimCodegen::load_code(const string& code)
+{
+  // コンパイラとオプションもハッシュ値に含める．
+  const char* cc = getenv("CC");
+  if ( cc == NULL || cc[0] == '\0' ) {
+    cc = "cc";
+  }
+  // コマンド行はシェルが解釈するので，パス名は全てクォートする．
+  // 一時ファイルには .c の拡張子がつかないので -x c で言語を指定する．
+  string cmd_prefix = shell_quote_words(cc) + " -O2 -fPIC -shared";
+  ymuint64 h = hash_func(cmd_prefix + "\n" + code);
+
+  unordered_map<ymuint64, EvalFunc>::iterator p = func_cache.find(h);
+  if ( p != func_cache.end() ) {
+    cout << "Kernel cache:     \thit (memory)" << endl;
+    return p->second;
+  }
+
+  // 他のユーザーが共有ライブラリを置けるディレクトリは使わない．
+  if ( mkdir(mCacheDir.c_str(), 0700) != 0 && errno != EEXIST ) {
+    cerr << "Could not create " << mCacheDir << endl;
+    return NULL;
+  }
+  if ( !check_owner(mCacheDir, true) ) {
+    return NULL;
+  }
+
+  string base = mCacheDir + "/lsim_" + hash_str(h);
+  string so_file = base + ".so";
+  if ( file_exists(so_file) ) {
+    cout << "Kernel cache:     \thit (" << so_file << ")" << endl;
+  }
+  else {
+    cout << "Kernel cache:     \tmiss (" << so_file << ")" << endl;
+
+    // 他のプロセスと衝突しないように mkstemp() で作った名前で
+    // コンパイルしてから rename() する．
+    string c_file = base + ".XXXXXX";
+    vector<char> c_buf(c_file.begin(), c_file.end());
+    c_buf.push_back('\0');
+    int fd = mkstemp(&c_buf[0]);
+    if ( fd < 0 ) {
+      cerr << "Could not create " << c_file << endl;
+      return NULL;
+    }
+    c_file = &c_buf[0];
+    string tmp_so_file = c_file + ".so";
+
+    ssize_t n = write(fd, code.data(), code.size());
+    close(fd);
+    if ( n < 0 || static_cast<size_t>(n) != code.size() ) {
+      cerr << "Could not write " << c_file << endl;
+      unlink(c_file.c_str());
+      return NULL;
+    }
+
+    string cmd = cmd_prefix + " -o " + shell_quote(tmp_so_file)
+      + " -x c " + shell_quote(c_file);
+    int status = system(cmd.c_str());
+    unlink(c_file.c_str());
+    if ( status != 0 ) {
+      cerr << "Compilation failed: " << cmd << endl;
+      unlink(tmp_so_file.c_str());
+      return NULL;
+    }
+    // umask によらず自分以外は書き込めないようにしておく．
+    if ( chmod(tmp_so_file.c_str(), 0700) != 0 ) {
+      cerr << "Could not chmod " << tmp_so_file << endl;
+      unlink(tmp_so_file.c_str());
+      return NULL;
+    }
+    if ( rename(tmp_so_file.c_str(), so_file.c_str()) != 0 ) {
+      cerr << "Could not rename " << tmp_so_file << endl;
+      unlink(tmp_so_file.c_str());
+      return NULL;
+    }
+  }
+
+  if ( !check_owner(so_file, false) ) {
+    return NULL;
+  }
+  void* handle = dlopen(so_file.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if ( handle == NULL ) {
+    cerr << "dlopen failed: " << dlerror() << endl;
+    return NULL;
+  }
+  EvalFunc func = reinterpret_cast<EvalFunc>(dlsym(handle, kFuncName));
+  if ( func == NULL ) {
+    cerr << "dlsym failed: " << dlerror() << endl;
+    dlclose(handle);
+    return NULL;
+  }
+  func_cache.insert(make_pair(h, func));
+
+  return func;
+}
+
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimCodegen::node_num() const
+{
+  return mNodeNum;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,172 @@
+﻿#ifndef LSIMCODEGEN_H
+#define LSIMCODEGEN_H
+
+/// @file LsimCodegen.h
+/// @brief LsimCodegen のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimSoa.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimCodegen LsimCodegen.h "LsimCodegen.h"
+/// @brief ネイティブコードを生成する Lsim の実装
+///
+/// LsimLcc と同様にノードごとに1文の C のコードを生成し，
+/// それをシステムのコンパイラで共有ライブラリにして dlopen() する．
+/// コンパイル結果はネットリストのハッシュ値をキーにして
+/// キャッシュディレクトリに保存し，同じネットリストに対しては再利用する．
+/// キャッシュディレクトリと共有ライブラリは自分が所有し，他のユーザーが
+/// 書き込めないものしか用いない．
+/// コンパイラは環境変数 CC で指定する．CC は空白で単語に区切って
+/// 用いる(クォートやエスケープは解釈しない)．
+/// コンパイルやロードに失敗した時は LsimSoa として評価する．
+//////////////////////////////////////////////////////////////////////
+class LsimCodegen :
+  public LsimSoa
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] cache_dir キャッシュディレクトリ
+  /// @note cache_dir が空の時は環境変数 LSIM_CACHE_DIR の値を用いる．
+  /// それもない時は $XDG_CACHE_HOME/lsim，$HOME/.cache/lsim，
+  /// /tmp/lsim_cache-<uid> の順に用いる．
+  explicit
+  LsimCodegen(const string& cache_dir = string());
+
+  /// @brief デストラクタ
+  virtual
+  ~LsimCodegen();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // Lsim の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ネットワークをセットする．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] order_map 順序マップ
+  virtual
+  void
+  set_network(const BdnMgr& bdn,
+	      const unordered_map<string, ymuint>& order_map);
+
+  /// @brief 論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  virtual
+  void
+  eval(const vector<ymuint64>& iv,
+       vector<ymuint64>& ov);
+
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイル用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルに記録する手法名を返す．
+  /// @note 生成したコードは独自にキャッシュするので NULL を返す．
+  virtual
+  const char*
+  image_name() const;
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief eval_mt() で用いる作業領域のサイズを返す．
+  virtual
+  ymuint
+  work_size() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(LsimSoa で評価する時のみ使う)
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる型
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 生成された評価関数の型
+  /// @param[in] ivals 入力値の配列
+  /// @param[out] ovals 出力値の配列
+  typedef void (*EvalFunc)(const ymuint64* ivals,
+			   ymuint64* ovals);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 評価関数の C のコードを生成する．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] s 出力先のストリーム
+  static
+  void
+  gen_code(const BdnMgr& bdn,
+	   ostream& s);
+
+  /// @brief コードをコンパイルしてロードする．
+  /// @param[in] code C のコード
+  /// @return 評価関数を返す．
+  /// @note 失敗した時はエラーメッセージを出力して NULL を返す．
+  EvalFunc
+  load_code(const string& code);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // キャッシュディレクトリ
+  string mCacheDir;
+
+  // 入力数
+  ymuint32 mInputNum;
+
+  // 出力数
+  ymuint32 mOutputNum;
+
+  // 論理ノード数
+  ymuint32 mNodeNum;
+
+  // 評価関数
+  // NULL の時は LsimSoa として評価する．
+  EvalFunc mEvalFunc;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // LSIMCODEGEN_H
@@ -0,0 +1,182 @@
+﻿
+/// @file LsimCompactor.cc
+/// @brief LsimCompactor の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimCompactor.h"
+#include "YmNetworks/BdnNode.h"
+#include "YmNetworks/BdnPort.h"
+#include <cstdio>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// MISR の帰還多項式(x^64 + x^4 + x^3 + x + 1 の x^64 以外)
+const ymuint64 kMisrPoly = 0x1BUL;
+
+// ハッシュ用の乗数
+const ymuint64 kHashMul = 0x9E3779B97F4A7C15UL;
+
+// @brief 値を 16 進数の文字列にする．
+string
+hex_str(ymuint64 val)
+{
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx",
+	   static_cast<unsigned long long>(val));
+  return string(buf);
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimCompactor
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+LsimCompactor::LsimCompactor() :
+  mMisr(true),
+  mPatternNum(0)
+{
+}
+
+// @brief デストラクタ
+LsimCompactor::~LsimCompactor()
+{
+}
+
+// @brief 方式を設定して初期化する．
+// @param[in] mode 方式名("misr" か "hash")
+// @param[in] output_num 出力数
+// @retval true 成功した．
+// @retval false mode が未知の方式だった．
+bool
+LsimCompactor::init(const string& mode,
+		    ymuint output_num)
+{
+  if ( mode == "misr" ) {
+    mMisr = true;
+  }
+  else if ( mode == "hash" ) {
+    mMisr = false;
+  }
+  else {
+    return false;
+  }
+  mMode = mode;
+  mPatternNum = 0;
+  mSigList.clear();
+  mSigList.resize(output_num, 0UL);
+  return true;
+}
+
+// @brief 1ワード分の出力ベクタを足し込む．
+// @param[in] ov 出力ベクタ
+// @param[in] mask 有効なビットを表すマスク
+void
+LsimCompactor::add(const vector<ymuint64>& ov,
+		   ymuint64 mask)
+{
+  ymuint no = mSigList.size();
+  ASSERT_COND( ov.size() == no );
+
+  if ( mMisr ) {
+    for (ymuint i = 0; i < no; ++ i) {
+      ymuint64 sig = mSigList[i];
+      ymuint64 fb = 0UL - (sig >> 63);
+      mSigList[i] = ((sig << 1) ^ (fb & kMisrPoly)) ^ (ov[i] & mask);
+    }
+  }
+  else {
+    for (ymuint i = 0; i < no; ++ i) {
+      ymuint64 sig = (mSigList[i] ^ (ov[i] & mask)) * kHashMul;
+      mSigList[i] = sig ^ (sig >> 29);
+    }
+  }
+
+  for (ymuint64 m = mask; m; m &= m - 1) {
+    ++ mPatternNum;
+  }
+}
+
+// @brief 方式名を返す．
+const string&
+LsimCompactor::mode() const
+{
+  return mMode;
+}
+
+// @brief 足し込んだパタン数を返す．
+ymuint64
+LsimCompactor::pattern_num() const
+{
+  return mPatternNum;
+}
+
+// @brief 出力のシグネチャを返す．
+// @param[in] pos 出力番号
+ymuint64
+LsimCompactor::signature(ymuint pos) const
+{
+  ASSERT_COND( pos < mSigList.size() );
+  return mSigList[pos];
+}
+
+// @brief 全出力のシグネチャをまとめた値を返す．
+ymuint64
+LsimCompactor::total_signature() const
+{
+  // FNV-1a で出力順に混ぜる．
+  ymuint64 h = 14695981039346656037UL;
+  for (vector<ymuint64>::const_iterator p = mSigList.begin();
+       p != mSigList.end(); ++ p) {
+    ymuint64 val = *p;
+    for (ymuint i = 0; i < 8; ++ i) {
+      h ^= (val >> (i * 8)) & 0xFFUL;
+      h *= 1099511628211UL;
+    }
+  }
+  return h;
+}
+
+// @brief 結果をファイルに書き出す．
+// @param[in] filename ファイル名
+// @param[in] network 出力名を得るためのネットワーク
+// @retval true 成功した．
+// @retval false ファイルが書けなかった．
+bool
+LsimCompactor::write(const string& filename,
+		     const BdnMgr& network) const
+{
+  ofstream fs;
+  fs.open(filename.c_str());
+  if ( !fs ) {
+    cerr << "Could not create " << filename << endl;
+    return false;
+  }
+
+  const BdnNodeList& output_list = network.output_list();
+  ASSERT_COND( output_list.size() == mSigList.size() );
+
+  fs << "# " << mMode
+     << " patterns " << mPatternNum
+     << " outputs " << mSigList.size() << endl;
+  ymuint pos = 0;
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    fs << node->port()->name() << " " << hex_str(mSigList[pos]) << endl;
+  }
+  fs << "# total " << hex_str(total_signature()) << endl;
+
+  return static_cast<bool>(fs);
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,110 @@
+﻿#ifndef LSIMCOMPACTOR_H
+#define LSIMCOMPACTOR_H
+
+/// @file LsimCompactor.h
+/// @brief LsimCompactor のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmNetworks/BdnMgr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimCompactor LsimCompactor.h "LsimCompactor.h"
+/// @brief 出力ベクタを出力ごとのシグネチャに圧縮するクラス
+///
+/// 以下の2つの方式がある．
+///  - "misr" 出力ごとに 64 ビットの LFSR (x^64 + x^4 + x^3 + x + 1)
+///           を1ワードごとに1段ずらして出力値を足し込む．
+///  - "hash" 出力ごとに出力値を乗算とシフトで混ぜ合わせる．
+/// どちらもパタンの順序に依存する．無効なビットは 0 とみなす．
+//////////////////////////////////////////////////////////////////////
+class LsimCompactor
+{
+public:
+
+  /// @brief コンストラクタ
+  LsimCompactor();
+
+  /// @brief デストラクタ
+  ~LsimCompactor();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 方式を設定して初期化する．
+  /// @param[in] mode 方式名("misr" か "hash")
+  /// @param[in] output_num 出力数
+  /// @retval true 成功した．
+  /// @retval false mode が未知の方式だった．
+  bool
+  init(const string& mode,
+       ymuint output_num);
+
+  /// @brief 1ワード分の出力ベクタを足し込む．
+  /// @param[in] ov 出力ベクタ
+  /// @param[in] mask 有効なビットを表すマスク
+  void
+  add(const vector<ymuint64>& ov,
+      ymuint64 mask);
+
+  /// @brief 方式名を返す．
+  const string&
+  mode() const;
+
+  /// @brief 足し込んだパタン数を返す．
+  ymuint64
+  pattern_num() const;
+
+  /// @brief 出力のシグネチャを返す．
+  /// @param[in] pos 出力番号
+  ymuint64
+  signature(ymuint pos) const;
+
+  /// @brief 全出力のシグネチャをまとめた値を返す．
+  ymuint64
+  total_signature() const;
+
+  /// @brief 結果をファイルに書き出す．
+  /// @param[in] filename ファイル名
+  /// @param[in] network 出力名を得るためのネットワーク
+  /// @retval true 成功した．
+  /// @retval false ファイルが書けなかった．
+  /// @note 1行目に方式名，パタン数，出力数を書き，以降は1行に
+  /// 1出力ずつ出力名と 16 進数のシグネチャを書く．
+  /// 最後の行は全出力をまとめた値
+  bool
+  write(const string& filename,
+	const BdnMgr& network) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 方式名
+  string mMode;
+
+  // "misr" の時 true
+  bool mMisr;
+
+  // 足し込んだパタン数
+  ymuint64 mPatternNum;
+
+  // 出力ごとのシグネチャ
+  vector<ymuint64> mSigList;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // LSIMCOMPACTOR_H
@@ -0,0 +1,275 @@
+﻿
+/// @file LsimEvent.cc
+/// @brief LsimEvent の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimEvent.h"
+#include "YmNetworks/BdnNode.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+inline
+ymuint64
+inv_mask(bool inv)
+{
+  return inv ? ~0UL : 0UL;
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimEvent
+//////////////////////////////////////////////////////////////////////
+
+const ymuint32 LsimEvent::kNullPos;
+
+// @brief コンストラクタ
+LsimEvent::LsimEvent() :
+  mInputNum(0),
+  mCurLevel(0),
+  mQueueNum(0),
+  mInitialized(false)
+{
+}
+
+// @brief デストラクタ
+LsimEvent::~LsimEvent()
+{
+}
+
+// @brief ネットワークをセットする．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+void
+LsimEvent::set_network(const BdnMgr& bdn,
+		       const unordered_map<string, ymuint>& order_map)
+{
+  // BdnNode の ID 番号から mNodeArray 中の位置を得る配列
+  // 0 は定数0を表す．
+  vector<ymuint32> pos_map(bdn.max_node_id(), 0U);
+
+  const BdnNodeList& input_list = bdn.input_list();
+  mInputNum = input_list.size();
+
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+
+  ymuint nn = mInputNum + node_list.size() + 1;
+  mNodeArray.clear();
+  mNodeArray.resize(nn);
+  for (ymuint i = 0; i < nn; ++ i) {
+    EvNode& node = mNodeArray[i];
+    node.mVal = 0UL;
+    node.mFanins[0] = 0U;
+    node.mFanins[1] = 0U;
+    node.mMasks[0] = 0UL;
+    node.mMasks[1] = 0UL;
+    node.mXor = false;
+    node.mInQueue = false;
+    node.mLevel = 0U;
+    node.mFanoutTop = 0U;
+    node.mFanoutNum = 0U;
+    node.mLink = kNullPos;
+    node.mEvalCount = 0UL;
+    node.mChangeCount = 0UL;
+  }
+
+  ymuint32 pos = 1;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    pos_map[node->id()] = pos;
+  }
+
+  // 論理ノードの情報を設定する．
+  // ついでにレベルとファンアウト数を求める．
+  ymuint max_level = 0;
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    pos_map[node->id()] = pos;
+    EvNode& ev_node = mNodeArray[pos];
+    ymuint level = 0;
+    for (ymuint i = 0; i < 2; ++ i) {
+      ymuint32 ipos = pos_map[node->fanin(i)->id()];
+      EvNode& ev_inode = mNodeArray[ipos];
+      ev_node.mFanins[i] = ipos;
+      ev_node.mMasks[i] = inv_mask(node->fanin_inv(i));
+      ++ ev_inode.mFanoutNum;
+      if ( level < ev_inode.mLevel ) {
+	level = ev_inode.mLevel;
+      }
+    }
+    ++ level;
+    ev_node.mLevel = level;
+    ev_node.mXor = node->is_xor();
+    if ( max_level < level ) {
+      max_level = level;
+    }
+  }
+
+  // ファンアウトの配列を作る．
+  ymuint32 top = 0;
+  for (ymuint i = 0; i < nn; ++ i) {
+    EvNode& node = mNodeArray[i];
+    node.mFanoutTop = top;
+    top += node.mFanoutNum;
+    node.mFanoutNum = 0;
+  }
+  mFanoutArray.clear();
+  mFanoutArray.resize(top);
+  for (ymuint i = mInputNum + 1; i < nn; ++ i) {
+    EvNode& node = mNodeArray[i];
+    for (ymuint j = 0; j < 2; ++ j) {
+      EvNode& inode = mNodeArray[node.mFanins[j]];
+      mFanoutArray[inode.mFanoutTop + inode.mFanoutNum] = i;
+      ++ inode.mFanoutNum;
+    }
+  }
+
+  const BdnNodeList& output_list = bdn.output_list();
+  ymuint no = output_list.size();
+  mOutputPos.clear();
+  mOutputPos.reserve(no);
+  mOutputMask.clear();
+  mOutputMask.reserve(no);
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    ymuint32 pos = 0U;
+    if ( inode != NULL ) {
+      pos = pos_map[inode->id()];
+    }
+    mOutputPos.push_back(pos);
+    mOutputMask.push_back(inv_mask(node->output_fanin_inv()));
+  }
+
+  mQueueHead.clear();
+  mQueueHead.resize(max_level + 1, kNullPos);
+  mCurLevel = 0;
+  mQueueNum = 0;
+  mInitialized = false;
+
+  cout << "Node num:  " << node_num() << endl
+       << "Level num: " << max_level << endl;
+}
+
+// @brief 論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+void
+LsimEvent::eval(const vector<ymuint64>& iv,
+		vector<ymuint64>& ov)
+{
+  ymuint ni = mInputNum;
+  ASSERT_COND( ni == iv.size() );
+
+  if ( mInitialized ) {
+    // 値の変わった入力のファンアウトだけをキューに積む．
+    for (ymuint i = 0; i < ni; ++ i) {
+      EvNode& node = mNodeArray[i + 1];
+      if ( node.mVal != iv[i] ) {
+	node.mVal = iv[i];
+	put_fanouts(node);
+      }
+    }
+
+    for ( ; ; ) {
+      ymuint32 pos = get();
+      if ( pos == kNullPos ) {
+	break;
+      }
+      EvNode& node = mNodeArray[pos];
+      ymuint64 val = calc_val(node);
+      ++ node.mEvalCount;
+      if ( node.mVal != val ) {
+	node.mVal = val;
+	++ node.mChangeCount;
+	put_fanouts(node);
+      }
+    }
+  }
+  else {
+    // 最初の1回は全てのノードを評価する．
+    for (ymuint i = 0; i < ni; ++ i) {
+      mNodeArray[i + 1].mVal = iv[i];
+    }
+    ymuint nn = mNodeArray.size();
+    for (ymuint i = ni + 1; i < nn; ++ i) {
+      EvNode& node = mNodeArray[i];
+      node.mVal = calc_val(node);
+      ++ node.mEvalCount;
+    }
+    mInitialized = true;
+  }
+
+  ymuint no = mOutputPos.size();
+  for (ymuint i = 0; i < no; ++ i) {
+    ov[i] = mNodeArray[mOutputPos[i]].mVal ^ mOutputMask[i];
+  }
+}
+
+// @brief 評価に用いるノード数を返す．
+// @note 論理ノード数を返す．
+ymuint
+LsimEvent::node_num() const
+{
+  return mNodeArray.size() - mInputNum - 1;
+}
+
+// @brief 論理ノードの評価回数の総和を返す．
+ymuint64
+LsimEvent::total_eval_count() const
+{
+  ymuint64 n = 0;
+  ymuint nn = mNodeArray.size();
+  for (ymuint i = mInputNum + 1; i < nn; ++ i) {
+    n += mNodeArray[i].mEvalCount;
+  }
+  return n;
+}
+
+// @brief 論理ノードの値の変化回数の総和を返す．
+ymuint64
+LsimEvent::total_change_count() const
+{
+  ymuint64 n = 0;
+  ymuint nn = mNodeArray.size();
+  for (ymuint i = mInputNum + 1; i < nn; ++ i) {
+    n += mNodeArray[i].mChangeCount;
+  }
+  return n;
+}
+
+// @brief 活性度の情報をクリアする．
+void
+LsimEvent::clear_count()
+{
+  for (vector<EvNode>::iterator p = mNodeArray.begin();
+       p != mNodeArray.end(); ++ p) {
+    EvNode& node = *p;
+    node.mEvalCount = 0UL;
+    node.mChangeCount = 0UL;
+  }
+}
+
+// @brief ノードのファンアウトをキューに積む．
+void
+LsimEvent::put_fanouts(const EvNode& node)
+{
+  ymuint end = node.mFanoutTop + node.mFanoutNum;
+  for (ymuint i = node.mFanoutTop; i < end; ++ i) {
+    put(mFanoutArray[i]);
+  }
+}
+
+END_NAMESPACE_YM
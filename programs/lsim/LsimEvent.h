@@ -0,0 +1,277 @@
+﻿#ifndef LSIMEVENT_H
+#define LSIMEVENT_H
+
+/// @file LsimEvent.h
+/// @brief LsimEvent のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Lsim.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimEvent LsimEvent.h "LsimEvent.h"
+/// @brief イベントドリブン型の Lsim の実装
+///
+/// 前回の eval() から値の変わった入力からだけイベントを伝搬させる．
+/// イベントキューはレベルごとのリストで，レベルの小さい順に処理する．
+//////////////////////////////////////////////////////////////////////
+class LsimEvent :
+  public Lsim
+{
+public:
+
+  /// @brief コンストラクタ
+  LsimEvent();
+
+  /// @brief デストラクタ
+  virtual
+  ~LsimEvent();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // Lsim の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ネットワークをセットする．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] order_map 順序マップ
+  virtual
+  void
+  set_network(const BdnMgr& bdn,
+	      const unordered_map<string, ymuint>& order_map);
+
+  /// @brief 論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  virtual
+  void
+  eval(const vector<ymuint64>& iv,
+       vector<ymuint64>& ov);
+
+  /// @brief 評価に用いるノード数を返す．
+  /// @note 論理ノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 活性度に関する情報を得る関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 論理ノードの評価回数の総和を返す．
+  ymuint64
+  total_eval_count() const;
+
+  /// @brief 論理ノードの値の変化回数の総和を返す．
+  ymuint64
+  total_change_count() const;
+
+  /// @brief 論理ノードの評価回数を返す．
+  /// @param[in] pos 位置番号 ( 0 <= pos < node_num() )
+  ymuint64
+  eval_count(ymuint pos) const;
+
+  /// @brief 論理ノードの値の変化回数を返す．
+  /// @param[in] pos 位置番号 ( 0 <= pos < node_num() )
+  ymuint64
+  change_count(ymuint pos) const;
+
+  /// @brief 活性度の情報をクリアする．
+  void
+  clear_count();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  struct EvNode
+  {
+    // 値
+    ymuint64 mVal;
+
+    // ファンインの位置
+    ymuint32 mFanins[2];
+
+    // ファンインの極性を表すマスク
+    ymuint64 mMasks[2];
+
+    // XOR の時 true
+    bool mXor;
+
+    // キューに入っている時 true
+    bool mInQueue;
+
+    // レベル
+    ymuint32 mLevel;
+
+    // mFanoutArray 中のファンアウトの先頭位置
+    ymuint32 mFanoutTop;
+
+    // ファンアウト数
+    ymuint32 mFanoutNum;
+
+    // キュー中の次の要素
+    ymuint32 mLink;
+
+    // 評価回数
+    ymuint64 mEvalCount;
+
+    // 値の変化回数
+    ymuint64 mChangeCount;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ノードのファンアウトをキューに積む．
+  void
+  put_fanouts(const EvNode& node);
+
+  /// @brief キューに積む．
+  void
+  put(ymuint32 pos);
+
+  /// @brief キューから取り出す．
+  /// @retval kNullPos キューが空だった．
+  ymuint32
+  get();
+
+  /// @brief ノードの値を計算する．
+  ymuint64
+  calc_val(const EvNode& node) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 入力数
+  ymuint32 mInputNum;
+
+  // ノードの配列
+  // 先頭は定数0で，入力，論理ノードの順に並んでいる．
+  vector<EvNode> mNodeArray;
+
+  // ファンアウトの位置の配列
+  vector<ymuint32> mFanoutArray;
+
+  // 出力の位置
+  vector<ymuint32> mOutputPos;
+
+  // 出力の極性を表すマスク
+  vector<ymuint64> mOutputMask;
+
+  // レベルごとのキューの先頭
+  vector<ymuint32> mQueueHead;
+
+  // キューの現在のレベル
+  ymuint32 mCurLevel;
+
+  // キューに入っている要素数
+  ymuint32 mQueueNum;
+
+  // 一度でも eval() を行ったら true
+  bool mInitialized;
+
+  // 空を表す位置
+  static
+  const ymuint32 kNullPos = 0xFFFFFFFFU;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 論理ノードの評価回数を返す．
+// @param[in] pos 位置番号 ( 0 <= pos < node_num() )
+inline
+ymuint64
+LsimEvent::eval_count(ymuint pos) const
+{
+  return mNodeArray[pos + mInputNum + 1].mEvalCount;
+}
+
+// @brief 論理ノードの値の変化回数を返す．
+// @param[in] pos 位置番号 ( 0 <= pos < node_num() )
+inline
+ymuint64
+LsimEvent::change_count(ymuint pos) const
+{
+  return mNodeArray[pos + mInputNum + 1].mChangeCount;
+}
+
+// @brief キューに積む．
+inline
+void
+LsimEvent::put(ymuint32 pos)
+{
+  EvNode& node = mNodeArray[pos];
+  if ( !node.mInQueue ) {
+    node.mInQueue = true;
+    ymuint32 level = node.mLevel;
+    node.mLink = mQueueHead[level];
+    mQueueHead[level] = pos;
+    if ( mQueueNum == 0 || mCurLevel > level ) {
+      mCurLevel = level;
+    }
+    ++ mQueueNum;
+  }
+}
+
+// @brief キューから取り出す．
+// @retval kNullPos キューが空だった．
+inline
+ymuint32
+LsimEvent::get()
+{
+  if ( mQueueNum > 0 ) {
+    // mQueueNum が正しければ mCurLevel がオーバーフローすることはない．
+    for ( ; ; ++ mCurLevel) {
+      ymuint32 pos = mQueueHead[mCurLevel];
+      if ( pos != kNullPos ) {
+	EvNode& node = mNodeArray[pos];
+	node.mInQueue = false;
+	mQueueHead[mCurLevel] = node.mLink;
+	-- mQueueNum;
+	return pos;
+      }
+    }
+  }
+  return kNullPos;
+}
+
+// @brief ノードの値を計算する．
+inline
+ymuint64
+LsimEvent::calc_val(const EvNode& node) const
+{
+  ymuint64 val0 = mNodeArray[node.mFanins[0]].mVal ^ node.mMasks[0];
+  ymuint64 val1 = mNodeArray[node.mFanins[1]].mVal ^ node.mMasks[1];
+  if ( node.mXor ) {
+    return val0 ^ val1;
+  }
+  else {
+    return val0 & val1;
+  }
+}
+
+END_NAMESPACE_YM
+
+#endif // LSIMEVENT_H
@@ -0,0 +1,482 @@
+﻿
+/// @file LsimHybrid.cc
+/// @brief LsimHybrid の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimHybrid.h"
+#include "LsimImage.h"
+#include "YmNetworks/BdnNode.h"
+#include "YmNetworks/BdnPort.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// @brief 位置と極性から値を得る．
+inline
+ymuint64
+code_val(const ymuint64* val_array,
+	 ymuint32 code)
+{
+  ymuint64 mask = 0UL - static_cast<ymuint64>(code & 1U);
+  return val_array[code >> 1] ^ mask;
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimHybrid
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] budget 1つのノードの BDD のノード数の上限
+LsimHybrid::LsimHybrid(ymuint budget) :
+  mBddMgr("bmc", "Bdd Manager"),
+  mBudget(budget),
+  mInputNum(0),
+  mMpxOutputNum(0)
+{
+}
+
+// @brief デストラクタ
+LsimHybrid::~LsimHybrid()
+{
+}
+
+// @brief ネットワークをセットする．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+void
+LsimHybrid::set_network(const BdnMgr& bdn,
+			const unordered_map<string, ymuint>& order_map)
+{
+  const BdnNodeList& input_list = bdn.input_list();
+  ymuint ni = input_list.size();
+  mInputNum = ni;
+
+  // 入力ごとの変数番号と変数番号から入力番号を得る配列を作る．
+  vector<ymuint32> input_var(ni);
+  vector<ymuint32> var_input(ni);
+  if ( order_map.empty() ) {
+    for (ymuint i = 0; i < ni; ++ i) {
+      input_var[i] = i;
+      var_input[i] = i;
+    }
+  }
+  else {
+    ymuint i = 0;
+    for (BdnNodeList::const_iterator p = input_list.begin();
+	 p != input_list.end(); ++ p, ++ i) {
+      const BdnNode* node = *p;
+      string name = node->port()->name();
+      unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
+      if ( q == order_map.end() ) {
+	cerr << "No map for " << name << endl;
+	abort();
+      }
+      ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      input_var[i] = id;
+      var_input[id] = i;
+    }
+  }
+
+  ymuint n = bdn.max_node_id();
+
+  // BdnNode の ID 番号から値の位置を得る配列
+  vector<ymuint32> pos_map(n, 0U);
+
+  // BDD を上限つきで作る．
+  // 上限を超えたノードとその推移的ファンアウトは BDD を持たない．
+  vector<Bdd> bddmap(n);
+  vector<bool> has_bdd(n, false);
+  ymuint i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    bddmap[node->id()] = mBddMgr.make_posiliteral(VarId(input_var[i]));
+    has_bdd[node->id()] = true;
+    pos_map[node->id()] = i + 1;
+  }
+
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+  for (vector<const BdnNode*>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* fanin0 = node->fanin0();
+    const BdnNode* fanin1 = node->fanin1();
+    if ( !has_bdd[fanin0->id()] || !has_bdd[fanin1->id()] ) {
+      continue;
+    }
+    Bdd bdd0 = bddmap[fanin0->id()];
+    if ( node->fanin0_inv() ) {
+      bdd0 = ~bdd0;
+    }
+    Bdd bdd1 = bddmap[fanin1->id()];
+    if ( node->fanin1_inv() ) {
+      bdd1 = ~bdd1;
+    }
+    Bdd bdd;
+    if ( node->is_xor() ) {
+      bdd = bdd0 ^ bdd1;
+    }
+    else {
+      bdd = bdd0 & bdd1;
+    }
+    if ( bdd.size() <= mBudget ) {
+      bddmap[node->id()] = bdd;
+      has_bdd[node->id()] = true;
+    }
+  }
+
+  // BDD を持たない出力のファンインコーンに印をつける．
+  const BdnNodeList& output_list = bdn.output_list();
+  vector<bool> mark(n, false);
+  vector<const BdnNode*> stack;
+  mMpxOutputNum = 0;
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* inode = (*p)->output_fanin();
+    if ( inode == NULL || has_bdd[inode->id()] ) {
+      ++ mMpxOutputNum;
+      continue;
+    }
+    stack.push_back(inode);
+    while ( !stack.empty() ) {
+      const BdnNode* node = stack.back();
+      stack.pop_back();
+      if ( mark[node->id()] || node->is_input() ) {
+	continue;
+      }
+      mark[node->id()] = true;
+      stack.push_back(node->fanin0());
+      stack.push_back(node->fanin1());
+    }
+  }
+
+  // 印のついたノードをトポロジカル順にゲートとして並べる．
+  mGateFanin0.clear();
+  mGateFanin1.clear();
+  mGateXor.clear();
+  for (vector<const BdnNode*>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    if ( !mark[node->id()] ) {
+      continue;
+    }
+    pos_map[node->id()] = ni + 1 + mGateFanin0.size();
+    const BdnNode* fanin0 = node->fanin0();
+    const BdnNode* fanin1 = node->fanin1();
+    mGateFanin0.push_back((pos_map[fanin0->id()] << 1) | node->fanin0_inv());
+    mGateFanin1.push_back((pos_map[fanin1->id()] << 1) | node->fanin1_inv());
+    mGateXor.push_back(node->is_xor() ? 1U : 0U);
+  }
+
+  // 入力とゲートの BDD はそれらの値を用いる．
+  unordered_map<Bdd, ymuint32> code_map;
+  i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    code_map.insert(make_pair(bddmap[node->id()], (i + 1) << 1));
+  }
+  for (vector<const BdnNode*>::const_iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    if ( mark[node->id()] && has_bdd[node->id()] ) {
+      code_map.insert(make_pair(bddmap[node->id()],
+				pos_map[node->id()] << 1));
+    }
+  }
+
+  mMpxSel.clear();
+  mMpxFanin0.clear();
+  mMpxFanin1.clear();
+  mOutputList.clear();
+  mOutputList.reserve(output_list.size());
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    ymuint32 code = 0U;
+    if ( inode == NULL ) {
+      code = 0U;
+    }
+    else if ( mark[inode->id()] ) {
+      code = pos_map[inode->id()] << 1;
+    }
+    else {
+      code = make_mpx(bddmap[inode->id()], var_input, code_map);
+    }
+    if ( node->output_fanin_inv() ) {
+      code ^= 1U;
+    }
+    mOutputList.push_back(code);
+  }
+
+  mValArray.clear();
+  mValArray.resize(work_size(), 0UL);
+
+  cout << "Gate num:         \t" << gate_num() << endl
+       << "MPX num:          \t" << mpx_num() << endl
+       << "MPX outputs:      \t" << mMpxOutputNum
+       << " / " << mOutputList.size() << endl;
+}
+
+// @brief BDD からセレクタ回路を作る．
+// @param[in] bdd 対象の BDD
+// @param[in] var_input 変数番号から入力番号を得る配列
+// @param[inout] code_map BDD から値の位置と極性を得るマップ
+// @return bdd の値の位置と極性を返す．
+ymuint32
+LsimHybrid::make_mpx(Bdd bdd,
+		     const vector<ymuint32>& var_input,
+		     unordered_map<Bdd, ymuint32>& code_map)
+{
+  if ( bdd.is_zero() ) {
+    return 0U;
+  }
+  if ( bdd.is_one() ) {
+    return 1U;
+  }
+
+  unordered_map<Bdd, ymuint32>::iterator p = code_map.find(bdd);
+  if ( p != code_map.end() ) {
+    return p->second;
+  }
+  p = code_map.find(~bdd);
+  if ( p != code_map.end() ) {
+    return p->second ^ 1U;
+  }
+
+  Bdd bdd0;
+  Bdd bdd1;
+  VarId varid = bdd.root_decomp(bdd0, bdd1);
+  ymuint32 code0 = make_mpx(bdd0, var_input, code_map);
+  ymuint32 code1 = make_mpx(bdd1, var_input, code_map);
+
+  ymuint32 pos = mInputNum + 1 + mGateFanin0.size() + mMpxSel.size();
+  mMpxSel.push_back(var_input[varid.val()] + 1);
+  mMpxFanin0.push_back(code0);
+  mMpxFanin1.push_back(code1);
+
+  ymuint32 code = pos << 1;
+  code_map.insert(make_pair(bdd, code));
+  return code;
+}
+
+// @brief 論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+void
+LsimHybrid::eval(const vector<ymuint64>& iv,
+		 vector<ymuint64>& ov)
+{
+  eval_mt(iv, ov, mValArray);
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimHybrid::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+ymuint
+LsimHybrid::work_size() const
+{
+  return mInputNum + 1 + mGateFanin0.size() + mMpxSel.size();
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(値の配列)
+void
+LsimHybrid::eval_mt(const vector<ymuint64>& iv,
+		    vector<ymuint64>& ov,
+		    vector<ymuint64>& work) const
+{
+  ymuint ni = mInputNum;
+  ASSERT_COND( ni == iv.size() );
+
+  ymuint64* val_array = &work[0];
+  val_array[0] = 0UL;
+  for (ymuint i = 0; i < ni; ++ i) {
+    val_array[i + 1] = iv[i];
+  }
+
+  // ゲートレベルの評価
+  ymuint64* dst = val_array + ni + 1;
+  ymuint ng = mGateFanin0.size();
+  for (ymuint i = 0; i < ng; ++ i) {
+    ymuint64 val0 = code_val(val_array, mGateFanin0[i]);
+    ymuint64 val1 = code_val(val_array, mGateFanin1[i]);
+    if ( mGateXor[i] ) {
+      dst[i] = val0 ^ val1;
+    }
+    else {
+      dst[i] = val0 & val1;
+    }
+  }
+
+  // セレクタ回路の評価
+  dst += ng;
+  ymuint nm = mMpxSel.size();
+  for (ymuint i = 0; i < nm; ++ i) {
+    ymuint64 c_val = val_array[mMpxSel[i]];
+    ymuint64 val0 = code_val(val_array, mMpxFanin0[i]);
+    ymuint64 val1 = code_val(val_array, mMpxFanin1[i]);
+    dst[i] = (c_val & val1) | (~c_val & val0);
+  }
+
+  ymuint no = mOutputList.size();
+  for (ymuint i = 0; i < no; ++ i) {
+    ov[i] = code_val(val_array, mOutputList[i]);
+  }
+}
+
+// @brief 評価に用いるノード数を返す．
+// @note ゲートレベルのノード数と MPX ノード数の和を返す．
+ymuint
+LsimHybrid::node_num() const
+{
+  return gate_num() + mpx_num();
+}
+
+// @brief ゲートレベルで評価するノード数を返す．
+ymuint
+LsimHybrid::gate_num() const
+{
+  return mGateFanin0.size();
+}
+
+// @brief MPX ノード数を返す．
+ymuint
+LsimHybrid::mpx_num() const
+{
+  return mMpxSel.size();
+}
+
+// @brief MPX で評価する出力数を返す．
+ymuint
+LsimHybrid::mpx_output_num() const
+{
+  return mMpxOutputNum;
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+const char*
+LsimHybrid::image_name() const
+{
+  return "hybrid";
+}
+
+// @brief イメージファイルの形式のバージョンを返す．
+ymuint32
+LsimHybrid::image_version() const
+{
+  return 1;
+}
+
+// @brief set_network() で作った内容をイメージファイルに書き出す．
+// @param[in] writer 書き出し用のオブジェクト
+// @note 結果は mBudget によって変わるのでそれも書いておく．
+void
+LsimHybrid::write_image(LsimImageWriter& writer) const
+{
+  writer.write_64(mBudget);
+  writer.write_64(mInputNum);
+  writer.write_64(mMpxOutputNum);
+  writer.write_array(mGateFanin0);
+  writer.write_array(mGateFanin1);
+  writer.write_array(mGateXor);
+  writer.write_array(mMpxSel);
+  writer.write_array(mMpxFanin0);
+  writer.write_array(mMpxFanin1);
+  writer.write_array(mOutputList);
+}
+
+// @brief イメージファイルの内容を読み込む．
+// @param[in] reader 読み込み用のオブジェクト
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+bool
+LsimHybrid::read_image(LsimImageReader& reader)
+{
+  ymuint64 budget;
+  ymuint64 ni;
+  ymuint64 nmo;
+  if ( !reader.read_64(budget) || budget != mBudget ) {
+    return false;
+  }
+  if ( !reader.read_64(ni) ||
+       !reader.read_64(nmo) ||
+       !reader.read_array(mGateFanin0) ||
+       !reader.read_array(mGateFanin1) ||
+       !reader.read_array(mGateXor) ||
+       !reader.read_array(mMpxSel) ||
+       !reader.read_array(mMpxFanin0) ||
+       !reader.read_array(mMpxFanin1) ||
+       !reader.read_array(mOutputList) ) {
+    return false;
+  }
+  ymuint ng = mGateFanin0.size();
+  ymuint nm = mMpxSel.size();
+  if ( mGateFanin1.size() != ng ||
+       mGateXor.size() != ng ||
+       mMpxFanin0.size() != nm ||
+       mMpxFanin1.size() != nm ||
+       nmo > mOutputList.size() ) {
+    return false;
+  }
+
+  // ファイルが壊れていても範囲外を参照しないように番号を確かめる．
+  // 値の配列の位置は符号の上位ビットなので ymuint32 の半分までしか使えない．
+  if ( ni > 0x7FFFFFFFUL ) {
+    return false;
+  }
+  ymuint64 nv = ni + 1 + ng + nm;
+  if ( nv > 0x7FFFFFFFUL ) {
+    return false;
+  }
+  for (ymuint i = 0; i < ng; ++ i) {
+    if ( (mGateFanin0[i] >> 1) >= nv || (mGateFanin1[i] >> 1) >= nv ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < nm; ++ i) {
+    if ( mMpxSel[i] >= nv ||
+	 (mMpxFanin0[i] >> 1) >= nv ||
+	 (mMpxFanin1[i] >> 1) >= nv ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < mOutputList.size(); ++ i) {
+    if ( (mOutputList[i] >> 1) >= nv ) {
+      return false;
+    }
+  }
+
+  mInputNum = ni;
+  mMpxOutputNum = nmo;
+  mValArray.clear();
+  mValArray.resize(work_size(), 0UL);
+
+  cout << "Gate num:         \t" << gate_num() << endl
+       << "MPX num:          \t" << mpx_num() << endl
+       << "MPX outputs:      \t" << mMpxOutputNum
+       << " / " << mOutputList.size() << endl;
+
+  return true;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,211 @@
+﻿#ifndef LSIMHYBRID_H
+#define LSIMHYBRID_H
+
+/// @file LsimHybrid.h
+/// @brief LsimHybrid のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Lsim.h"
+#include "YmLogic/Bdd.h"
+#include "YmLogic/BddMgr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimHybrid LsimHybrid.h "LsimHybrid.h"
+/// @brief MPX とゲートレベルの評価を組み合わせた Lsim の実装
+///
+/// 各ノードの BDD をノード数の上限つきで作り，BDD が上限以内に
+/// 収まった出力は LsimMpx と同様のセレクタ回路で評価し，
+/// それ以外の出力はそのファンインコーンをゲートごとに評価する．
+/// 値は1つの配列に入れるので，セレクタ回路の途中の関数が
+/// ゲートレベルで評価するノードと等しい時はその値を共有する．
+//////////////////////////////////////////////////////////////////////
+class LsimHybrid :
+  public Lsim
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] budget 1つのノードの BDD のノード数の上限
+  explicit
+  LsimHybrid(ymuint budget = 256);
+
+  /// @brief デストラクタ
+  virtual
+  ~LsimHybrid();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // Lsim の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ネットワークをセットする．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] order_map 順序マップ
+  virtual
+  void
+  set_network(const BdnMgr& bdn,
+	      const unordered_map<string, ymuint>& order_map);
+
+  /// @brief 論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  virtual
+  void
+  eval(const vector<ymuint64>& iv,
+       vector<ymuint64>& ov);
+
+  /// @brief 評価に用いるノード数を返す．
+  /// @note ゲートレベルのノード数と MPX ノード数の和を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 分割結果の情報を返す関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ゲートレベルで評価するノード数を返す．
+  ymuint
+  gate_num() const;
+
+  /// @brief MPX ノード数を返す．
+  ymuint
+  mpx_num() const;
+
+  /// @brief MPX で評価する出力数を返す．
+  ymuint
+  mpx_output_num() const;
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイル用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルに記録する手法名を返す．
+  virtual
+  const char*
+  image_name() const;
+
+  /// @brief イメージファイルの形式のバージョンを返す．
+  virtual
+  ymuint32
+  image_version() const;
+
+  /// @brief set_network() で作った内容をイメージファイルに書き出す．
+  /// @param[in] writer 書き出し用のオブジェクト
+  virtual
+  void
+  write_image(LsimImageWriter& writer) const;
+
+  /// @brief イメージファイルの内容を読み込む．
+  /// @param[in] reader 読み込み用のオブジェクト
+  /// @retval true 読み込みが成功した．
+  /// @retval false 読み込みが失敗した．
+  virtual
+  bool
+  read_image(LsimImageReader& reader);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief eval_mt() で用いる作業領域のサイズを返す．
+  virtual
+  ymuint
+  work_size() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(値の配列)
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief BDD からセレクタ回路を作る．
+  /// @param[in] bdd 対象の BDD
+  /// @param[in] var_input 変数番号から入力番号を得る配列
+  /// @param[inout] code_map BDD から値の位置と極性を得るマップ
+  /// @return bdd の値の位置と極性を返す．
+  ymuint32
+  make_mpx(Bdd bdd,
+	   const vector<ymuint32>& var_input,
+	   unordered_map<Bdd, ymuint32>& code_map);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // BDD の管理用オブジェクト
+  BddMgr mBddMgr;
+
+  // 1つのノードの BDD のノード数の上限
+  ymuint32 mBudget;
+
+  // 入力数
+  ymuint32 mInputNum;
+
+  // 値の位置と極性は (位置 * 2 + 極性) で表す．
+  // 位置 0 は定数0，1 〜 mInputNum は入力，その後にゲート，
+  // MPX ノードの順に並ぶ．
+
+  // ゲートのファンイン0
+  vector<ymuint32> mGateFanin0;
+
+  // ゲートのファンイン1
+  vector<ymuint32> mGateFanin1;
+
+  // ゲートが XOR の時 1
+  vector<ymuint32> mGateXor;
+
+  // MPX ノードの制御入力の位置
+  vector<ymuint32> mMpxSel;
+
+  // MPX ノードの制御入力が 0 の時のファンイン
+  vector<ymuint32> mMpxFanin0;
+
+  // MPX ノードの制御入力が 1 の時のファンイン
+  vector<ymuint32> mMpxFanin1;
+
+  // 出力
+  vector<ymuint32> mOutputList;
+
+  // MPX で評価する出力数
+  ymuint32 mMpxOutputNum;
+
+  // eval() 用の値の配列
+  vector<ymuint64> mValArray;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // LSIMHYBRID_H
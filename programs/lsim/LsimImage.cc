@@ -0,0 +1,479 @@
+﻿
+/// @file LsimImage.cc
+/// @brief LsimImageWriter, LsimImageReader の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimImage.h"
+#include "YmNetworks/BdnNode.h"
+#include "YmNetworks/BdnPort.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 識別子
+const ymuint32 kImageMagic = 0x4D49534CU; // "LSIM"
+
+// ファイル形式のバージョン
+const ymuint32 kImageVersion = 1;
+
+// 手法名の最大長
+const ymuint kNameSize = 16;
+
+// ヘッダのサイズ
+const ymuint kHeaderSize = 40;
+
+// 埋め草
+const char kPadding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+// @brief size を8の倍数に切り上げた時の差分を返す．
+inline
+ymuint64
+pad_size(ymuint64 size)
+{
+  return (8 - (size & 7UL)) & 7UL;
+}
+
+// @brief ハッシュ値に値を混ぜる(FNV-1a)．
+inline
+void
+hash_val(ymuint64& h,
+	 ymuint64 val)
+{
+  for (ymuint i = 0; i < 8; ++ i) {
+    h ^= (val >> (i * 8)) & 0xFFUL;
+    h *= 1099511628211UL;
+  }
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimImageWriter
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+LsimImageWriter::LsimImageWriter()
+{
+}
+
+// @brief デストラクタ
+// @note close() されていない時は一時ファイルを削除する．
+LsimImageWriter::~LsimImageWriter()
+{
+  if ( mStream.is_open() ) {
+    mStream.close();
+    unlink(mTmpFilename.c_str());
+  }
+}
+
+// @brief ファイルを開いてヘッダを書く．
+// @param[in] filename ファイル名
+// @param[in] name 手法名
+// @param[in] version 手法ごとのバージョン
+// @param[in] signature ネットワークのシグネチャ
+// @retval true 成功した．
+// @retval false 失敗した．
+bool
+LsimImageWriter::open(const string& filename,
+		      const char* name,
+		      ymuint32 version,
+		      ymuint64 signature)
+{
+  ASSERT_COND( !mStream.is_open() );
+  ASSERT_COND( strlen(name) < kNameSize );
+
+  // 他のプロセスと衝突しないようにプロセス番号付きの名前で作る．
+  ostringstream buf;
+  buf << filename << "." << getpid();
+  mFilename = filename;
+  mTmpFilename = buf.str();
+  mStream.open(mTmpFilename.c_str(), ios::out | ios::binary);
+  if ( !mStream ) {
+    return false;
+  }
+
+  char name_buf[kNameSize];
+  memset(name_buf, 0, kNameSize);
+  strcpy(name_buf, name);
+
+  write_32(kImageMagic);
+  write_32(kImageVersion);
+  write_data(name_buf, kNameSize);
+  write_32(version);
+  write_32(0U);
+  write_64(signature);
+
+  return static_cast<bool>(mStream);
+}
+
+// @brief 32ビットの値を書く．
+// @note 配列の境界がずれないようにヘッダでのみ用いる．
+void
+LsimImageWriter::write_32(ymuint32 val)
+{
+  write_data(&val, sizeof(val));
+}
+
+// @brief 64ビットの値を書く．
+void
+LsimImageWriter::write_64(ymuint64 val)
+{
+  write_data(&val, sizeof(val));
+}
+
+// @brief ymuint32 の配列を書く．
+void
+LsimImageWriter::write_array(const vector<ymuint32>& array)
+{
+  ymuint64 n = array.size();
+  write_array(n > 0 ? &array[0] : NULL, n);
+}
+
+// @brief ymuint32 の配列を書く．
+// @param[in] array 配列の先頭
+// @param[in] n 要素数
+void
+LsimImageWriter::write_array(const ymuint32* array,
+			     ymuint64 n)
+{
+  write_64(n);
+  ymuint64 size = n * sizeof(ymuint32);
+  write_data(array, size);
+  write_data(kPadding, pad_size(size));
+}
+
+// @brief ymuint64 の配列を書く．
+void
+LsimImageWriter::write_array(const vector<ymuint64>& array)
+{
+  ymuint64 n = array.size();
+  write_64(n);
+  if ( n > 0 ) {
+    write_data(&array[0], n * sizeof(ymuint64));
+  }
+}
+
+// @brief ファイルを閉じる．
+// @retval true 全ての書き込みが成功した．
+// @retval false 失敗した．
+bool
+LsimImageWriter::close()
+{
+  if ( !mStream.is_open() ) {
+    return false;
+  }
+  bool stat = static_cast<bool>(mStream);
+  mStream.close();
+  if ( stat && rename(mTmpFilename.c_str(), mFilename.c_str()) == 0 ) {
+    return true;
+  }
+  unlink(mTmpFilename.c_str());
+  return false;
+}
+
+// @brief データを書く．
+void
+LsimImageWriter::write_data(const void* data,
+			    ymuint64 size)
+{
+  if ( size > 0 ) {
+    mStream.write(reinterpret_cast<const char*>(data), size);
+  }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimImageReader
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+LsimImageReader::LsimImageReader() :
+  mTop(NULL),
+  mSize(0),
+  mPos(0),
+  mSignature(0UL)
+{
+}
+
+// @brief デストラクタ
+LsimImageReader::~LsimImageReader()
+{
+  close();
+}
+
+// @brief ファイルを開いてヘッダを読む．
+// @param[in] filename ファイル名
+// @param[in] name 手法名
+// @param[in] version 手法ごとのバージョン
+// @retval true 成功した．
+// @retval false ファイルが読めないかヘッダが一致しなかった．
+bool
+LsimImageReader::open(const string& filename,
+		      const char* name,
+		      ymuint32 version)
+{
+  close();
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if ( fd < 0 ) {
+    return false;
+  }
+  struct stat sbuf;
+  if ( fstat(fd, &sbuf) != 0 || sbuf.st_size < kHeaderSize ) {
+    ::close(fd);
+    return false;
+  }
+  void* top = mmap(NULL, sbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // 写像した後はファイルを閉じてもよい．
+  ::close(fd);
+  if ( top == MAP_FAILED ) {
+    return false;
+  }
+  mTop = reinterpret_cast<char*>(top);
+  mSize = sbuf.st_size;
+  mPos = 0;
+
+  ymuint32 magic;
+  ymuint32 format_version;
+  char name_buf[kNameSize];
+  ymuint32 version1;
+  ymuint32 dummy;
+  read_32(magic);
+  read_32(format_version);
+  read_data(name_buf, kNameSize);
+  read_32(version1);
+  read_32(dummy);
+  read_64(mSignature);
+  if ( magic != kImageMagic ||
+       format_version != kImageVersion ||
+       strncmp(name_buf, name, kNameSize) != 0 ||
+       version1 != version ) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+// @brief ファイルを閉じる．
+void
+LsimImageReader::close()
+{
+  if ( mTop != NULL ) {
+    munmap(mTop, mSize);
+    mTop = NULL;
+  }
+  mSize = 0;
+  mPos = 0;
+  mSignature = 0UL;
+}
+
+// @brief ヘッダに書かれていたシグネチャを返す．
+ymuint64
+LsimImageReader::signature() const
+{
+  return mSignature;
+}
+
+// @brief 32ビットの値を読む．
+// @note ヘッダでのみ用いる．
+bool
+LsimImageReader::read_32(ymuint32& val)
+{
+  return read_data(&val, sizeof(val));
+}
+
+// @brief 64ビットの値を読む．
+// @retval true 成功した．
+// @retval false ファイルの末尾を越えた．
+bool
+LsimImageReader::read_64(ymuint64& val)
+{
+  return read_data(&val, sizeof(val));
+}
+
+// @brief ymuint32 の配列を読む．
+// @retval true 成功した．
+// @retval false ファイルの末尾を越えた．
+bool
+LsimImageReader::read_array(vector<ymuint32>& array)
+{
+  ymuint64 n;
+  const char* src = get_array(sizeof(ymuint32), n);
+  if ( src == NULL ) {
+    return false;
+  }
+  array.resize(n);
+  if ( n > 0 ) {
+    memcpy(&array[0], src, n * sizeof(ymuint32));
+  }
+  return true;
+}
+
+// @brief ymuint64 の配列を読む．
+// @retval true 成功した．
+// @retval false ファイルの末尾を越えた．
+bool
+LsimImageReader::read_array(vector<ymuint64>& array)
+{
+  ymuint64 n;
+  const char* src = get_array(sizeof(ymuint64), n);
+  if ( src == NULL ) {
+    return false;
+  }
+  array.resize(n);
+  if ( n > 0 ) {
+    memcpy(&array[0], src, n * sizeof(ymuint64));
+  }
+  return true;
+}
+
+// @brief ymuint32 の配列をコピーせずに読む．
+// @param[out] array 配列の先頭(ファイルを写像した領域を指す)
+// @param[out] n 要素数
+// @retval true 成功した．
+// @retval false ファイルの末尾を越えた．
+bool
+LsimImageReader::map_array(const ymuint32*& array,
+			   ymuint64& n)
+{
+  const char* src = get_array(sizeof(ymuint32), n);
+  if ( src == NULL ) {
+    return false;
+  }
+  array = reinterpret_cast<const ymuint32*>(src);
+  return true;
+}
+
+// @brief 内容を交換する．
+// @note 写像した領域を別のオブジェクトに持たせる時に用いる．
+void
+LsimImageReader::swap(LsimImageReader& src)
+{
+  std::swap(mTop, src.mTop);
+  std::swap(mSize, src.mSize);
+  std::swap(mPos, src.mPos);
+  std::swap(mSignature, src.mSignature);
+}
+
+// @brief 配列の先頭を得る．
+// @param[in] elem_size 要素のサイズ
+// @param[out] n 要素数
+// @return 配列の先頭を返す．失敗したら NULL を返す．
+// @note 配列は8バイト境界から始まるように書かれている．
+const char*
+LsimImageReader::get_array(ymuint64 elem_size,
+			   ymuint64& n)
+{
+  if ( !read_64(n) ) {
+    return NULL;
+  }
+  ymuint64 size = n * elem_size;
+  if ( n > mSize || size > mSize - mPos ) {
+    return NULL;
+  }
+  const char* src = mTop + mPos;
+  mPos += size;
+  ymuint64 pad = pad_size(size);
+  if ( pad > mSize - mPos ) {
+    return NULL;
+  }
+  mPos += pad;
+  return src;
+}
+
+// @brief データを読む．
+bool
+LsimImageReader::read_data(void* data,
+			   ymuint64 size)
+{
+  if ( mTop == NULL || size > mSize - mPos ) {
+    return false;
+  }
+  memcpy(data, mTop + mPos, size);
+  mPos += size;
+  return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// シグネチャ
+//////////////////////////////////////////////////////////////////////
+
+// @brief ネットワークの構造と変数順からシグネチャを求める．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+// @note 構造が同じで入力の変数番号が同じなら同じ値になる．
+ymuint64
+network_signature(const BdnMgr& bdn,
+		  const unordered_map<string, ymuint>& order_map)
+{
+  ymuint64 h = 14695981039346656037UL;
+
+  // BdnNode の ID 番号から通し番号を得る配列
+  // 0 は定数0を表す．
+  vector<ymuint32> pos_map(bdn.max_node_id(), 0U);
+
+  const BdnNodeList& input_list = bdn.input_list();
+  const BdnNodeList& output_list = bdn.output_list();
+  hash_val(h, input_list.size());
+  hash_val(h, output_list.size());
+  ymuint32 pos = 1;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    pos_map[node->id()] = pos;
+    // 入力の変数番号
+    // 順序マップにない入力は set_network() でエラーになる．
+    ymuint64 var = pos - 1;
+    if ( !order_map.empty() ) {
+      unordered_map<string, ymuint>::const_iterator q
+	= order_map.find(node->port()->name());
+      var = (q != order_map.end()) ? q->second : 0xFFFFFFFFUL;
+    }
+    hash_val(h, var);
+  }
+
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    pos_map[node->id()] = pos;
+    for (ymuint i = 0; i < 2; ++ i) {
+      ymuint64 code = pos_map[node->fanin(i)->id()];
+      code = (code << 1) | static_cast<ymuint64>(node->fanin_inv(i));
+      hash_val(h, code);
+    }
+    hash_val(h, node->is_xor());
+  }
+
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    ymuint64 code = 0UL;
+    if ( inode != NULL ) {
+      code = pos_map[inode->id()];
+    }
+    code = (code << 1) | static_cast<ymuint64>(node->output_fanin_inv());
+    hash_val(h, code);
+  }
+
+  return h;
+}
+
+END_NAMESPACE_YM
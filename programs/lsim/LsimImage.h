@@ -0,0 +1,261 @@
+﻿#ifndef LSIMIMAGE_H
+#define LSIMIMAGE_H
+
+/// @file LsimImage.h
+/// @brief LsimImageWriter, LsimImageReader のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmNetworks/BdnMgr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// イメージファイルの形式
+//
+// ヘッダ(40バイト)
+//   ymuint32 識別子("LSIM")
+//   ymuint32 ファイル形式のバージョン
+//   char[16] 手法名
+//   ymuint32 手法ごとのバージョン
+//   ymuint32 予約(0)
+//   ymuint64 ネットワークのシグネチャ
+// 本体
+//   手法ごとに write_64(), write_array() で書いたもの
+//   配列は要素数(ymuint64)の後に要素を並べ，8バイト境界まで 0 で埋める．
+//
+// 数値はこのマシンのバイト順で書く．
+//////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimImageWriter LsimImage.h "LsimImage.h"
+/// @brief Lsim のイメージファイルを書き出すクラス
+///
+/// 一時ファイルに書いてから close() で rename() するので
+/// 同じファイルを複数のプロセスが同時に書いても壊れない．
+//////////////////////////////////////////////////////////////////////
+class LsimImageWriter
+{
+public:
+
+  /// @brief コンストラクタ
+  LsimImageWriter();
+
+  /// @brief デストラクタ
+  /// @note close() されていない時は一時ファイルを削除する．
+  ~LsimImageWriter();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ファイルを開いてヘッダを書く．
+  /// @param[in] filename ファイル名
+  /// @param[in] name 手法名
+  /// @param[in] version 手法ごとのバージョン
+  /// @param[in] signature ネットワークのシグネチャ
+  /// @retval true 成功した．
+  /// @retval false 失敗した．
+  bool
+  open(const string& filename,
+       const char* name,
+       ymuint32 version,
+       ymuint64 signature);
+
+  /// @brief 64ビットの値を書く．
+  void
+  write_64(ymuint64 val);
+
+  /// @brief ymuint32 の配列を書く．
+  void
+  write_array(const vector<ymuint32>& array);
+
+  /// @brief ymuint32 の配列を書く．
+  /// @param[in] array 配列の先頭
+  /// @param[in] n 要素数
+  void
+  write_array(const ymuint32* array,
+	      ymuint64 n);
+
+  /// @brief ymuint64 の配列を書く．
+  void
+  write_array(const vector<ymuint64>& array);
+
+  /// @brief ファイルを閉じる．
+  /// @retval true 全ての書き込みが成功した．
+  /// @retval false 失敗した．
+  bool
+  close();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 32ビットの値を書く．
+  /// @note 配列の境界がずれないようにヘッダでのみ用いる．
+  void
+  write_32(ymuint32 val);
+
+  /// @brief データを書く．
+  void
+  write_data(const void* data,
+	     ymuint64 size);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ファイル名
+  string mFilename;
+
+  // 一時ファイル名
+  string mTmpFilename;
+
+  // 出力先のストリーム
+  ofstream mStream;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimImageReader LsimImage.h "LsimImage.h"
+/// @brief Lsim のイメージファイルを読み込むクラス
+///
+/// ファイルは mmap() で読み込む．
+/// map_array() で得たポインタはこのオブジェクトが close() されるか
+/// 破壊されるまで有効
+//////////////////////////////////////////////////////////////////////
+class LsimImageReader
+{
+public:
+
+  /// @brief コンストラクタ
+  LsimImageReader();
+
+  /// @brief デストラクタ
+  ~LsimImageReader();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ファイルを開いてヘッダを読む．
+  /// @param[in] filename ファイル名
+  /// @param[in] name 手法名
+  /// @param[in] version 手法ごとのバージョン
+  /// @retval true 成功した．
+  /// @retval false ファイルが読めないかヘッダが一致しなかった．
+  bool
+  open(const string& filename,
+       const char* name,
+       ymuint32 version);
+
+  /// @brief ファイルを閉じる．
+  void
+  close();
+
+  /// @brief ヘッダに書かれていたシグネチャを返す．
+  ymuint64
+  signature() const;
+
+  /// @brief 64ビットの値を読む．
+  /// @retval true 成功した．
+  /// @retval false ファイルの末尾を越えた．
+  bool
+  read_64(ymuint64& val);
+
+  /// @brief ymuint32 の配列を読む．
+  /// @retval true 成功した．
+  /// @retval false ファイルの末尾を越えた．
+  bool
+  read_array(vector<ymuint32>& array);
+
+  /// @brief ymuint64 の配列を読む．
+  /// @retval true 成功した．
+  /// @retval false ファイルの末尾を越えた．
+  bool
+  read_array(vector<ymuint64>& array);
+
+  /// @brief ymuint32 の配列をコピーせずに読む．
+  /// @param[out] array 配列の先頭(ファイルを写像した領域を指す)
+  /// @param[out] n 要素数
+  /// @retval true 成功した．
+  /// @retval false ファイルの末尾を越えた．
+  bool
+  map_array(const ymuint32*& array,
+	    ymuint64& n);
+
+  /// @brief 内容を交換する．
+  /// @note 写像した領域を別のオブジェクトに持たせる時に用いる．
+  void
+  swap(LsimImageReader& src);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 32ビットの値を読む．
+  /// @note ヘッダでのみ用いる．
+  bool
+  read_32(ymuint32& val);
+
+  /// @brief 配列の先頭を得る．
+  /// @param[in] elem_size 要素のサイズ
+  /// @param[out] n 要素数
+  /// @return 配列の先頭を返す．失敗したら NULL を返す．
+  const char*
+  get_array(ymuint64 elem_size,
+	    ymuint64& n);
+
+  /// @brief データを読む．
+  bool
+  read_data(void* data,
+	    ymuint64 size);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 写像した領域の先頭
+  char* mTop;
+
+  // 写像した領域のサイズ
+  ymuint64 mSize;
+
+  // 次に読む位置
+  ymuint64 mPos;
+
+  // シグネチャ
+  ymuint64 mSignature;
+
+};
+
+
+/// @brief ネットワークの構造と変数順からシグネチャを求める．
+/// @param[in] bdn 対象のネットワーク
+/// @param[in] order_map 順序マップ
+/// @note 構造が同じで入力の変数番号が同じなら同じ値になる．
+ymuint64
+network_signature(const BdnMgr& bdn,
+		  const unordered_map<string, ymuint>& order_map);
+
+END_NAMESPACE_YM
+
+#endif // LSIMIMAGE_H
@@ -8,6 +8,7 @@
 
 
 #include "LsimMpx.h"
+#include "LsimImage.h"
 #include "YmNetworks/BdnNode.h"
 #include "YmNetworks/BdnPort.h"
 #include "YmLogic/BddVector.h"
@@ -70,6 +71,51 @@ ptr_eval(ympuint ptr)
   return val;
 }
 
+// @brief ポインタをイメージファイル用の番号に変換する．
+// @note 入力ノードと MPX ノードを通した番号を idx として
+// (idx + 1) * 2 + 極性 で表す．定数は 0 か 1 になる．
+inline
+ymuint32
+ptr_to_code(ympuint ptr,
+	    const vector<LsimMpx::MpxNode>& input_list,
+	    const vector<LsimMpx::MpxNode>& node_list)
+{
+  const LsimMpx::MpxNode* node = decode_node(ptr);
+  ymuint32 inv = decode_inv(ptr) ? 1U : 0U;
+  if ( node == NULL ) {
+    return inv;
+  }
+  ymuint ni = input_list.size();
+  ymuint32 idx;
+  if ( ni > 0 && node >= &input_list[0] && node < &input_list[0] + ni ) {
+    idx = node - &input_list[0];
+  }
+  else {
+    idx = (node - &node_list[0]) + ni;
+  }
+  return ((idx + 1) << 1) | inv;
+}
+
+// @brief イメージファイル用の番号をポインタに変換する．
+inline
+ympuint
+code_to_ptr(ymuint32 code,
+	    vector<LsimMpx::MpxNode>& input_list,
+	    vector<LsimMpx::MpxNode>& node_list)
+{
+  bool inv = static_cast<bool>(code & 1U);
+  ymuint32 idx1 = code >> 1;
+  if ( idx1 == 0 ) {
+    return inv ? 1UL : 0UL;
+  }
+  ymuint idx = idx1 - 1;
+  ymuint ni = input_list.size();
+  if ( idx < ni ) {
+    return encode(&input_list[idx], inv);
+  }
+  return encode(&node_list[idx - ni], inv);
+}
+
 END_NONAMESPACE
 
 // @brief ネットワークをセットする．
@@ -88,22 +134,30 @@ LsimMpx::set_network(const BdnMgr& bdn,
   ymuint ni = input_list.size();
   mInputList.clear();
   mInputList.reserve(ni);
+  // 変数番号から入力番号を得る配列
+  // 順序マップがない時は変数番号と入力番号は等しい．
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[i] = i;
+  }
   if ( order_map.empty() ) {
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
 	 p != input_list.end(); ++ p) {
       const BdnNode* node = *p;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
-      ++ id;
       bddmap[node->id()] = bdd;
       mInputList.push_back(MpxNode(VarId(id), 0UL, 0UL));
       ympuint ptr = encode(&mInputList.back(), false);
       mpx_map.insert(make_pair(bdd, ptr));
+      ++ id;
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -112,6 +166,8 @@ LsimMpx::set_network(const BdnMgr& bdn,
 	abort();
       }
       ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      mVarInput[id] = i;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
       bddmap[node->id()] = bdd;
       mInputList.push_back(MpxNode(VarId(id), 0UL, 0UL));
@@ -219,7 +275,8 @@ LsimMpx::make_mpx(Bdd bdd,
   ympuint node0 = make_mpx(bdd0, mpx_map);
   ympuint node1 = make_mpx(bdd1, mpx_map);
 
-  mNodeList.push_back(MpxNode(varid, node0, node1));
+  // 評価時に入力ベクタを直接引けるように入力番号を入れる．
+  mNodeList.push_back(MpxNode(VarId(mVarInput[varid.val()]), node0, node1));
   ympuint ptr = encode(&mNodeList.back(), false);
   mpx_map.insert(make_pair(bdd, ptr));
 
@@ -235,6 +292,9 @@ LsimMpx::eval(const vector<ymuint64>& iv,
 {
   ymuint ni = mInputList.size();
   ASSERT_COND( ni == iv.size() );
+  for (ymuint i = 0; i < ni; ++ i) {
+    mInputList[i].mVal = iv[i];
+  }
 
   ymuint nn = mNodeList.size();
   for (ymuint i = 0; i < nn; ++ i) {
@@ -255,4 +315,132 @@ LsimMpx::eval(const vector<ymuint64>& iv,
   }
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimMpx::node_num() const
+{
+  return mNodeList.size();
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+const char*
+LsimMpx::image_name() const
+{
+  return "mpx";
+}
+
+// @brief イメージファイルの形式のバージョンを返す．
+ymuint32
+LsimMpx::image_version() const
+{
+  return 2;
+}
+
+// @brief set_network() で作った内容をイメージファイルに書き出す．
+// @param[in] writer 書き出し用のオブジェクト
+// @note ポインタはそのまま書けないので ptr_to_code() で番号に変換する．
+void
+LsimMpx::write_image(LsimImageWriter& writer) const
+{
+  ymuint ni = mInputList.size();
+  vector<ymuint32> input_var(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    input_var[i] = mInputList[i].mId.val();
+  }
+
+  ymuint nn = mNodeList.size();
+  vector<ymuint32> node_var(nn);
+  vector<ymuint32> fanin_array(nn * 2);
+  for (ymuint i = 0; i < nn; ++ i) {
+    const MpxNode& node = mNodeList[i];
+    node_var[i] = node.mId.val();
+    for (ymuint j = 0; j < 2; ++ j) {
+      fanin_array[i * 2 + j] = ptr_to_code(node.mFanins[j],
+					   mInputList, mNodeList);
+    }
+  }
+
+  ymuint no = mOutputList.size();
+  vector<ymuint32> output_array(no);
+  for (ymuint i = 0; i < no; ++ i) {
+    output_array[i] = ptr_to_code(mOutputList[i], mInputList, mNodeList);
+  }
+
+  writer.write_array(input_var);
+  writer.write_array(node_var);
+  writer.write_array(fanin_array);
+  writer.write_array(output_array);
+}
+
+// @brief イメージファイルの内容を読み込む．
+// @param[in] reader 読み込み用のオブジェクト
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+bool
+LsimMpx::read_image(LsimImageReader& reader)
+{
+  vector<ymuint32> input_var;
+  vector<ymuint32> node_var;
+  vector<ymuint32> fanin_array;
+  vector<ymuint32> output_array;
+  if ( !reader.read_array(input_var) ||
+       !reader.read_array(node_var) ||
+       !reader.read_array(fanin_array) ||
+       !reader.read_array(output_array) ) {
+    return false;
+  }
+  ymuint ni = input_var.size();
+  ymuint nn = node_var.size();
+  if ( fanin_array.size() != nn * 2 ) {
+    return false;
+  }
+  // 制御入力の番号は入力ベクタの位置として用いる．
+  for (ymuint i = 0; i < nn; ++ i) {
+    if ( node_var[i] >= ni ) {
+      return false;
+    }
+  }
+  ymuint64 max_code = (static_cast<ymuint64>(ni + nn) + 1) * 2;
+  for (ymuint i = 0; i < fanin_array.size(); ++ i) {
+    if ( fanin_array[i] >= max_code ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < output_array.size(); ++ i) {
+    if ( output_array[i] >= max_code ) {
+      return false;
+    }
+  }
+
+  // ポインタを作る前に全てのノードを確保しておく．
+  mInputList.clear();
+  mInputList.reserve(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mInputList.push_back(MpxNode(VarId(input_var[i]), 0UL, 0UL));
+  }
+  mNodeList.clear();
+  mNodeList.reserve(nn);
+  for (ymuint i = 0; i < nn; ++ i) {
+    mNodeList.push_back(MpxNode(VarId(node_var[i]), 0UL, 0UL));
+  }
+  for (ymuint i = 0; i < nn; ++ i) {
+    MpxNode& node = mNodeList[i];
+    for (ymuint j = 0; j < 2; ++ j) {
+      node.mFanins[j] = code_to_ptr(fanin_array[i * 2 + j],
+				    mInputList, mNodeList);
+    }
+  }
+  ymuint no = output_array.size();
+  mOutputList.clear();
+  mOutputList.reserve(no);
+  for (ymuint i = 0; i < no; ++ i) {
+    mOutputList.push_back(code_to_ptr(output_array[i],
+				      mInputList, mNodeList));
+  }
+
+  cout << "MPX size: " << mNodeList.size() << endl;
+
+  return true;
+}
+
 END_NAMESPACE_YM
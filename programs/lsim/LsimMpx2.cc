@@ -8,6 +8,7 @@
 
 
 #include "LsimMpx2.h"
+#include "LsimImage.h"
 #include "YmNetworks/BdnNode.h"
 #include "YmNetworks/BdnPort.h"
 #include "YmLogic/BddVector.h"
@@ -70,6 +71,37 @@ ptr_eval(ympuint ptr)
   return val;
 }
 
+// @brief ポインタをイメージファイル用の番号に変換する．
+// @note MPX ノードの番号を idx として (idx + 1) * 2 + 極性 で表す．
+// 定数は 0 か 1 になる．
+inline
+ymuint32
+ptr_to_code(ympuint ptr,
+	    const vector<LsimMpx2::MpxNode>& node_list)
+{
+  const LsimMpx2::MpxNode* node = decode_node(ptr);
+  ymuint32 inv = decode_inv(ptr) ? 1U : 0U;
+  if ( node == NULL ) {
+    return inv;
+  }
+  ymuint32 idx = node - &node_list[0];
+  return ((idx + 1) << 1) | inv;
+}
+
+// @brief イメージファイル用の番号をポインタに変換する．
+inline
+ympuint
+code_to_ptr(ymuint32 code,
+	    vector<LsimMpx2::MpxNode>& node_list)
+{
+  bool inv = static_cast<bool>(code & 1U);
+  ymuint32 idx1 = code >> 1;
+  if ( idx1 == 0 ) {
+    return inv ? 1UL : 0UL;
+  }
+  return encode(&node_list[idx1 - 1], inv);
+}
+
 END_NONAMESPACE
 
 // @brief ネットワークをセットする．
@@ -85,6 +117,14 @@ LsimMpx2::set_network(const BdnMgr& bdn,
   unordered_map<Bdd, ympuint> mpx_map;
 
   const BdnNodeList& input_list = bdn.input_list();
+  ymuint ni = input_list.size();
+  // 変数番号から入力番号を得る配列
+  // 順序マップがない時は変数番号と入力番号は等しい．
+  mVarInput.clear();
+  mVarInput.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    mVarInput[i] = i;
+  }
   if ( order_map.empty() ) {
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
@@ -96,8 +136,9 @@ LsimMpx2::set_network(const BdnMgr& bdn,
     }
   }
   else {
+    ymuint i = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ i) {
       const BdnNode* node = *p;
       string name = node->port()->name();
       unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
@@ -106,6 +147,8 @@ LsimMpx2::set_network(const BdnMgr& bdn,
 	abort();
       }
       ymuint id = q->second;
+      ASSERT_COND( id < ni );
+      mVarInput[id] = i;
       Bdd bdd = mBddMgr.make_posiliteral(VarId(id));
       bddmap[node->id()] = bdd;
     }
@@ -244,7 +287,10 @@ LsimMpx2::make_mpx(Bdd bdd,
     node11 = make_mpx(bdd11, mpx_map);
   }
 
-  mNodeList.push_back(MpxNode(varid1, varid2, varid3,
+  // 評価時に入力ベクタを直接引けるように入力番号を入れる．
+  mNodeList.push_back(MpxNode(VarId(mVarInput[varid1.val()]),
+			      VarId(mVarInput[varid2.val()]),
+			      VarId(mVarInput[varid3.val()]),
 			      node00, node01, node10, node11));
   ympuint ptr = encode(&mNodeList.back(), false);
   mpx_map.insert(make_pair(bdd, ptr));
@@ -259,6 +305,8 @@ void
 LsimMpx2::eval(const vector<ymuint64>& iv,
 	       vector<ymuint64>& ov)
 {
+  ASSERT_COND( iv.size() == mVarInput.size() );
+
   ymuint nn = mNodeList.size();
   for (ymuint i = 0; i < nn; ++ i) {
     MpxNode& node = mNodeList[i];
@@ -287,4 +335,125 @@ LsimMpx2::eval(const vector<ymuint64>& iv,
   }
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimMpx2::node_num() const
+{
+  return mNodeList.size();
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+const char*
+LsimMpx2::image_name() const
+{
+  return "mpx2";
+}
+
+// @brief イメージファイルの形式のバージョンを返す．
+ymuint32
+LsimMpx2::image_version() const
+{
+  return 3;
+}
+
+// @brief set_network() で作った内容をイメージファイルに書き出す．
+// @param[in] writer 書き出し用のオブジェクト
+// @note ポインタはそのまま書けないので ptr_to_code() で番号に変換する．
+void
+LsimMpx2::write_image(LsimImageWriter& writer) const
+{
+  ymuint nn = mNodeList.size();
+  vector<ymuint32> var_array(nn * 3);
+  vector<ymuint32> fanin_array(nn * 4);
+  for (ymuint i = 0; i < nn; ++ i) {
+    const MpxNode& node = mNodeList[i];
+    for (ymuint j = 0; j < 3; ++ j) {
+      var_array[i * 3 + j] = node.mId[j].val();
+    }
+    for (ymuint j = 0; j < 4; ++ j) {
+      fanin_array[i * 4 + j] = ptr_to_code(node.mFanins[j], mNodeList);
+    }
+  }
+
+  ymuint no = mOutputList.size();
+  vector<ymuint32> output_array(no);
+  for (ymuint i = 0; i < no; ++ i) {
+    output_array[i] = ptr_to_code(mOutputList[i], mNodeList);
+  }
+
+  writer.write_array(mVarInput);
+  writer.write_array(var_array);
+  writer.write_array(fanin_array);
+  writer.write_array(output_array);
+}
+
+// @brief イメージファイルの内容を読み込む．
+// @param[in] reader 読み込み用のオブジェクト
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+bool
+LsimMpx2::read_image(LsimImageReader& reader)
+{
+  vector<ymuint32> var_input;
+  vector<ymuint32> var_array;
+  vector<ymuint32> fanin_array;
+  vector<ymuint32> output_array;
+  if ( !reader.read_array(var_input) ||
+       !reader.read_array(var_array) ||
+       !reader.read_array(fanin_array) ||
+       !reader.read_array(output_array) ) {
+    return false;
+  }
+  ymuint nn = var_array.size() / 3;
+  if ( var_array.size() != nn * 3 || fanin_array.size() != nn * 4 ) {
+    return false;
+  }
+  // 制御入力の番号は入力ベクタの位置として用いる．
+  ymuint ni = var_input.size();
+  for (ymuint i = 0; i < var_array.size(); ++ i) {
+    if ( var_array[i] >= ni ) {
+      return false;
+    }
+  }
+  ymuint64 max_code = (static_cast<ymuint64>(nn) + 1) * 2;
+  for (ymuint i = 0; i < fanin_array.size(); ++ i) {
+    if ( fanin_array[i] >= max_code ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < output_array.size(); ++ i) {
+    if ( output_array[i] >= max_code ) {
+      return false;
+    }
+  }
+
+  // ポインタを作る前に全てのノードを確保しておく．
+  mNodeList.clear();
+  mNodeList.reserve(nn);
+  for (ymuint i = 0; i < nn; ++ i) {
+    mNodeList.push_back(MpxNode(VarId(var_array[i * 3 + 0]),
+				VarId(var_array[i * 3 + 1]),
+				VarId(var_array[i * 3 + 2]),
+				0UL, 0UL, 0UL, 0UL));
+  }
+  for (ymuint i = 0; i < nn; ++ i) {
+    MpxNode& node = mNodeList[i];
+    for (ymuint j = 0; j < 4; ++ j) {
+      node.mFanins[j] = code_to_ptr(fanin_array[i * 4 + j], mNodeList);
+    }
+  }
+  ymuint no = output_array.size();
+  mOutputList.clear();
+  mOutputList.reserve(no);
+  for (ymuint i = 0; i < no; ++ i) {
+    mOutputList.push_back(code_to_ptr(output_array[i], mNodeList));
+  }
+
+  mVarInput.swap(var_input);
+
+  cout << "MPX size: " << mNodeList.size() << endl;
+
+  return true;
+}
+
 END_NAMESPACE_YM
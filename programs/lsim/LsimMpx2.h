@@ -54,6 +54,41 @@ public:
   eval(const vector<ymuint64>& iv,
        vector<ymuint64>& ov);
 
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイル用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルに記録する手法名を返す．
+  virtual
+  const char*
+  image_name() const;
+
+  /// @brief イメージファイルの形式のバージョンを返す．
+  virtual
+  ymuint32
+  image_version() const;
+
+  /// @brief set_network() で作った内容をイメージファイルに書き出す．
+  /// @param[in] writer 書き出し用のオブジェクト
+  virtual
+  void
+  write_image(LsimImageWriter& writer) const;
+
+  /// @brief イメージファイルの内容を読み込む．
+  /// @param[in] reader 読み込み用のオブジェクト
+  /// @retval true 読み込みが成功した．
+  /// @retval false 読み込みが失敗した．
+  virtual
+  bool
+  read_image(LsimImageReader& reader);
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -89,7 +124,7 @@ public:
       mFanins[3] = ptr11;
     }
 
-    // 変数番号
+    // 制御入力の入力番号
     VarId mId[3];
 
     // ファンイン＋極性
@@ -109,6 +144,9 @@ private:
   // BDD の管理用オブジェクト
   BddMgr mBddMgr;
 
+  // 変数番号から入力番号を得る配列
+  vector<ymuint32> mVarInput;
+
   // 入力ノードの配列
   vector<MpxNode> mInputList;
 
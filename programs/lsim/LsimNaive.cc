@@ -74,23 +74,49 @@ LsimNaive::eval(const vector<ymuint64>& iv,
     return;
   }
 
+  eval_mt(iv, ov, mValArray);
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimNaive::has_eval_mt() const
+{
+  return mBdnMgr != NULL;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+ymuint
+LsimNaive::work_size() const
+{
+  return mValArray.size();
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(node->id() をキーにした値の配列)
+void
+LsimNaive::eval_mt(const vector<ymuint64>& iv,
+		   vector<ymuint64>& ov,
+		   vector<ymuint64>& work) const
+{
   ymuint ni = mInputList.size();
   ASSERT_COND( ni == iv.size() );
   for (ymuint i = 0; i < ni; ++ i) {
     const BdnNode* node = mInputList[i];
-    mValArray[node->id()] = iv[i];
+    work[node->id()] = iv[i];
   }
 
   ymuint nn = mNodeList.size();
   for (ymuint i = 0; i < nn; ++ i) {
     const BdnNode* node = mNodeList[i];
     const BdnNode* node0 = node->fanin0();
-    ymuint64 val0 = mValArray[node0->id()];
+    ymuint64 val0 = work[node0->id()];
     if ( node->fanin0_inv() ) {
       val0 = ~val0;
     }
     const BdnNode* node1 = node->fanin1();
-    ymuint64 val1 = mValArray[node1->id()];
+    ymuint64 val1 = work[node1->id()];
     if ( node->fanin1_inv() ) {
       val1 = ~val1;
     }
@@ -101,7 +127,7 @@ LsimNaive::eval(const vector<ymuint64>& iv,
     else {
       val = val0 ^ val1;
     }
-    mValArray[node->id()] = val;
+    work[node->id()] = val;
   }
 
   ymuint no = mOutputList.size();
@@ -110,7 +136,7 @@ LsimNaive::eval(const vector<ymuint64>& iv,
     const BdnNode* inode = node->output_fanin();
     ymuint64 val = 0U;
     if ( inode ) {
-      val = mValArray[inode->id()];
+      val = work[inode->id()];
     }
     if ( node->output_fanin_inv() ) {
       val = ~val;
@@ -119,4 +145,11 @@ LsimNaive::eval(const vector<ymuint64>& iv,
   }
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimNaive::node_num() const
+{
+  return mNodeList.size();
+}
+
 END_NAMESPACE_YM
@@ -178,4 +178,11 @@ LsimNaive2::eval(const vector<ymuint64>& iv,
   }
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimNaive2::node_num() const
+{
+  return mNodeList.size();
+}
+
 END_NAMESPACE_YM
@@ -113,26 +113,31 @@ LsimNaive3::set_network(const BdnMgr& bdn,
   for (vector<const BdnNode*>::iterator p = node_list.begin();
        p != node_list.end(); ++ p) {
     const BdnNode* node = *p;
-    SimNode* snode = &mNodeList[id];
-    ++ id;
     SimNode* snode0 = map[node->fanin(0)->id()];
     bool inv0 = node->fanin_inv(0);
     SimNode* snode1 = map[node->fanin(1)->id()];
     bool inv1 = node->fanin_inv(1);
 
+    SimNode* snode = NULL;
     if ( node->is_xor() ) {
-      SimNode* snode01 = &mNodeList[id];
+      // a ^ b = ~(~a & ~b) & ~(a & b)
+      SimNode* snode00 = &mNodeList[id];
+      ++ id;
+      snode00->mFanins[0] = encode(snode0, !inv0);
+      snode00->mFanins[1] = encode(snode1, !inv1);
+      SimNode* snode11 = &mNodeList[id];
       ++ id;
-      snode01->mFanins[0] = encode(snode0, !inv0);
-      snode01->mFanins[1] = encode(snode1, inv1);
-      SimNode* snode10 = &mNodeList[id];
+      snode11->mFanins[0] = encode(snode0, inv0);
+      snode11->mFanins[1] = encode(snode1, inv1);
+      // mNodeList の順に評価するので snode は最後に置く．
+      snode = &mNodeList[id];
       ++ id;
-      snode10->mFanins[0] = encode(snode0, inv0);
-      snode10->mFanins[1] = encode(snode1, !inv1);
-      snode->mFanins[0] = encode(snode01, true);
-      snode->mFanins[1] = encode(snode10, false);
+      snode->mFanins[0] = encode(snode00, true);
+      snode->mFanins[1] = encode(snode11, true);
     }
     else {
+      snode = &mNodeList[id];
+      ++ id;
       snode->mFanins[0] = encode(snode0, inv0);
       snode->mFanins[1] = encode(snode1, inv1);
     }
@@ -187,4 +192,11 @@ LsimNaive3::eval(const vector<ymuint64>& iv,
   }
 }
 
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimNaive3::node_num() const
+{
+  return mNodeList.size();
+}
+
 END_NAMESPACE_YM
@@ -0,0 +1,469 @@
+﻿
+/// @file LsimNaive3W.cc
+/// @brief LsimNaive3W の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimNaive3W.h"
+#include "YmNetworks/BdnNode.h"
+#include <cstring>
+
+
+#if defined(__GNUC__)
+// gcc/clang のベクタ拡張を用いる．
+#define LSIM_VECTOR_EXT 1
+#if defined(__x86_64__) || defined(__i386__)
+// target 属性と CPU の機能の検出が使える．
+#define LSIM_X86_TARGET 1
+#endif
+#endif
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+inline
+ymuint32
+encode(ymuint32 id,
+       bool inv)
+{
+  return (id << 1) | static_cast<ymuint32>(inv);
+}
+
+#if LSIM_VECTOR_EXT
+
+// 128/256/512 ビットのワード
+typedef ymuint64 PackedVal2 __attribute__((vector_size(16)));
+typedef ymuint64 PackedVal4 __attribute__((vector_size(32)));
+typedef ymuint64 PackedVal8 __attribute__((vector_size(64)));
+
+#define LSIM_ALWAYS_INLINE inline __attribute__((always_inline))
+
+#else
+
+// ベクタ拡張が使えない時のための N ワードの配列
+template<ymuint N>
+struct WordArray
+{
+  WordArray
+  operator^(ymuint64 mask) const
+  {
+    WordArray ans;
+    for (ymuint i = 0; i < N; ++ i) {
+      ans.mWord[i] = mWord[i] ^ mask;
+    }
+    return ans;
+  }
+
+  WordArray
+  operator&(const WordArray& right) const
+  {
+    WordArray ans;
+    for (ymuint i = 0; i < N; ++ i) {
+      ans.mWord[i] = mWord[i] & right.mWord[i];
+    }
+    return ans;
+  }
+
+  ymuint64 mWord[N];
+};
+
+typedef WordArray<2> PackedVal2;
+typedef WordArray<4> PackedVal4;
+typedef WordArray<8> PackedVal8;
+
+#define LSIM_ALWAYS_INLINE inline
+
+#endif
+
+// 評価の本体
+// WordType は N ワード分の値を表す型
+template<typename WordType,
+	 ymuint N>
+LSIM_ALWAYS_INLINE
+void
+eval_kernel(const ymuint32* fanin_array,
+	    ymuint top,
+	    ymuint nn,
+	    ymuint64* val_array)
+{
+  const ymuint32* fanin = fanin_array;
+  ymuint64* dst = val_array + top * N;
+  for (ymuint i = 0; i < nn; ++ i, fanin += 2, dst += N) {
+    ymuint32 f0 = fanin[0];
+    ymuint32 f1 = fanin[1];
+    WordType val0;
+    WordType val1;
+    memcpy(&val0, val_array + (f0 >> 1) * N, sizeof(WordType));
+    memcpy(&val1, val_array + (f1 >> 1) * N, sizeof(WordType));
+    // 極性は全ビット1のマスクとの XOR で反映させる．
+    ymuint64 mask0 = 0UL - static_cast<ymuint64>(f0 & 1U);
+    ymuint64 mask1 = 0UL - static_cast<ymuint64>(f1 & 1U);
+    WordType val = (val0 ^ mask0) & (val1 ^ mask1);
+    memcpy(dst, &val, sizeof(WordType));
+  }
+}
+
+void
+eval_w1(const ymuint32* fanin_array,
+	ymuint top,
+	ymuint nn,
+	ymuint64* val_array)
+{
+  eval_kernel<ymuint64, 1>(fanin_array, top, nn, val_array);
+}
+
+// x86-64 では SSE2 は常に使える．
+void
+eval_w2(const ymuint32* fanin_array,
+	ymuint top,
+	ymuint nn,
+	ymuint64* val_array)
+{
+  eval_kernel<PackedVal2, 2>(fanin_array, top, nn, val_array);
+}
+
+// target 属性なしの 4 ワード版
+// ベースラインの命令(x86-64 なら SSE2)だけで評価される．
+void
+eval_w4(const ymuint32* fanin_array,
+	ymuint top,
+	ymuint nn,
+	ymuint64* val_array)
+{
+  eval_kernel<PackedVal4, 4>(fanin_array, top, nn, val_array);
+}
+
+// target 属性なしの 8 ワード版
+void
+eval_w8(const ymuint32* fanin_array,
+	ymuint top,
+	ymuint nn,
+	ymuint64* val_array)
+{
+  eval_kernel<PackedVal8, 8>(fanin_array, top, nn, val_array);
+}
+
+#if LSIM_X86_TARGET
+// AVX2 版の 4 ワード
+// CPU が AVX2 を持つ時しか呼んではいけない．
+__attribute__((target("avx2")))
+void
+eval_w4_avx2(const ymuint32* fanin_array,
+	     ymuint top,
+	     ymuint nn,
+	     ymuint64* val_array)
+{
+  eval_kernel<PackedVal4, 4>(fanin_array, top, nn, val_array);
+}
+
+// AVX-512 版の 8 ワード
+// CPU が AVX-512F を持つ時しか呼んではいけない．
+__attribute__((target("avx512f")))
+void
+eval_w8_avx512(const ymuint32* fanin_array,
+	       ymuint top,
+	       ymuint nn,
+	       ymuint64* val_array)
+{
+  eval_kernel<PackedVal8, 8>(fanin_array, top, nn, val_array);
+}
+#endif
+
+// CPU が AVX2 を持つか調べる．
+// x86 以外では常に false を返す．
+bool
+cpu_supports_avx2()
+{
+#if LSIM_X86_TARGET
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+// CPU が AVX-512F を持つか調べる．
+// x86 以外では常に false を返す．
+bool
+cpu_supports_avx512f()
+{
+#if LSIM_X86_TARGET
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f");
+#else
+  return false;
+#endif
+}
+
+// CPU の機能を調べて適切なワード数を返す．
+// AVX-512F があれば 8，AVX2 があれば 4，どちらもなければ SSE2 の 2 とする．
+ymuint
+detect_word_num()
+{
+  if ( cpu_supports_avx512f() ) {
+    return 8;
+  }
+  if ( cpu_supports_avx2() ) {
+    return 4;
+  }
+  return 2;
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimNaive3W
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] word_num 1回の評価で用いるワード数(1, 2, 4, 8)
+// @note word_num = 0 の時は CPU の機能を調べて 2, 4, 8 のいずれかを選ぶ．
+LsimNaive3W::LsimNaive3W(ymuint word_num) :
+  mInputNum(0),
+  mNodeNum(0)
+{
+  if ( word_num == 0 ) {
+    word_num = detect_word_num();
+  }
+  set_word_num(word_num);
+}
+
+// @brief デストラクタ
+LsimNaive3W::~LsimNaive3W()
+{
+}
+
+// @brief ワード数に対応した評価関数をセットする．
+void
+LsimNaive3W::set_word_num(ymuint word_num)
+{
+  switch ( word_num ) {
+  case 1: mEvalFunc = eval_w1; break;
+  case 2: mEvalFunc = eval_w2; break;
+  case 4:
+    // AVX2 がない CPU では target 属性なしの版を用いる．
+    mEvalFunc = eval_w4;
+#if LSIM_X86_TARGET
+    if ( cpu_supports_avx2() ) {
+      mEvalFunc = eval_w4_avx2;
+    }
+#endif
+    break;
+  case 8:
+    mEvalFunc = eval_w8;
+#if LSIM_X86_TARGET
+    if ( cpu_supports_avx512f() ) {
+      mEvalFunc = eval_w8_avx512;
+    }
+#endif
+    break;
+  default:
+    cerr << "Illegal word num: " << word_num << endl;
+    abort();
+  }
+  mWordNum = word_num;
+}
+
+// @brief ネットワークをセットする．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+void
+LsimNaive3W::set_network(const BdnMgr& bdn,
+			 const unordered_map<string, ymuint>& order_map)
+{
+  // BdnNode の ID 番号から符号化されたノード番号を得る配列
+  // 0 は定数0を表す．
+  vector<ymuint32> map(bdn.max_node_id(), 0U);
+
+  const BdnNodeList& input_list = bdn.input_list();
+  mInputNum = input_list.size();
+  ymuint32 id = 1;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ id) {
+    const BdnNode* node = *p;
+    map[node->id()] = encode(id, false);
+  }
+
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+
+  // XOR は3つの AND に分解する．
+  ymuint n = 0;
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    if ( node->is_xor() ) {
+      n += 2;
+    }
+    ++ n;
+  }
+  mNodeNum = n;
+  mFaninArray.clear();
+  mFaninArray.reserve(n * 2);
+
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    ymuint32 code0 = map[node->fanin(0)->id()];
+    if ( node->fanin_inv(0) ) {
+      code0 ^= 1U;
+    }
+    ymuint32 code1 = map[node->fanin(1)->id()];
+    if ( node->fanin_inv(1) ) {
+      code1 ^= 1U;
+    }
+
+    if ( node->is_xor() ) {
+      // a ^ b = ~(~(~a & b) & ~(a & ~b))
+      ymuint32 id01 = id;
+      ++ id;
+      mFaninArray.push_back(code0 ^ 1U);
+      mFaninArray.push_back(code1);
+      ymuint32 id10 = id;
+      ++ id;
+      mFaninArray.push_back(code0);
+      mFaninArray.push_back(code1 ^ 1U);
+      mFaninArray.push_back(encode(id01, true));
+      mFaninArray.push_back(encode(id10, true));
+      map[node->id()] = encode(id, true);
+    }
+    else {
+      mFaninArray.push_back(code0);
+      mFaninArray.push_back(code1);
+      map[node->id()] = encode(id, false);
+    }
+    ++ id;
+  }
+  ASSERT_COND( id == mInputNum + mNodeNum + 1 );
+
+  const BdnNodeList& output_list = bdn.output_list();
+  mOutputList.clear();
+  mOutputList.reserve(output_list.size());
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    ymuint32 code = 0U;
+    if ( inode != NULL ) {
+      code = map[inode->id()];
+    }
+    if ( node->output_fanin_inv() ) {
+      code ^= 1U;
+    }
+    mOutputList.push_back(code);
+  }
+
+  mValArray.clear();
+  mValArray.resize(work_size() * mWordNum, 0UL);
+
+  cout << "Node num: " << mNodeNum << endl
+       << "Word num: " << mWordNum << endl;
+}
+
+// @brief 論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @note 1ワード(64パタン)分の評価を行う．
+void
+LsimNaive3W::eval(const vector<ymuint64>& iv,
+		  vector<ymuint64>& ov)
+{
+  eval_sub(eval_w1, 1, iv, ov, &mValArray[0]);
+}
+
+// @brief word_num() ワード分の論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @note i 番目の入力の k ワード目の値は iv[i * word_num() + k] に入れる．
+// @note ov も同様
+void
+LsimNaive3W::eval_wide(const vector<ymuint64>& iv,
+		       vector<ymuint64>& ov)
+{
+  eval_sub(mEvalFunc, mWordNum, iv, ov, &mValArray[0]);
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimNaive3W::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+ymuint
+LsimNaive3W::work_size() const
+{
+  return mInputNum + mNodeNum + 1;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域
+void
+LsimNaive3W::eval_mt(const vector<ymuint64>& iv,
+		     vector<ymuint64>& ov,
+		     vector<ymuint64>& work) const
+{
+  eval_sub(eval_w1, 1, iv, ov, &work[0]);
+}
+
+// @brief 評価の本体
+// @param[in] func 評価関数
+// @param[in] nw ワード数
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] val_array 値の配列
+void
+LsimNaive3W::eval_sub(EvalFunc func,
+		      ymuint nw,
+		      const vector<ymuint64>& iv,
+		      vector<ymuint64>& ov,
+		      ymuint64* val_array) const
+{
+  ymuint ni = mInputNum;
+  ASSERT_COND( ni * nw == iv.size() );
+
+  // 定数0の値をセットしておく．
+  // eval() と eval_wide() は同じ mValArray をワード数を変えて使うので
+  // 先頭の nw ワードには前回の入力や論理ノードの値が残っている場合がある．
+  for (ymuint k = 0; k < nw; ++ k) {
+    val_array[k] = 0UL;
+  }
+
+  // 入力や論理ノードがない時は配列が空なので先頭の要素を参照できない．
+  // その時は入力のコピーや評価関数の呼び出しも不要
+  if ( ni > 0 ) {
+    memcpy(val_array + nw, &iv[0], sizeof(ymuint64) * ni * nw);
+  }
+
+  if ( mNodeNum > 0 ) {
+    (*func)(&mFaninArray[0], ni + 1, mNodeNum, val_array);
+  }
+
+  ymuint no = mOutputList.size();
+  for (ymuint i = 0; i < no; ++ i) {
+    ymuint32 code = mOutputList[i];
+    const ymuint64* src = val_array + (code >> 1) * nw;
+    ymuint64 mask = 0UL - static_cast<ymuint64>(code & 1U);
+    for (ymuint k = 0; k < nw; ++ k) {
+      ov[i * nw + k] = src[k] ^ mask;
+    }
+  }
+}
+
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimNaive3W::node_num() const
+{
+  return mNodeNum;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,202 @@
+﻿#ifndef LSIMNAIVE3W_H
+#define LSIMNAIVE3W_H
+
+/// @file LsimNaive3W.h
+/// @brief LsimNaive3W のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Lsim.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimNaive3W LsimNaive3W.h "LsimNaive3W.h"
+/// @brief LsimNaive3 を複数ワード幅に拡張した Lsim の実装
+///
+/// 1回のトポロジカル順の走査で word_num() x 64 個のパタンを評価する．
+/// word_num() は 1, 2, 4, 8 のいずれかで，それぞれ
+/// スカラ/SSE2/AVX2/AVX-512 で評価される．
+/// AVX2/AVX-512 は CPU が対応している時だけ用い，そうでない時は
+/// 同じワード数をベースラインの命令で評価する．
+//////////////////////////////////////////////////////////////////////
+class LsimNaive3W :
+  public Lsim
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] word_num 1回の評価で用いるワード数(1, 2, 4, 8)
+  /// @note word_num = 0 の時は CPU の機能を調べて 2, 4, 8 のいずれかを選ぶ．
+  explicit
+  LsimNaive3W(ymuint word_num = 0);
+
+  /// @brief デストラクタ
+  virtual
+  ~LsimNaive3W();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // Lsim の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ネットワークをセットする．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] order_map 順序マップ
+  virtual
+  void
+  set_network(const BdnMgr& bdn,
+	      const unordered_map<string, ymuint>& order_map);
+
+  /// @brief 論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @note 1ワード(64パタン)分の評価を行う．
+  virtual
+  void
+  eval(const vector<ymuint64>& iv,
+       vector<ymuint64>& ov);
+
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // LsimNaive3W に固有の関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 1回の評価で用いるワード数を返す．
+  ymuint
+  word_num() const;
+
+  /// @brief word_num() ワード分の論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @note i 番目の入力の k ワード目の値は iv[i * word_num() + k] に入れる．
+  /// @note ov も同様
+  void
+  eval_wide(const vector<ymuint64>& iv,
+	    vector<ymuint64>& ov);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief eval_mt() で用いる作業領域のサイズを返す．
+  virtual
+  ymuint
+  work_size() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる型
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 評価関数の型
+  /// @param[in] fanin_array ファンインの配列
+  /// @param[in] top 先頭の論理ノードの番号
+  /// @param[in] nn 論理ノード数
+  /// @param[in] val_array 値の配列
+  typedef void (*EvalFunc)(const ymuint32* fanin_array,
+			   ymuint top,
+			   ymuint nn,
+			   ymuint64* val_array);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ワード数に対応した評価関数をセットする．
+  void
+  set_word_num(ymuint word_num);
+
+  /// @brief 評価の本体
+  /// @param[in] func 評価関数
+  /// @param[in] nw ワード数
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] val_array 値の配列
+  void
+  eval_sub(EvalFunc func,
+	   ymuint nw,
+	   const vector<ymuint64>& iv,
+	   vector<ymuint64>& ov,
+	   ymuint64* val_array) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 1回の評価で用いるワード数
+  ymuint32 mWordNum;
+
+  // mWordNum に対応した評価関数
+  EvalFunc mEvalFunc;
+
+  // 入力数
+  ymuint32 mInputNum;
+
+  // 論理ノード数
+  ymuint32 mNodeNum;
+
+  // 論理ノードのファンインの配列
+  // ノード番号 * 2 + 極性で符号化した値をノードごとに2つずつ持つ．
+  // 0 番目は定数0，1 〜 mInputNum 番目は入力を表す．
+  vector<ymuint32> mFaninArray;
+
+  // 出力の配列
+  // 符号化の方法は mFaninArray と同じ
+  vector<ymuint32> mOutputList;
+
+  // 値の配列
+  // ノード番号 * mWordNum から mWordNum ワード分を用いる．
+  vector<ymuint64> mValArray;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 1回の評価で用いるワード数を返す．
+inline
+ymuint
+LsimNaive3W::word_num() const
+{
+  return mWordNum;
+}
+
+END_NAMESPACE_YM
+
+#endif // LSIMNAIVE3W_H
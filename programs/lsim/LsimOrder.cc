@@ -0,0 +1,143 @@
+﻿
+/// @file LsimOrder.cc
+/// @brief BDD の変数順を求める関数の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimOrder.h"
+#include "BddOrder.h"
+#include "YmNetworks/BdnNode.h"
+#include "YmNetworks/BdnPort.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// @brief 入力ごとの変数番号を求める．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+// @param[out] input_var 入力番号から変数番号を得る配列
+void
+get_input_var(const BdnMgr& bdn,
+	      const unordered_map<string, ymuint>& order_map,
+	      vector<ymuint32>& input_var)
+{
+  const BdnNodeList& input_list = bdn.input_list();
+  ymuint ni = input_list.size();
+  input_var.clear();
+  input_var.resize(ni);
+  if ( order_map.empty() ) {
+    for (ymuint i = 0; i < ni; ++ i) {
+      input_var[i] = i;
+    }
+    return;
+  }
+
+  ymuint i = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    string name = node->port()->name();
+    unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
+    if ( q == order_map.end() ) {
+      cerr << "No map for " << name << endl;
+      abort();
+    }
+    input_var[i] = q->second;
+  }
+}
+
+// @brief 入力ごとの変数番号から順序マップを作る．
+// @param[in] bdn 対象のネットワーク
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @param[out] order_map 順序マップ
+void
+set_order_map(const BdnMgr& bdn,
+	      const vector<ymuint32>& input_var,
+	      unordered_map<string, ymuint>& order_map)
+{
+  order_map.clear();
+  ymuint i = 0;
+  const BdnNodeList& input_list = bdn.input_list();
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ i) {
+    const BdnNode* node = *p;
+    order_map.insert(make_pair(node->port()->name(), input_var[i]));
+  }
+}
+
+END_NONAMESPACE
+
+
+// @brief ネットワークの構造から静的に変数順を求める．
+// @param[in] bdn 対象のネットワーク
+// @param[in] method 手法名
+// @param[out] order_map 順序マップ
+// @retval true 成功した．
+// @retval false method が未知の手法だった．
+bool
+static_order(const BdnMgr& bdn,
+	     const string& method,
+	     unordered_map<string, ymuint>& order_map)
+{
+  vector<ymuint32> input_var;
+  if ( !static_order(bdn, method, input_var) ) {
+    return false;
+  }
+
+  set_order_map(bdn, input_var, order_map);
+
+  return true;
+}
+
+// @brief sifting で変数順を改善する．
+// @param[in] bdn 対象のネットワーク
+// @param[inout] order_map 順序マップ
+// @param[in] window 1つの変数を動かす範囲(0 の時は全範囲)
+// @param[in] max_pass 全変数を動かす処理を繰り返す最大回数
+// @return 最終的な全出力の BDD のノード数を返す．
+// @note order_map が空の時は入力順から始める．
+ymuint64
+sift_order(const BdnMgr& bdn,
+	   unordered_map<string, ymuint>& order_map,
+	   ymuint window,
+	   ymuint max_pass)
+{
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+
+  vector<ymuint32> input_var;
+  get_input_var(bdn, order_map, input_var);
+
+  // 全ての論理ノードを作った時点で生きているノード数は
+  // 全出力の BDD のノード数になる．
+  ymuint64 size = sift_order(bdn, node_list, node_list.size(), input_var,
+			     window, max_pass);
+
+  set_order_map(bdn, input_var, order_map);
+
+  return size;
+}
+
+// @brief 変数順に対する全出力の BDD のノード数を求める．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+// @note order_map が空の時は入力順を用いる．
+ymuint64
+order_bdd_size(const BdnMgr& bdn,
+	       const unordered_map<string, ymuint>& order_map)
+{
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+
+  vector<ymuint32> input_var;
+  get_input_var(bdn, order_map, input_var);
+
+  return bdd_live_num(bdn, node_list, node_list.size(), input_var);
+}
+
+END_NAMESPACE_YM
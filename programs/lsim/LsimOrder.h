@@ -0,0 +1,64 @@
+﻿#ifndef LSIMORDER_H
+#define LSIMORDER_H
+
+/// @file LsimOrder.h
+/// @brief BDD の変数順を求める関数のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+///
+/// 変数順は Lsim::set_network() に渡す順序マップ(入力名から変数番号へ
+/// のマップ)の形で表す．
+/// 変数順を求める処理は makebdd と共通で，ここでは順序マップと
+/// BddOrder.h の input_var の形の変換だけを行う．
+/// そのため programs/common をインクルードパスに加えて ymapps_common
+/// ライブラリ(programs/common/CMakeLists.txt)をリンクする必要がある．
+
+
+#include "YmNetworks/BdnMgr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+/// @brief ネットワークの構造から静的に変数順を求める．
+/// @param[in] bdn 対象のネットワーク
+/// @param[in] method 手法名
+/// @param[out] order_map 順序マップ
+/// @retval true 成功した．
+/// @retval false method が未知の手法だった．
+/// @note method は以下のいずれか
+///  - "dfs"   出力から深さ優先でたどり，現れた順に入力を並べる．
+///  - "depth" 深い出力から順に，深いファンインを先にたどる．
+bool
+static_order(const BdnMgr& bdn,
+	     const string& method,
+	     unordered_map<string, ymuint>& order_map);
+
+/// @brief sifting で変数順を改善する．
+/// @param[in] bdn 対象のネットワーク
+/// @param[inout] order_map 順序マップ
+/// @param[in] window 1つの変数を動かす範囲(0 の時は全範囲)
+/// @param[in] max_pass 全変数を動かす処理を繰り返す最大回数
+/// @return 最終的な全出力の BDD のノード数を返す．
+/// @note order_map が空の時は入力順から始める．
+/// @note BddMgr は動的な変数順の変更ができないので，
+/// 変数順を変えるたびにネットワークから BDD を作り直して大きさを比べる．
+/// 作り直す回数の抑え方は BddOrder.h の sift_order() を参照のこと．
+ymuint64
+sift_order(const BdnMgr& bdn,
+	   unordered_map<string, ymuint>& order_map,
+	   ymuint window,
+	   ymuint max_pass);
+
+/// @brief 変数順に対する全出力の BDD のノード数を求める．
+/// @param[in] bdn 対象のネットワーク
+/// @param[in] order_map 順序マップ
+/// @note order_map が空の時は入力順を用いる．
+ymuint64
+order_bdd_size(const BdnMgr& bdn,
+	       const unordered_map<string, ymuint>& order_map);
+
+END_NAMESPACE_YM
+
+#endif // LSIMORDER_H
@@ -0,0 +1,382 @@
+﻿
+/// @file LsimPattern.cc
+/// @brief LsimPatternReader の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimPattern.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 識別子
+const ymuint32 kPatternMagic = 0x5450534CU; // "LSPT"
+
+// ファイル形式のバージョン
+const ymuint32 kPatternVersion = 1;
+
+// ヘッダのサイズ
+const ymuint kHeaderSize = 32;
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimPatternReader
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+LsimPatternReader::LsimPatternReader() :
+  mTop(NULL),
+  mSize(0),
+  mPos(0),
+  mBinary(false),
+  mRestNum(0),
+  mLineNo(0),
+  mInputNum(0),
+  mBatchSize(0),
+  mPatternNum(0),
+  mReadPos(0),
+  mStop(false),
+  mError(false)
+{
+}
+
+// @brief デストラクタ
+LsimPatternReader::~LsimPatternReader()
+{
+  close();
+}
+
+// @brief ファイルを開いて読み込み用のスレッドを起動する．
+// @param[in] filename ファイル名
+// @param[in] input_num 入力数
+// @param[in] batch_size 1つのバッチのワード数(1以上)
+// @retval true 成功した．
+// @retval false ファイルが読めないか入力数が一致しなかった．
+bool
+LsimPatternReader::open(const string& filename,
+			ymuint input_num,
+			ymuint batch_size)
+{
+  ASSERT_COND( batch_size > 0 );
+
+  close();
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if ( fd < 0 ) {
+    cerr << "Could not open " << filename << endl;
+    return false;
+  }
+  struct stat sbuf;
+  if ( fstat(fd, &sbuf) != 0 ) {
+    ::close(fd);
+    cerr << "Could not stat " << filename << endl;
+    return false;
+  }
+  mSize = sbuf.st_size;
+  if ( mSize > 0 ) {
+    void* top = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ( top == MAP_FAILED ) {
+      ::close(fd);
+      cerr << "Could not map " << filename << endl;
+      return false;
+    }
+    mTop = reinterpret_cast<const char*>(top);
+    // 先頭から順に読むだけなので先読みさせる．
+    madvise(top, mSize, MADV_SEQUENTIAL);
+  }
+  // 写像した後はファイルを閉じてもよい．
+  ::close(fd);
+
+  mPos = 0;
+  mLineNo = 0;
+  mInputNum = input_num;
+  mBatchSize = batch_size;
+  mPatternNum = 0;
+
+  ymuint32 magic = 0U;
+  if ( mSize >= kHeaderSize ) {
+    memcpy(&magic, mTop, sizeof(ymuint32));
+  }
+  mBinary = (magic == kPatternMagic);
+  if ( mBinary ) {
+    ymuint32 version;
+    ymuint64 ni;
+    memcpy(&version, mTop + 4, sizeof(ymuint32));
+    memcpy(&ni, mTop + 8, sizeof(ymuint64));
+    memcpy(&mRestNum, mTop + 16, sizeof(ymuint64));
+    if ( version != kPatternVersion ) {
+      cerr << filename << ": unknown version " << version << endl;
+      unmap();
+      return false;
+    }
+    if ( ni != input_num ) {
+      cerr << filename << ": input number mismatch("
+	   << ni << " != " << input_num << ")" << endl;
+      unmap();
+      return false;
+    }
+    ymuint64 nw = (mRestNum + 63) / 64;
+    if ( (mSize - kHeaderSize) / 8 / (ni > 0 ? ni : 1) < nw ) {
+      cerr << filename << ": file is too short" << endl;
+      unmap();
+      return false;
+    }
+    mPos = kHeaderSize;
+  }
+
+  for (ymuint i = 0; i < 2; ++ i) {
+    mBuffer[i].mNum = 0;
+    mBuffer[i].mFull = false;
+  }
+  mReadPos = 0;
+  mStop = false;
+  mError = false;
+  mThread = std::thread(&LsimPatternReader::reader_main, this);
+
+  return true;
+}
+
+// @brief 次のバッチを取り出す．
+// @param[out] iv_list 入力ベクタのリスト
+// @param[out] mask_list 各ワードの有効なビットを表すマスクのリスト
+// @return 取り出したワード数を返す．末尾に達したら 0 を返す．
+// @note iv_list と mask_list の中身はバッファと交換するので
+// 前のバッチで得たものをそのまま渡せばよい．
+ymuint
+LsimPatternReader::read_batch(vector<vector<ymuint64> >& iv_list,
+			      vector<ymuint64>& mask_list)
+{
+  if ( !mThread.joinable() ) {
+    return 0;
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  Buffer& buf = mBuffer[mReadPos];
+  while ( !buf.mFull ) {
+    mCond.wait(lock);
+  }
+  ymuint n = buf.mNum;
+  if ( n == 0 ) {
+    // 末尾を表すバッファはそのまま残しておく．
+    return 0;
+  }
+  iv_list.swap(buf.mIvList);
+  mask_list.swap(buf.mMaskList);
+  buf.mFull = false;
+  mReadPos ^= 1;
+  lock.unlock();
+  mCond.notify_all();
+
+  for (ymuint i = 0; i < n; ++ i) {
+    ymuint64 mask = mask_list[i];
+    while ( mask ) {
+      mask &= mask - 1;
+      ++ mPatternNum;
+    }
+  }
+  return n;
+}
+
+// @brief ファイルを閉じる．
+// @note 読み込み用のスレッドが動いていたら止める．
+void
+LsimPatternReader::close()
+{
+  if ( mThread.joinable() ) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mCond.notify_all();
+    mThread.join();
+  }
+  unmap();
+}
+
+// @brief これまでに取り出したパタン数を返す．
+ymuint64
+LsimPatternReader::pattern_num() const
+{
+  return mPatternNum;
+}
+
+// @brief 読み込み中にエラーが起きたら true を返す．
+// @note エラーの時はその直前の行までを含むバッチを返した後で
+// read_batch() が 0 を返す．
+bool
+LsimPatternReader::error() const
+{
+  // mError は末尾を表すバッファを置く前に設定されるので，
+  // read_batch() が 0 を返した後なら排他制御なしで読める．
+  return mError;
+}
+
+// @brief 読み込み用のスレッドの本体
+void
+LsimPatternReader::reader_main()
+{
+  for (ymuint pos = 0; ; pos ^= 1) {
+    Buffer& buf = mBuffer[pos];
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      while ( buf.mFull && !mStop ) {
+	mCond.wait(lock);
+      }
+      if ( mStop ) {
+	return;
+      }
+    }
+
+    // 空のバッファは読み出し側が触らないので排他制御の外で作る．
+    if ( mBinary ) {
+      fill_binary(buf);
+    }
+    else {
+      fill_text(buf);
+    }
+
+    ymuint n = buf.mNum;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      buf.mFull = true;
+    }
+    mCond.notify_all();
+    if ( n == 0 ) {
+      return;
+    }
+  }
+}
+
+// @brief バイナリ形式のバッチを作る．
+// @param[in] buf 対象のバッファ
+void
+LsimPatternReader::fill_binary(Buffer& buf)
+{
+  ymuint ni = mInputNum;
+  ymuint n = 0;
+  buf.mIvList.resize(mBatchSize);
+  buf.mMaskList.resize(mBatchSize);
+  for ( ; n < mBatchSize && mRestNum > 0; ++ n) {
+    vector<ymuint64>& iv = buf.mIvList[n];
+    iv.resize(ni);
+    if ( ni > 0 ) {
+      memcpy(&iv[0], mTop + mPos, ni * sizeof(ymuint64));
+    }
+    mPos += ni * sizeof(ymuint64);
+    if ( mRestNum >= 64 ) {
+      buf.mMaskList[n] = ~0UL;
+      mRestNum -= 64;
+    }
+    else {
+      buf.mMaskList[n] = (1UL << mRestNum) - 1UL;
+      mRestNum = 0;
+    }
+  }
+  buf.mNum = n;
+}
+
+// @brief テキスト形式のバッチを作る．
+// @param[in] buf 対象のバッファ
+void
+LsimPatternReader::fill_text(Buffer& buf)
+{
+  ymuint ni = mInputNum;
+  ymuint n = 0;
+  ymuint b = 0;
+  buf.mIvList.resize(mBatchSize);
+  buf.mMaskList.resize(mBatchSize);
+  while ( n < mBatchSize && mPos < mSize ) {
+    // 1行を切り出す．
+    const char* line = mTop + mPos;
+    const char* end = reinterpret_cast<const char*>(memchr(line, '\n',
+							    mSize - mPos));
+    if ( end == NULL ) {
+      end = mTop + mSize;
+    }
+    mPos = (end - mTop) + 1;
+    ++ mLineNo;
+
+    const char* p = line;
+    while ( p < end && isspace(*p) ) {
+      ++ p;
+    }
+    if ( p == end || *p == '#' ) {
+      continue;
+    }
+
+    vector<ymuint64>& iv = buf.mIvList[n];
+    if ( b == 0 ) {
+      iv.clear();
+      iv.resize(ni, 0UL);
+    }
+    ymuint64 bit = 1UL << b;
+    ymuint i = 0;
+    for ( ; p < end; ++ p) {
+      char c = *p;
+      if ( isspace(c) ) {
+	continue;
+      }
+      if ( (c != '0' && c != '1') || i >= ni ) {
+	break;
+      }
+      if ( c == '1' ) {
+	iv[i] |= bit;
+      }
+      ++ i;
+    }
+    if ( p != end || i != ni ) {
+      cerr << "Error in pattern file at line " << mLineNo
+	   << ": expected " << ni << " digits of '0' or '1'" << endl;
+      // この行の途中まで立てたビットを消して，それまでの行は評価する．
+      for (ymuint j = 0; j < ni; ++ j) {
+	iv[j] &= ~bit;
+      }
+      std::lock_guard<std::mutex> lock(mMutex);
+      mError = true;
+      break;
+    }
+
+    ++ b;
+    if ( b == 64 ) {
+      buf.mMaskList[n] = ~0UL;
+      ++ n;
+      b = 0;
+    }
+  }
+  if ( b > 0 ) {
+    // 最後の端数のワード
+    buf.mMaskList[n] = (1UL << b) - 1UL;
+    ++ n;
+  }
+  if ( mError ) {
+    // エラーの後は何も読まない．
+    mPos = mSize;
+  }
+  buf.mNum = n;
+}
+
+// @brief 写像した領域を解放する．
+void
+LsimPatternReader::unmap()
+{
+  if ( mTop != NULL ) {
+    munmap(const_cast<char*>(mTop), mSize);
+    mTop = NULL;
+  }
+  mSize = 0;
+  mPos = 0;
+}
+
+END_NAMESPACE_YM
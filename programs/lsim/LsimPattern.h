@@ -0,0 +1,209 @@
+﻿#ifndef LSIMPATTERN_H
+#define LSIMPATTERN_H
+
+/// @file LsimPattern.h
+/// @brief LsimPatternReader のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// パタンファイルの形式
+//
+// バイナリ形式
+//   ヘッダ(32バイト)
+//     ymuint32 識別子("LSPT")
+//     ymuint32 ファイル形式のバージョン(1)
+//     ymuint64 入力数
+//     ymuint64 パタン数
+//     ymuint64 予約(0)
+//   本体
+//     64パタンごとに入力数分の ymuint64 を入力順に並べる．
+//     j 番目のワードのビット b が (64 * ワード番号 + b) 番目のパタンの
+//     j 番目の入力の値を表す．最後のワードの余ったビットは 0 にする．
+//   数値はこのマシンのバイト順で書く．
+//
+// テキスト形式
+//   1行に1パタンを '0' と '1' の並びで書く．
+//   i 文字目が i 番目の入力の値を表す．空白は読み飛ばす．
+//   空行と '#' で始まる行は無視する．
+//
+// 先頭が識別子ならバイナリ形式，そうでなければテキスト形式とみなす．
+//////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimPatternReader LsimPattern.h "LsimPattern.h"
+/// @brief パタンファイルを少しずつ読み込むクラス
+///
+/// ファイルは mmap() で写像し，読み込み用のスレッドが次のバッチを
+/// 作っている間に前のバッチを評価できるように2つのバッファを交互に
+/// 用いる．
+//////////////////////////////////////////////////////////////////////
+class LsimPatternReader
+{
+public:
+
+  /// @brief コンストラクタ
+  LsimPatternReader();
+
+  /// @brief デストラクタ
+  ~LsimPatternReader();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ファイルを開いて読み込み用のスレッドを起動する．
+  /// @param[in] filename ファイル名
+  /// @param[in] input_num 入力数
+  /// @param[in] batch_size 1つのバッチのワード数(1以上)
+  /// @retval true 成功した．
+  /// @retval false ファイルが読めないか入力数が一致しなかった．
+  bool
+  open(const string& filename,
+       ymuint input_num,
+       ymuint batch_size);
+
+  /// @brief 次のバッチを取り出す．
+  /// @param[out] iv_list 入力ベクタのリスト
+  /// @param[out] mask_list 各ワードの有効なビットを表すマスクのリスト
+  /// @return 取り出したワード数を返す．末尾に達したら 0 を返す．
+  /// @note iv_list と mask_list の中身はバッファと交換するので
+  /// 前のバッチで得たものをそのまま渡せばよい．
+  ymuint
+  read_batch(vector<vector<ymuint64> >& iv_list,
+	     vector<ymuint64>& mask_list);
+
+  /// @brief ファイルを閉じる．
+  /// @note 読み込み用のスレッドが動いていたら止める．
+  void
+  close();
+
+  /// @brief これまでに取り出したパタン数を返す．
+  ymuint64
+  pattern_num() const;
+
+  /// @brief 読み込み中にエラーが起きたら true を返す．
+  /// @note エラーの時はその直前の行までを含むバッチを返した後で
+  /// read_batch() が 0 を返す．
+  bool
+  error() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // バッファ
+  struct Buffer
+  {
+    // 入力ベクタのリスト
+    vector<vector<ymuint64> > mIvList;
+
+    // 有効なビットのマスクのリスト
+    vector<ymuint64> mMaskList;
+
+    // ワード数(0 なら末尾)
+    ymuint mNum;
+
+    // 読み込み済みの時 true
+    bool mFull;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 読み込み用のスレッドの本体
+  void
+  reader_main();
+
+  /// @brief バイナリ形式のバッチを作る．
+  /// @param[in] buf 対象のバッファ
+  void
+  fill_binary(Buffer& buf);
+
+  /// @brief テキスト形式のバッチを作る．
+  /// @param[in] buf 対象のバッファ
+  void
+  fill_text(Buffer& buf);
+
+  /// @brief 写像した領域を解放する．
+  void
+  unmap();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 写像した領域の先頭
+  const char* mTop;
+
+  // 写像した領域のサイズ
+  ymuint64 mSize;
+
+  // 次に読む位置
+  ymuint64 mPos;
+
+  // バイナリ形式の時 true
+  bool mBinary;
+
+  // バイナリ形式の残りのパタン数
+  ymuint64 mRestNum;
+
+  // テキスト形式の現在の行番号
+  ymuint mLineNo;
+
+  // 入力数
+  ymuint mInputNum;
+
+  // 1つのバッチのワード数
+  ymuint mBatchSize;
+
+  // これまでに取り出したパタン数
+  ymuint64 mPatternNum;
+
+  // 2つのバッファ
+  Buffer mBuffer[2];
+
+  // 次に取り出すバッファの番号
+  ymuint mReadPos;
+
+  // 読み込み用のスレッドを止める時 true
+  bool mStop;
+
+  // エラーが起きた時 true
+  bool mError;
+
+  // mBuffer, mStop, mError を守る排他制御
+  std::mutex mMutex;
+
+  // バッファの状態の変化を伝える条件変数
+  std::condition_variable mCond;
+
+  // 読み込み用のスレッド
+  std::thread mThread;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // LSIMPATTERN_H
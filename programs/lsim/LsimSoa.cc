@@ -0,0 +1,361 @@
+﻿
+/// @file LsimSoa.cc
+/// @brief LsimSoa の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "LsimSoa.h"
+#include "LsimImage.h"
+#include "YmNetworks/BdnNode.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+inline
+ymuint64
+inv_mask(bool inv)
+{
+  return inv ? ~0UL : 0UL;
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス LsimSoa
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+LsimSoa::LsimSoa() :
+  mInputNum(0),
+  mNodeNum(0)
+{
+}
+
+// @brief デストラクタ
+LsimSoa::~LsimSoa()
+{
+}
+
+// @brief ネットワークをセットする．
+// @param[in] bdn 対象のネットワーク
+// @param[in] order_map 順序マップ
+void
+LsimSoa::set_network(const BdnMgr& bdn,
+		     const unordered_map<string, ymuint>& order_map)
+{
+  ymuint n = bdn.max_node_id();
+
+  // BdnNode の ID 番号から値の位置を得る配列
+  vector<ymuint32> pos_map(n, 0U);
+
+  const BdnNodeList& input_list = bdn.input_list();
+  mInputNum = input_list.size();
+  ymuint32 pos = 1;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    pos_map[node->id()] = pos;
+  }
+
+  vector<const BdnNode*> node_list;
+  bdn.sort(node_list);
+  mNodeNum = node_list.size();
+
+  // レベルを求める．
+  // 入力のレベルは 0
+  vector<ymuint32> level_map(n, 0U);
+  ymuint max_level = 0;
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    ymuint level0 = level_map[node->fanin(0)->id()];
+    ymuint level1 = level_map[node->fanin(1)->id()];
+    ymuint level = (level0 > level1) ? level0 : level1;
+    ++ level;
+    level_map[node->id()] = level;
+    if ( max_level < level ) {
+      max_level = level;
+    }
+  }
+
+  // レベルごとに AND と XOR に分けた数を数える．
+  mAndNum.clear();
+  mAndNum.resize(max_level, 0U);
+  vector<ymuint32> xor_num(max_level, 0U);
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    ymuint level = level_map[node->id()] - 1;
+    if ( node->is_xor() ) {
+      ++ xor_num[level];
+    }
+    else {
+      ++ mAndNum[level];
+    }
+  }
+
+  // 各グループの先頭位置を求める．
+  mAndTop.clear();
+  mAndTop.resize(max_level + 1, 0U);
+  vector<ymuint32> and_next(max_level);
+  vector<ymuint32> xor_next(max_level);
+  ymuint top = 0;
+  for (ymuint i = 0; i < max_level; ++ i) {
+    mAndTop[i] = top;
+    and_next[i] = top;
+    xor_next[i] = top + mAndNum[i];
+    top += mAndNum[i] + xor_num[i];
+  }
+  mAndTop[max_level] = top;
+  ASSERT_COND( top == mNodeNum );
+
+  // 論理ノードの位置を決める．
+  vector<const BdnNode*> pos_list(mNodeNum);
+  ymuint base = mInputNum + 1;
+  for (vector<const BdnNode*>::iterator p = node_list.begin();
+       p != node_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    ymuint level = level_map[node->id()] - 1;
+    ymuint32 idx;
+    if ( node->is_xor() ) {
+      idx = xor_next[level];
+      ++ xor_next[level];
+    }
+    else {
+      idx = and_next[level];
+      ++ and_next[level];
+    }
+    pos_list[idx] = node;
+    pos_map[node->id()] = idx + base;
+  }
+
+  // ファンインの配列を作る．
+  mFanin0.clear();
+  mFanin0.resize(mNodeNum);
+  mFanin1.clear();
+  mFanin1.resize(mNodeNum);
+  mMask0.clear();
+  mMask0.resize(mNodeNum);
+  mMask1.clear();
+  mMask1.resize(mNodeNum);
+  for (ymuint i = 0; i < mNodeNum; ++ i) {
+    const BdnNode* node = pos_list[i];
+    mFanin0[i] = pos_map[node->fanin(0)->id()];
+    mFanin1[i] = pos_map[node->fanin(1)->id()];
+    mMask0[i] = inv_mask(node->fanin_inv(0));
+    mMask1[i] = inv_mask(node->fanin_inv(1));
+  }
+
+  const BdnNodeList& output_list = bdn.output_list();
+  ymuint no = output_list.size();
+  mOutputPos.clear();
+  mOutputPos.reserve(no);
+  mOutputMask.clear();
+  mOutputMask.reserve(no);
+  for (BdnNodeList::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p) {
+    const BdnNode* node = *p;
+    const BdnNode* inode = node->output_fanin();
+    ymuint32 pos = 0U;
+    if ( inode != NULL ) {
+      pos = pos_map[inode->id()];
+    }
+    mOutputPos.push_back(pos);
+    mOutputMask.push_back(inv_mask(node->output_fanin_inv()));
+  }
+
+  mValArray.clear();
+  mValArray.resize(work_size(), 0UL);
+
+  cout << "Node num:  " << mNodeNum << endl
+       << "Level num: " << max_level << endl;
+}
+
+// @brief 論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+void
+LsimSoa::eval(const vector<ymuint64>& iv,
+	      vector<ymuint64>& ov)
+{
+  eval_mt(iv, ov, mValArray);
+}
+
+// @brief eval_mt() を実装している時 true を返す．
+bool
+LsimSoa::has_eval_mt() const
+{
+  return true;
+}
+
+// @brief eval_mt() で用いる作業領域のサイズを返す．
+ymuint
+LsimSoa::work_size() const
+{
+  return mInputNum + mNodeNum + 1;
+}
+
+// @brief 作業領域を指定して論理シミュレーションを行う．
+// @param[in] iv 入力ベクタ
+// @param[out] ov 出力ベクタ
+// @param[in] work 作業領域(値の配列)
+void
+LsimSoa::eval_mt(const vector<ymuint64>& iv,
+		 vector<ymuint64>& ov,
+		 vector<ymuint64>& work) const
+{
+  ymuint ni = mInputNum;
+  ASSERT_COND( ni == iv.size() );
+
+  ymuint64* val_array = &work[0];
+  val_array[0] = 0UL;
+  for (ymuint i = 0; i < ni; ++ i) {
+    val_array[i + 1] = iv[i];
+  }
+
+  // 論理ノードがない時は配列が空なので先頭の要素を参照できない．
+  // その時は下のループも回らない．
+  bool empty = mFanin0.empty();
+  const ymuint32* fanin0 = empty ? NULL : &mFanin0[0];
+  const ymuint32* fanin1 = empty ? NULL : &mFanin1[0];
+  const ymuint64* mask0 = empty ? NULL : &mMask0[0];
+  const ymuint64* mask1 = empty ? NULL : &mMask1[0];
+  ymuint64* dst = val_array + ni + 1;
+  ymuint nl = mAndNum.size();
+  for (ymuint l = 0; l < nl; ++ l) {
+    ymuint start = mAndTop[l];
+    ymuint mid = start + mAndNum[l];
+    ymuint end = mAndTop[l + 1];
+    for (ymuint i = start; i < mid; ++ i) {
+      ymuint64 val0 = val_array[fanin0[i]] ^ mask0[i];
+      ymuint64 val1 = val_array[fanin1[i]] ^ mask1[i];
+      dst[i] = val0 & val1;
+    }
+    for (ymuint i = mid; i < end; ++ i) {
+      ymuint64 val0 = val_array[fanin0[i]] ^ mask0[i];
+      ymuint64 val1 = val_array[fanin1[i]] ^ mask1[i];
+      dst[i] = val0 ^ val1;
+    }
+  }
+
+  ymuint no = mOutputPos.size();
+  for (ymuint i = 0; i < no; ++ i) {
+    ov[i] = val_array[mOutputPos[i]] ^ mOutputMask[i];
+  }
+}
+
+// @brief 評価に用いるノード数を返す．
+ymuint
+LsimSoa::node_num() const
+{
+  return mNodeNum;
+}
+
+// @brief イメージファイルに記録する手法名を返す．
+const char*
+LsimSoa::image_name() const
+{
+  return "soa";
+}
+
+// @brief イメージファイルの形式のバージョンを返す．
+ymuint32
+LsimSoa::image_version() const
+{
+  return 1;
+}
+
+// @brief set_network() で作った内容をイメージファイルに書き出す．
+// @param[in] writer 書き出し用のオブジェクト
+void
+LsimSoa::write_image(LsimImageWriter& writer) const
+{
+  writer.write_64(mInputNum);
+  writer.write_64(mNodeNum);
+  writer.write_array(mAndTop);
+  writer.write_array(mAndNum);
+  writer.write_array(mFanin0);
+  writer.write_array(mFanin1);
+  writer.write_array(mMask0);
+  writer.write_array(mMask1);
+  writer.write_array(mOutputPos);
+  writer.write_array(mOutputMask);
+}
+
+// @brief イメージファイルの内容を読み込む．
+// @param[in] reader 読み込み用のオブジェクト
+// @retval true 読み込みが成功した．
+// @retval false 読み込みが失敗した．
+bool
+LsimSoa::read_image(LsimImageReader& reader)
+{
+  ymuint64 ni;
+  ymuint64 nn;
+  if ( !reader.read_64(ni) ||
+       !reader.read_64(nn) ||
+       !reader.read_array(mAndTop) ||
+       !reader.read_array(mAndNum) ||
+       !reader.read_array(mFanin0) ||
+       !reader.read_array(mFanin1) ||
+       !reader.read_array(mMask0) ||
+       !reader.read_array(mMask1) ||
+       !reader.read_array(mOutputPos) ||
+       !reader.read_array(mOutputMask) ) {
+    return false;
+  }
+  if ( mAndTop.size() != mAndNum.size() + 1 ||
+       mFanin0.size() != nn ||
+       mFanin1.size() != nn ||
+       mMask0.size() != nn ||
+       mMask1.size() != nn ||
+       mOutputMask.size() != mOutputPos.size() ) {
+    return false;
+  }
+
+  // ファイルが壊れていても範囲外を参照しないように番号を確かめる．
+  if ( ni > 0xFFFFFFFFUL || nn > 0xFFFFFFFFUL ) {
+    return false;
+  }
+  ymuint64 nv = ni + nn + 1;
+  if ( nv > 0xFFFFFFFFUL ) {
+    return false;
+  }
+  ymuint nl = mAndNum.size();
+  if ( mAndTop[0] != 0U || mAndTop[nl] != nn ) {
+    return false;
+  }
+  for (ymuint l = 0; l < nl; ++ l) {
+    if ( mAndTop[l] > mAndTop[l + 1] ||
+	 mAndNum[l] > mAndTop[l + 1] - mAndTop[l] ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < nn; ++ i) {
+    if ( mFanin0[i] >= nv || mFanin1[i] >= nv ) {
+      return false;
+    }
+  }
+  for (ymuint i = 0; i < mOutputPos.size(); ++ i) {
+    if ( mOutputPos[i] >= nv ) {
+      return false;
+    }
+  }
+
+  mInputNum = ni;
+  mNodeNum = nn;
+  mValArray.clear();
+  mValArray.resize(work_size(), 0UL);
+
+  cout << "Node num:  " << mNodeNum << endl
+       << "Level num: " << mAndNum.size() << endl;
+
+  return true;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,166 @@
+﻿#ifndef LSIMSOA_H
+#define LSIMSOA_H
+
+/// @file LsimSoa.h
+/// @brief LsimSoa のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Lsim.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LsimSoa LsimSoa.h "LsimSoa.h"
+/// @brief レベル順に並べた配列を用いる Lsim の実装
+///
+/// ノードはレベルごとに AND と XOR のグループに分けて並べ，
+/// ファンインの番号と極性のマスクをそれぞれ別の配列に持つ．
+/// 値は1つの連続した配列に入れるので，評価のループは
+/// 分岐なしで配列を順に読むだけになる．
+//////////////////////////////////////////////////////////////////////
+class LsimSoa :
+  public Lsim
+{
+public:
+
+  /// @brief コンストラクタ
+  LsimSoa();
+
+  /// @brief デストラクタ
+  virtual
+  ~LsimSoa();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // Lsim の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ネットワークをセットする．
+  /// @param[in] bdn 対象のネットワーク
+  /// @param[in] order_map 順序マップ
+  virtual
+  void
+  set_network(const BdnMgr& bdn,
+	      const unordered_map<string, ymuint>& order_map);
+
+  /// @brief 論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  virtual
+  void
+  eval(const vector<ymuint64>& iv,
+       vector<ymuint64>& ov);
+
+  /// @brief 評価に用いるノード数を返す．
+  virtual
+  ymuint
+  node_num() const;
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // イメージファイル用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief イメージファイルに記録する手法名を返す．
+  virtual
+  const char*
+  image_name() const;
+
+  /// @brief イメージファイルの形式のバージョンを返す．
+  virtual
+  ymuint32
+  image_version() const;
+
+  /// @brief set_network() で作った内容をイメージファイルに書き出す．
+  /// @param[in] writer 書き出し用のオブジェクト
+  virtual
+  void
+  write_image(LsimImageWriter& writer) const;
+
+  /// @brief イメージファイルの内容を読み込む．
+  /// @param[in] reader 読み込み用のオブジェクト
+  /// @retval true 読み込みが成功した．
+  /// @retval false 読み込みが失敗した．
+  virtual
+  bool
+  read_image(LsimImageReader& reader);
+
+
+protected:
+  //////////////////////////////////////////////////////////////////////
+  // 並列評価用の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief eval_mt() を実装している時 true を返す．
+  virtual
+  bool
+  has_eval_mt() const;
+
+  /// @brief eval_mt() で用いる作業領域のサイズを返す．
+  virtual
+  ymuint
+  work_size() const;
+
+  /// @brief 作業領域を指定して論理シミュレーションを行う．
+  /// @param[in] iv 入力ベクタ
+  /// @param[out] ov 出力ベクタ
+  /// @param[in] work 作業領域(値の配列)
+  virtual
+  void
+  eval_mt(const vector<ymuint64>& iv,
+	  vector<ymuint64>& ov,
+	  vector<ymuint64>& work) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 入力数
+  ymuint32 mInputNum;
+
+  // 論理ノード数
+  ymuint32 mNodeNum;
+
+  // レベルごとの AND ノードの先頭位置
+  // XOR ノードは mAndTop[i] + mAndNum[i] から mAndTop[i + 1] まで
+  vector<ymuint32> mAndTop;
+
+  // レベルごとの AND ノード数
+  vector<ymuint32> mAndNum;
+
+  // ファンイン0の値の位置
+  // 0 は定数0，1 〜 mInputNum は入力を表す．
+  vector<ymuint32> mFanin0;
+
+  // ファンイン1の値の位置
+  vector<ymuint32> mFanin1;
+
+  // ファンイン0の極性を表すマスク(0 か ~0)
+  vector<ymuint64> mMask0;
+
+  // ファンイン1の極性を表すマスク(0 か ~0)
+  vector<ymuint64> mMask1;
+
+  // 出力の値の位置
+  vector<ymuint32> mOutputPos;
+
+  // 出力の極性を表すマスク
+  vector<ymuint64> mOutputMask;
+
+  // 値の配列
+  vector<ymuint64> mValArray;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // LSIMSOA_H
@@ -14,6 +14,8 @@
 #endif
 
 #include "YmNetworks/BdnMgr.h"
+#include "YmNetworks/BdnNode.h"
+#include "YmNetworks/BdnPort.h"
 #include "YmNetworks/BdnBlifReader.h"
 #include "YmNetworks/BdnIscas89Reader.h"
 
@@ -24,17 +26,32 @@
 
 #include "YmUtils/StopWatch.h"
 
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
 #include "LsimNaive.h"
 #include "LsimNaive2.h"
 #include "LsimNaive3.h"
+#include "LsimNaive3W.h"
+#include "LsimSoa.h"
+#include "LsimEvent.h"
 #include "LsimBdd.h"
 #include "LsimBdd1.h"
 #include "LsimBdd2.h"
 #include "LsimBdd3.h"
 #include "LsimBdd10.h"
 #include "LsimLcc.h"
+#include "LsimCodegen.h"
 #include "LsimMpx.h"
 #include "LsimMpx2.h"
+#include "LsimHybrid.h"
+#include "LsimOrder.h"
+#include "LsimPattern.h"
+#include "LsimCompactor.h"
 
 
 BEGIN_NAMESPACE_YM
@@ -84,29 +101,234 @@ read_order(const char* filename,
   return true;
 }
 
+// @brief 変数順を read_order() で読める形式で書き出す．
+// @note order_map が空の時は入力順を書き出す．
+bool
+write_order(const char* filename,
+	    const BdnMgr& network,
+	    const unordered_map<string, ymuint>& order_map)
+{
+  ofstream fs;
+
+  fs.open(filename);
+  if ( !fs ) {
+    cerr << "Could not create " << filename << endl;
+    return false;
+  }
+
+  const BdnNodeList& input_list = network.input_list();
+  vector<string> name_list(input_list.size());
+  ymuint pos = 0;
+  for (BdnNodeList::const_iterator p = input_list.begin();
+       p != input_list.end(); ++ p, ++ pos) {
+    const BdnNode* node = *p;
+    string name = node->port()->name();
+    ymuint var = pos;
+    if ( !order_map.empty() ) {
+      unordered_map<string, ymuint>::const_iterator q = order_map.find(name);
+      ASSERT_COND( q != order_map.end() );
+      var = q->second;
+    }
+    ASSERT_COND( var < name_list.size() );
+    name_list[var] = name;
+  }
+  for (vector<string>::iterator p = name_list.begin();
+       p != name_list.end(); ++ p) {
+    fs << *p << endl;
+  }
+  return true;
+}
+
+// @brief 手法名から Lsim を生成する．
+// @param[in] method_str 手法名
+// @param[in] cache_dir codegen の生成したコードを置くディレクトリ
+// @note 未知の名前の時は NULL を返す．
+// @note cache_dir が空の時は LsimCodegen の既定値を用いる．
+Lsim*
+new_lsim(const string& method_str,
+	 const string& cache_dir)
+{
+  if ( method_str == "naive" ) {
+    return new LsimNaive;
+  }
+  if ( method_str == "naive2" ) {
+    return new LsimNaive2;
+  }
+  if ( method_str == "naive3" ) {
+    return new LsimNaive3;
+  }
+  if ( method_str == "naive3w" ) {
+    return new LsimNaive3W;
+  }
+  if ( method_str == "soa" ) {
+    return new LsimSoa;
+  }
+  if ( method_str == "event" ) {
+    return new LsimEvent;
+  }
+  if ( method_str == "bdd" ) {
+    return new LsimBdd;
+  }
+  if ( method_str == "bdd1" ) {
+    return new LsimBdd1;
+  }
+  if ( method_str == "bdd2" ) {
+    return new LsimBdd2;
+  }
+  if ( method_str == "bdd3" ) {
+    return new LsimBdd3;
+  }
+  if ( method_str == "bdd10" ) {
+    return new LsimBdd10;
+  }
+  if ( method_str == "lcc" ) {
+    return new LsimLcc;
+  }
+  if ( method_str == "codegen" ) {
+    return new LsimCodegen(cache_dir);
+  }
+  if ( method_str == "mpx" ) {
+    return new LsimMpx;
+  }
+  if ( method_str == "mpx2" ) {
+    return new LsimMpx2;
+  }
+  if ( method_str == "hybrid" ) {
+    return new LsimHybrid;
+  }
+  return NULL;
+}
+
+// @brief パタンファイルの入力ベクタで評価する．
+// @note 読み込み用のスレッドが次のバッチを作っている間に評価する．
+// @note compactor が NULL でなければ出力ベクタを足し込む．
+void
+do_lsim_stream(Lsim& lsim,
+	       ymuint thread_num,
+	       BdnMgr& network,
+	       const char* pattern_file,
+	       ymuint batch_size,
+	       LsimCompactor* compactor)
+{
+  LsimPatternReader reader;
+  if ( !reader.open(pattern_file, network.input_num(), batch_size) ) {
+    return;
+  }
+
+  StopWatch sw;
+  sw.start();
+
+  ymuint no = network.output_num();
+  vector<vector<ymuint64> > iv_list;
+  vector<ymuint64> mask_list;
+  vector<vector<ymuint64> > ov_list;
+  ymuint64 nw = 0;
+  for ( ; ; ) {
+    ymuint n = reader.read_batch(iv_list, mask_list);
+    if ( n == 0 ) {
+      break;
+    }
+    // 最後のバッチは短いことがある．
+    iv_list.resize(n);
+    ov_list.resize(n);
+    for (ymuint i = 0; i < n; ++ i) {
+      ov_list[i].resize(no);
+    }
+    if ( thread_num > 0 ) {
+      lsim.eval_batch(iv_list, ov_list, thread_num);
+    }
+    else {
+      for (ymuint i = 0; i < n; ++ i) {
+	lsim.eval(iv_list[i], ov_list[i]);
+      }
+    }
+    if ( compactor != NULL ) {
+      for (ymuint i = 0; i < n; ++ i) {
+	compactor->add(ov_list[i], mask_list[i]);
+      }
+    }
+    nw += n;
+  }
+
+  sw.stop();
+
+  if ( reader.error() ) {
+    cerr << "Error in reading " << pattern_file << endl;
+  }
+
+  USTime time2 = sw.time();
+  cout << "Patterns:         \t" << reader.pattern_num() << endl
+       << "Evaluation[" << nw << "]:\t" << time2 << endl;
+}
+
 void
 do_lsim(Lsim& lsim,
 	ymuint nloop,
+	ymuint thread_num,
 	BdnMgr& network,
-	unordered_map<string, ymuint>& order_map)
+	unordered_map<string, ymuint>& order_map,
+	const string& cache_dir,
+	const char* pattern_file,
+	ymuint batch_size,
+	LsimCompactor* compactor)
 {
   StopWatch sw;
   sw.start();
 
-  lsim.set_network(network, order_map);
+  lsim.set_network_cached(network, order_map, cache_dir);
 
   sw.stop();
 
   USTime time1 = sw.time();
   cout << "Initialize:       \t" << time1 << endl;
 
+  if ( pattern_file != NULL ) {
+    do_lsim_stream(lsim, thread_num, network, pattern_file, batch_size,
+		   compactor);
+    return;
+  }
+
   RandGen rg;
 
+  ymuint ni = network.input_num();
+  ymuint no = network.output_num();
+  if ( thread_num > 0 ) {
+    // バッチモード
+    // 入力ベクタは先に全部作っておく．
+    vector<vector<ymuint64> > iv_list(nloop, vector<ymuint64>(ni));
+    vector<vector<ymuint64> > ov_list(nloop, vector<ymuint64>(no));
+    for (ymuint i = 0; i < nloop; ++ i) {
+      vector<ymuint64>& iv = iv_list[i];
+      for (ymuint j = 0; j < ni; ++ j) {
+	ymuint64 tmp = rg.int32();
+	tmp <<= 32;
+	tmp += rg.int32();
+	iv[j] = tmp;
+      }
+    }
+
+    sw.reset();
+    sw.start();
+
+    lsim.eval_batch(iv_list, ov_list, thread_num);
+
+    sw.stop();
+
+    if ( compactor != NULL ) {
+      for (ymuint i = 0; i < nloop; ++ i) {
+	compactor->add(ov_list[i], ~0UL);
+      }
+    }
+
+    USTime time2 = sw.time();
+    cout << "Evaluation[" << nloop << " x " << thread_num << "]:\t"
+	 << time2 << endl;
+    return;
+  }
+
   sw.reset();
   sw.start();
 
-  ymuint ni = network.input_num();
-  ymuint no = network.output_num();
   vector<ymuint64> iv(ni);
   vector<ymuint64> ov(no);
   for (ymuint i = 0; i < nloop; ++ i) {
@@ -117,12 +339,379 @@ do_lsim(Lsim& lsim,
       iv[j] = tmp;
     }
     lsim.eval(iv, ov);
+    if ( compactor != NULL ) {
+      compactor->add(ov, ~0UL);
+    }
+  }
+
+  sw.stop();
+
+  USTime time2 = sw.time();
+  cout << "Evaluation[" << nloop << "]:\t" << time2 << endl;
+}
+
+void
+do_lsim_wide(LsimNaive3W& lsim,
+	     ymuint nloop,
+	     BdnMgr& network,
+	     unordered_map<string, ymuint>& order_map)
+{
+  StopWatch sw;
+  sw.start();
+
+  lsim.set_network(network, order_map);
+
+  sw.stop();
+
+  USTime time1 = sw.time();
+  cout << "Initialize:       \t" << time1 << endl;
+
+  RandGen rg;
+
+  sw.reset();
+  sw.start();
+
+  // 1回の評価で nw ワード分のパタンを処理するので
+  // ループ回数はその分減らす．
+  ymuint nw = lsim.word_num();
+  ymuint nloop1 = (nloop + nw - 1) / nw;
+  ymuint ni = network.input_num();
+  ymuint no = network.output_num();
+  vector<ymuint64> iv(ni * nw);
+  vector<ymuint64> ov(no * nw);
+  for (ymuint i = 0; i < nloop1; ++ i) {
+    for (ymuint j = 0; j < ni * nw; ++ j) {
+      ymuint64 tmp = rg.int32();
+      tmp <<= 32;
+      tmp += rg.int32();
+      iv[j] = tmp;
+    }
+    lsim.eval_wide(iv, ov);
+  }
+
+  sw.stop();
+
+  USTime time2 = sw.time();
+  cout << "Evaluation[" << nloop1 << " x " << nw << "]:\t" << time2 << endl;
+}
+
+void
+do_lsim_event(LsimEvent& lsim,
+	      ymuint nloop,
+	      ymuint change_num,
+	      BdnMgr& network,
+	      unordered_map<string, ymuint>& order_map)
+{
+  StopWatch sw;
+  sw.start();
+
+  lsim.set_network(network, order_map);
+
+  sw.stop();
+
+  USTime time1 = sw.time();
+  cout << "Initialize:       \t" << time1 << endl;
+
+  RandGen rg;
+
+  sw.reset();
+  sw.start();
+
+  // change_num が 0 でなければ，2回目以降は
+  // ランダムに選んだ change_num 個の入力の値だけを変える．
+  ymuint ni = network.input_num();
+  ymuint no = network.output_num();
+  vector<ymuint64> iv(ni);
+  vector<ymuint64> ov(no);
+  for (ymuint i = 0; i < nloop; ++ i) {
+    if ( i == 0 || change_num == 0 || change_num >= ni ) {
+      for (ymuint j = 0; j < ni; ++ j) {
+	ymuint64 tmp = rg.int32();
+	tmp <<= 32;
+	tmp += rg.int32();
+	iv[j] = tmp;
+      }
+    }
+    else {
+      for (ymuint k = 0; k < change_num; ++ k) {
+	ymuint j = rg.int32() % ni;
+	ymuint64 tmp = rg.int32();
+	tmp <<= 32;
+	tmp += rg.int32();
+	iv[j] = tmp;
+      }
+    }
+    lsim.eval(iv, ov);
   }
 
   sw.stop();
 
   USTime time2 = sw.time();
   cout << "Evaluation[" << nloop << "]:\t" << time2 << endl;
+
+  ymuint64 nn = lsim.node_num();
+  ymuint64 neval = lsim.total_eval_count();
+  ymuint64 nchg = lsim.total_change_count();
+  cout << "Evaluated nodes:  \t" << neval
+       << " (" << (static_cast<double>(neval) / (nn * nloop)) * 100.0
+       << "%)" << endl
+       << "Changed nodes:    \t" << nchg
+       << " (" << (static_cast<double>(nchg) / (nn * nloop)) * 100.0
+       << "%)" << endl;
+}
+
+// ベンチマークの対象の手法
+// lcc は C のコードを出力するだけなので codegen で代用する．
+// 先頭の手法の結果を正解とみなす．
+const char* bench_method_list[] = {
+  "naive", "naive2", "naive3", "naive3w", "soa", "event",
+  "bdd1", "bdd2", "bdd3", "bdd10", "codegen", "mpx", "mpx2",
+  "hybrid",
+  NULL
+};
+
+// ベンチマークの結果
+struct BenchResult
+{
+  // 正常に終了した時 true
+  bool mDone;
+
+  // set_network() の時間(秒)
+  double mInitTime;
+
+  // 評価の時間(秒)
+  double mEvalTime;
+
+  // Lsim::node_num() の値
+  ymuint64 mNodeNum;
+
+  // 最大常駐メモリサイズ(KB)
+  ymuint64 mPeakRss;
+
+  // 全出力のハッシュ値
+  ymuint64 mDigest;
+};
+
+// @brief 1つの手法のベンチマークを子プロセスで行う．
+// @note 途中で abort() しても全体が止まらないように，
+// また手法ごとの最大常駐メモリサイズを測れるように fork() する．
+// 最大常駐メモリサイズは親プロセスから引き継いだ分も含む．
+// @note cache_dir が空でなければイメージファイルを用いる．
+void
+bench_one(const string& method_str,
+	  BdnMgr& network,
+	  unordered_map<string, ymuint>& order_map,
+	  const vector<vector<ymuint64> >& iv_list,
+	  ymuint thread_num,
+	  const string& cache_dir,
+	  BenchResult& result)
+{
+  result.mDone = false;
+
+  int fds[2];
+  if ( pipe(fds) != 0 ) {
+    cerr << "pipe() failed" << endl;
+    return;
+  }
+
+  cout.flush();
+  pid_t pid = fork();
+  if ( pid < 0 ) {
+    cerr << "fork() failed" << endl;
+    close(fds[0]);
+    close(fds[1]);
+    return;
+  }
+
+  if ( pid == 0 ) {
+    // 子プロセス
+    // 各手法の出力するメッセージは捨てる．
+    close(fds[0]);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if ( null_fd >= 0 ) {
+      dup2(null_fd, 1);
+      close(null_fd);
+    }
+
+    Lsim* lsim = new_lsim(method_str, cache_dir);
+    ASSERT_COND( lsim != NULL );
+
+    BenchResult r;
+    r.mDone = true;
+
+    StopWatch sw;
+    sw.start();
+    lsim->set_network_cached(network, order_map, cache_dir);
+    sw.stop();
+    r.mInitTime = sw.time().real_time();
+    r.mNodeNum = lsim->node_num();
+
+    ymuint nloop = iv_list.size();
+    ymuint no = network.output_num();
+    vector<vector<ymuint64> > ov_list(nloop, vector<ymuint64>(no));
+    sw.reset();
+    sw.start();
+    if ( thread_num > 0 ) {
+      lsim->eval_batch(iv_list, ov_list, thread_num);
+    }
+    else {
+      for (ymuint i = 0; i < nloop; ++ i) {
+	lsim->eval(iv_list[i], ov_list[i]);
+      }
+    }
+    sw.stop();
+    r.mEvalTime = sw.time().real_time();
+
+    // FNV-1a 風に出力の値を混ぜる．
+    ymuint64 h = 14695981039346656037UL;
+    for (ymuint i = 0; i < nloop; ++ i) {
+      const vector<ymuint64>& ov = ov_list[i];
+      for (ymuint j = 0; j < no; ++ j) {
+	h ^= ov[j];
+	h *= 1099511628211UL;
+      }
+    }
+    r.mDigest = h;
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    r.mPeakRss = ru.ru_maxrss;
+
+    ssize_t n = write(fds[1], &r, sizeof(r));
+    close(fds[1]);
+    _exit(n == sizeof(r) ? 0 : 1);
+  }
+
+  // 親プロセス
+  close(fds[1]);
+  BenchResult r;
+  ssize_t n = read(fds[0], &r, sizeof(r));
+  close(fds[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  if ( n == sizeof(r) && WIFEXITED(status) && WEXITSTATUS(status) == 0 ) {
+    result = r;
+  }
+}
+
+// @brief 全ての手法のベンチマークを行う．
+// @param[in] filename ファイル名(結果の表示用)
+// @param[in] network 対象のネットワーク
+// @param[in] order_map 順序マップ
+// @param[in] nloop ワード数
+// @param[in] thread_num スレッド数(0 の時は eval() を用いる)
+// @param[in] seed 乱数の種
+// @param[in] format 出力形式("csv" か "json")
+// @param[in] cache_dir イメージファイルを置くディレクトリ
+void
+do_bench(const string& filename,
+	 BdnMgr& network,
+	 unordered_map<string, ymuint>& order_map,
+	 ymuint nloop,
+	 ymuint thread_num,
+	 ymuint seed,
+	 const string& format,
+	 const string& cache_dir)
+{
+  bool json = false;
+  if ( format == "json" ) {
+    json = true;
+  }
+  else if ( format != "csv" ) {
+    cerr << "Unknown format: " << format << endl;
+    return;
+  }
+
+  // 全ての手法で同じ入力ベクタを用いる．
+  RandGen rg;
+  rg.init(seed);
+  ymuint ni = network.input_num();
+  vector<vector<ymuint64> > iv_list(nloop, vector<ymuint64>(ni));
+  for (ymuint i = 0; i < nloop; ++ i) {
+    vector<ymuint64>& iv = iv_list[i];
+    for (ymuint j = 0; j < ni; ++ j) {
+      ymuint64 tmp = rg.int32();
+      tmp <<= 32;
+      tmp += rg.int32();
+      iv[j] = tmp;
+    }
+  }
+
+  vector<BenchResult> result_list;
+  for (ymuint i = 0; bench_method_list[i] != NULL; ++ i) {
+    const char* method_str = bench_method_list[i];
+    cerr << "Running " << method_str << " ..." << endl;
+    BenchResult r;
+    bench_one(method_str, network, order_map, iv_list, thread_num, cache_dir,
+	      r);
+    result_list.push_back(r);
+  }
+
+  const BenchResult& ref = result_list[0];
+  double npat = static_cast<double>(nloop) * 64.0;
+  if ( json ) {
+    cout << "{" << endl
+	 << "  \"design\": \"" << filename << "\"," << endl
+	 << "  \"inputs\": " << ni << "," << endl
+	 << "  \"outputs\": " << network.output_num() << "," << endl
+	 << "  \"patterns\": " << nloop * 64UL << "," << endl
+	 << "  \"threads\": " << thread_num << "," << endl
+	 << "  \"seed\": " << seed << "," << endl
+	 << "  \"results\": [" << endl;
+  }
+  else {
+    cout << "design,method,status,init_s,eval_s,ns_per_pattern,"
+	 << "patterns_per_s,peak_rss_kb,node_num,match" << endl;
+  }
+  ymuint n = result_list.size();
+  for (ymuint i = 0; i < n; ++ i) {
+    const char* method_str = bench_method_list[i];
+    const BenchResult& r = result_list[i];
+    const char* match = "-";
+    if ( r.mDone && ref.mDone ) {
+      match = (r.mDigest == ref.mDigest) ? "yes" : "no";
+    }
+    if ( json ) {
+      cout << "    { \"method\": \"" << method_str << "\", ";
+      if ( r.mDone ) {
+	cout << "\"status\": \"ok\", "
+	     << "\"init_s\": " << r.mInitTime << ", "
+	     << "\"eval_s\": " << r.mEvalTime << ", "
+	     << "\"ns_per_pattern\": " << (r.mEvalTime * 1.0e9) / npat << ", "
+	     << "\"patterns_per_s\": " << npat / r.mEvalTime << ", "
+	     << "\"peak_rss_kb\": " << r.mPeakRss << ", "
+	     << "\"node_num\": " << r.mNodeNum << ", "
+	     << "\"match\": \"" << match << "\" }";
+      }
+      else {
+	cout << "\"status\": \"failed\" }";
+      }
+      if ( i < n - 1 ) {
+	cout << ",";
+      }
+      cout << endl;
+    }
+    else {
+      cout << filename << "," << method_str << ",";
+      if ( r.mDone ) {
+	cout << "ok,"
+	     << r.mInitTime << ","
+	     << r.mEvalTime << ","
+	     << (r.mEvalTime * 1.0e9) / npat << ","
+	     << npat / r.mEvalTime << ","
+	     << r.mPeakRss << ","
+	     << r.mNodeNum << ","
+	     << match << endl;
+      }
+      else {
+	cout << "failed,,,,,,," << match << endl;
+      }
+    }
+  }
+  if ( json ) {
+    cout << "  ]" << endl
+	 << "}" << endl;
+  }
 }
 
 void
@@ -130,8 +719,22 @@ lsim(const string& filename,
      bool blif,
      bool iscas89,
      int loop_count,
+     int thread_num,
+     int change_num,
      const string& method_str,
-     const char* order_file)
+     const char* order_file,
+     const char* bench_format,
+     int seed,
+     const char* lut_file,
+     const char* cache_dir,
+     const char* auto_order,
+     bool sift,
+     int sift_window,
+     const char* order_out_file,
+     const char* pattern_file,
+     int batch_size,
+     const char* compact_mode,
+     const char* result_file)
 {
   MsgHandler* msg_handler = new StreamMsgHandler(&cerr);
   MsgMgr::reg_handler(msg_handler);
@@ -153,6 +756,11 @@ lsim(const string& filename,
     }
   }
 
+  string cache_dir_str;
+  if ( cache_dir != NULL ) {
+    cache_dir_str = cache_dir;
+  }
+
   unordered_map<string, ymuint> order_map;
   if ( order_file ) {
     if ( !read_order(order_file, order_map) ) {
@@ -160,55 +768,84 @@ lsim(const string& filename,
       return;
     }
   }
-
-  if ( method_str == "naive" ) {
-    LsimNaive lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+  else if ( auto_order ) {
+    if ( !static_order(network, auto_order, order_map) ) {
+      cerr << "Unknown ordering method: " << auto_order << endl;
+      return;
+    }
+    cout << "BDD size(" << auto_order << "):  \t"
+	 << order_bdd_size(network, order_map) << endl;
   }
-  else if ( method_str == "naive2" ) {
-    LsimNaive2 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+  if ( sift ) {
+    // 読み込んだ変数順か静的な変数順から始める．
+    sift_order(network, order_map, sift_window, 4);
   }
-  else if ( method_str == "naive3" ) {
-    LsimNaive3 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+  if ( order_out_file ) {
+    if ( !write_order(order_out_file, network, order_map) ) {
+      return;
+    }
   }
-  else if ( method_str == "bdd" ) {
-    LsimBdd lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+
+  LsimCompactor* compactor = NULL;
+  if ( compact_mode != NULL || result_file != NULL ) {
+    compactor = new LsimCompactor;
+    string mode = compact_mode != NULL ? compact_mode : "misr";
+    if ( !compactor->init(mode, network.output_num()) ) {
+      cerr << "Unknown compaction method: " << mode << endl;
+      delete compactor;
+      return;
+    }
   }
-  else if ( method_str == "bdd1" ) {
-    LsimBdd1 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+
+  if ( (pattern_file != NULL || compactor != NULL) &&
+       (bench_format != NULL || method_str == "event" || method_str == "tv") ) {
+    cerr << "Pattern file and compaction can not be used in this mode" << endl;
+    delete compactor;
+    return;
   }
-  else if ( method_str == "bdd2" ) {
-    LsimBdd2 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+
+  if ( bench_format != NULL ) {
+    do_bench(filename, network, order_map, loop_count, thread_num, seed,
+	     bench_format, cache_dir_str);
   }
-  else if ( method_str == "bdd3" ) {
-    LsimBdd3 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+  else if ( method_str == "naive3w" && thread_num == 0 &&
+	    pattern_file == NULL && compactor == NULL ) {
+    LsimNaive3W lsim;
+    do_lsim_wide(lsim, loop_count, network, order_map);
   }
-  else if ( method_str == "bdd10" ) {
-    LsimBdd10 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+  else if ( method_str == "event" ) {
+    LsimEvent lsim;
+    do_lsim_event(lsim, loop_count, change_num, network, order_map);
   }
-  else if ( method_str == "lcc" ) {
-    LsimLcc lsim;
-    do_lsim(lsim, loop_count, network, order_map);
+  else if ( method_str == "bdd3" ) {
+    LsimBdd3 lsim;
+    if ( lut_file != NULL ) {
+      lsim.set_lut_file(lut_file);
+    }
+    do_lsim(lsim, loop_count, thread_num, network, order_map,
+	    cache_dir_str, pattern_file, batch_size, compactor);
   }
   else if ( method_str == "tv" ) {
   }
-  else if ( method_str == "mpx" ) {
-    LsimMpx lsim;
-    do_lsim(lsim, loop_count, network, order_map);
-  }
-  else if ( method_str == "mpx2" ) {
-    LsimMpx2 lsim;
-    do_lsim(lsim, loop_count, network, order_map);
-  }
   else {
-    cerr << "Unknown method: " << method_str << endl;
+    Lsim* lsim = new_lsim(method_str, cache_dir_str);
+    if ( lsim == NULL ) {
+      cerr << "Unknown method: " << method_str << endl;
+      delete compactor;
+      return;
+    }
+    do_lsim(*lsim, loop_count, thread_num, network, order_map,
+	    cache_dir_str, pattern_file, batch_size, compactor);
+    delete lsim;
+  }
+
+  if ( compactor != NULL ) {
+    cout << "Signature(" << compactor->mode() << "):\t" << hex
+	 << compactor->total_signature() << dec << endl;
+    if ( result_file != NULL ) {
+      compactor->write(result_file, network);
+    }
+    delete compactor;
   }
 }
 
@@ -224,9 +861,23 @@ main(int argc,
 
   const char* method_str = "naive";
   const char* order_file = NULL;
+  const char* bench_format = NULL;
+  int seed = 1;
+  const char* lut_file = NULL;
+  const char* cache_dir = NULL;
+  const char* auto_order = NULL;
+  const char* order_out_file = NULL;
+  int sift_window = 0;
+  const char* pattern_file = NULL;
+  const char* batch_size_str = NULL;
+  const char* compact_mode = NULL;
+  const char* result_file = NULL;
   int loop_count = 2000;
+  int thread_num = 0;
+  int change_num = 0;
   bool blif = false;
   bool iscas = false;
+  bool sift = false;
 
   // オプション解析用のデータ
   const struct poptOption options[] = {
@@ -238,11 +889,18 @@ main(int argc,
     // docstr
     // argstr
     { "method", 'm', POPT_ARG_STRING, &method_str, 0,
-      "specify evaluation method", "naive|bdd|tv" },
+      "specify evaluation method",
+      "naive|naive2|naive3|naive3w|soa|event|bdd|bdd1|bdd2|bdd3|bdd10|lcc|codegen|mpx|mpx2|hybrid|tv" },
 
     { "loop-num", 'n', POPT_ARG_INT, &loop_count, 0,
       "specify loop count", NULL },
 
+    { "thread-num", 't', POPT_ARG_INT, &thread_num, 0,
+      "specify thread number (batch mode)", NULL },
+
+    { "change-num", 'c', POPT_ARG_INT, &change_num, 0,
+      "specify number of changed inputs per vector (event mode)", NULL },
+
     { "blif", '\0', POPT_ARG_NONE, NULL, 0x100,
       "blif mode", NULL },
 
@@ -252,6 +910,43 @@ main(int argc,
     { "order", 'o', POPT_ARG_STRING, &order_file, 0,
       "specify variable order file", NULL },
 
+    { "auto-order", 'a', POPT_ARG_STRING, &auto_order, 0,
+      "compute variable order from the network structure", "dfs|depth" },
+
+    { "sift", '\0', POPT_ARG_NONE, NULL, 0x102,
+      "improve variable order by sifting", NULL },
+
+    { "sift-window", '\0', POPT_ARG_INT, &sift_window, 0,
+      "specify sifting window (0 means all positions)", NULL },
+
+    { "write-order", 'w', POPT_ARG_STRING, &order_out_file, 0,
+      "write variable order to file", NULL },
+
+    { "bench", 'b', POPT_ARG_STRING, &bench_format, 0,
+      "run all methods and print the results", "csv|json" },
+
+    { "seed", 's', POPT_ARG_INT, &seed, 0,
+      "specify random seed (bench mode)", NULL },
+
+    { "lut-file", 'l', POPT_ARG_STRING, &lut_file, 0,
+      "specify LUT image file (bdd3 mode)", NULL },
+
+    { "cache-dir", 'C', POPT_ARG_STRING, &cache_dir, 0,
+      "specify directory for compiled network images and codegen kernels",
+      NULL },
+
+    { "pattern-file", 'p', POPT_ARG_STRING, &pattern_file, 0,
+      "read input patterns from file (text or binary)", NULL },
+
+    { "batch-size", '\0', POPT_ARG_STRING, &batch_size_str, 0,
+      "specify number of words read at once (pattern file mode)", NULL },
+
+    { "compact", '\0', POPT_ARG_STRING, &compact_mode, 0,
+      "compact outputs into per-output signatures", "misr|hash" },
+
+    { "result-file", 'r', POPT_ARG_STRING, &result_file, 0,
+      "write output signatures to file", NULL },
+
     POPT_AUTOHELP
 
     { NULL, '\0', 0, NULL, 0, NULL, NULL }
@@ -280,12 +975,49 @@ main(int argc,
     else if ( rc == 0x101 ) {
       iscas = true;
     }
+    else if ( rc == 0x102 ) {
+      sift = true;
+    }
   }
 
   if ( !blif && !iscas ) {
     blif = true;
   }
 
+  // 回数や個数を表す引数は負であってはならない．
+  // (ymuint に変換されると巨大な値になってしまう)
+  const struct {
+    const char* mName;
+    int mValue;
+  } count_list[] = {
+    { "--loop-num", loop_count },
+    { "--thread-num", thread_num },
+    { "--change-num", change_num },
+    { "--sift-window", sift_window },
+  };
+  for (ymuint i = 0; i < sizeof(count_list) / sizeof(count_list[0]); ++ i) {
+    if ( count_list[i].mValue < 0 ) {
+      fprintf(stderr, "%s: non-negative integer expected: %d\n",
+	      count_list[i].mName, count_list[i].mValue);
+      return 1;
+    }
+  }
+
+  // バッチサイズは正の整数でなければならない．
+  int batch_size = 1024;
+  if ( batch_size_str != NULL ) {
+    char* end;
+    errno = 0;
+    long val = strtol(batch_size_str, &end, 10);
+    if ( end == batch_size_str || *end != '\0' || errno != 0 ||
+	 val <= 0 || val > INT_MAX ) {
+      fprintf(stderr, "--batch-size: positive integer expected: %s\n",
+	      batch_size_str);
+      return 1;
+    }
+    batch_size = val;
+  }
+
   // 残りの引数はファイル名とみなす．
   const char* str = poptGetArg(popt_context);
   if ( str == NULL ) {
@@ -294,7 +1026,10 @@ main(int argc,
   }
 
   string filename(str);
-  lsim(filename, blif, iscas, loop_count, method_str, order_file);
+  lsim(filename, blif, iscas, loop_count, thread_num, change_num,
+       method_str, order_file, bench_format, seed, lut_file, cache_dir,
+       auto_order, sift, sift_window, order_out_file,
+       pattern_file, batch_size, compact_mode, result_file);
 
   return 0;
 }
@@ -0,0 +1,225 @@
+﻿
+/// @file BddPartition.cc
+/// @brief makebdd の出力の分割と BDD の複製を行う関数の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "BddPartition.h"
+#include "YmNetworks/BdnNode.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 未定義の値
+const ymuint32 kNone = 0xFFFFFFFFU;
+
+// 分割を論理ノード数の多い順に並べるための比較関数
+struct PartGt
+{
+  PartGt(const vector<vector<const BdnNode*> >& node_part_list) :
+    mNodePartList(node_part_list)
+  {
+  }
+
+  bool
+  operator()(ymuint left,
+	     ymuint right) const
+  {
+    return mNodePartList[left].size() > mNodePartList[right].size();
+  }
+
+  const vector<vector<const BdnNode*> >& mNodePartList;
+};
+
+END_NONAMESPACE
+
+
+// @brief 出力をファンインコーンの重なりで分割する．
+// @param[in] network 対象のネットワーク
+// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+// @param[in] overlap 既存の分割に入れる共有ノードの割合の下限
+// @param[out] output_part_list 分割ごとの出力番号のリスト
+// @param[out] node_part_list 分割ごとの論理ノードのリスト(トポロジカル順)
+void
+partition_outputs(const BdnMgr& network,
+		  const vector<const BdnNode*>& node_list,
+		  double overlap,
+		  vector<vector<ymuint> >& output_part_list,
+		  vector<vector<const BdnNode*> >& node_part_list)
+{
+  ymuint n = network.max_node_id();
+
+  // 各ノードを最初に含んだ分割の番号
+  vector<ymuint32> owner(n, kNone);
+
+  // 分割ごとの出力番号のリスト
+  vector<vector<ymuint> > tmp_output_list;
+
+  // BdnNodeList は番号で引けないので配列にしておく．
+  const BdnNodeList& output_list0 = network.output_list();
+  vector<const BdnNode*> output_list(output_list0.begin(),
+				     output_list0.end());
+
+  vector<ymuint32> mark(n, kNone);
+  vector<const BdnNode*> stack;
+  vector<const BdnNode*> cone;
+  ymuint opos = 0;
+  for (vector<const BdnNode*>::const_iterator p = output_list.begin();
+       p != output_list.end(); ++ p, ++ opos) {
+    // ファンインコーンの論理ノードを集める．
+    cone.clear();
+    const BdnNode* inode = (*p)->output_fanin();
+    if ( inode != NULL ) {
+      stack.push_back(inode);
+    }
+    while ( !stack.empty() ) {
+      const BdnNode* node = stack.back();
+      stack.pop_back();
+      if ( node->is_input() || mark[node->id()] == opos ) {
+	continue;
+      }
+      mark[node->id()] = opos;
+      cone.push_back(node);
+      stack.push_back(node->fanin0());
+      stack.push_back(node->fanin1());
+    }
+
+    // 既存の分割ごとに共有しているノード数を数える．
+    unordered_map<ymuint32, ymuint> count_map;
+    for (vector<const BdnNode*>::iterator q = cone.begin();
+	 q != cone.end(); ++ q) {
+      ymuint32 part = owner[(*q)->id()];
+      if ( part != kNone ) {
+	++ count_map[part];
+      }
+    }
+    ymuint32 best_part = kNone;
+    ymuint best_count = 0;
+    for (unordered_map<ymuint32, ymuint>::iterator q = count_map.begin();
+	 q != count_map.end(); ++ q) {
+      if ( best_count < q->second ||
+	   (best_count == q->second && q->first < best_part) ) {
+	best_part = q->first;
+	best_count = q->second;
+      }
+    }
+
+    ymuint32 part;
+    if ( cone.empty() && !tmp_output_list.empty() ) {
+      // 論理ノードを持たない出力はどこに入れてもよい．
+      part = 0;
+    }
+    else if ( best_part != kNone && best_count >= overlap * cone.size() ) {
+      part = best_part;
+    }
+    else {
+      part = tmp_output_list.size();
+      tmp_output_list.push_back(vector<ymuint>());
+    }
+    tmp_output_list[part].push_back(opos);
+    for (vector<const BdnNode*>::iterator q = cone.begin();
+	 q != cone.end(); ++ q) {
+      const BdnNode* node = *q;
+      if ( owner[node->id()] == kNone ) {
+	owner[node->id()] = part;
+      }
+    }
+  }
+
+  // 分割ごとにファンインコーンの和をトポロジカル順に並べる．
+  ymuint np = tmp_output_list.size();
+  vector<vector<const BdnNode*> > tmp_node_list(np);
+  vector<bool> in_part(n, false);
+  for (ymuint part = 0; part < np; ++ part) {
+    const vector<ymuint>& olist = tmp_output_list[part];
+    for (vector<ymuint>::const_iterator q = olist.begin();
+	 q != olist.end(); ++ q) {
+      const BdnNode* inode = output_list[*q]->output_fanin();
+      if ( inode != NULL ) {
+	stack.push_back(inode);
+      }
+    }
+    vector<const BdnNode*> visited;
+    while ( !stack.empty() ) {
+      const BdnNode* node = stack.back();
+      stack.pop_back();
+      if ( node->is_input() || in_part[node->id()] ) {
+	continue;
+      }
+      in_part[node->id()] = true;
+      visited.push_back(node);
+      stack.push_back(node->fanin0());
+      stack.push_back(node->fanin1());
+    }
+    vector<const BdnNode*>& part_nodes = tmp_node_list[part];
+    part_nodes.reserve(visited.size());
+    for (vector<const BdnNode*>::const_iterator q = node_list.begin();
+	 q != node_list.end(); ++ q) {
+      if ( in_part[(*q)->id()] ) {
+	part_nodes.push_back(*q);
+      }
+    }
+    for (vector<const BdnNode*>::iterator q = visited.begin();
+	 q != visited.end(); ++ q) {
+      in_part[(*q)->id()] = false;
+    }
+  }
+
+  // 大きい分割から順に並べる．
+  vector<ymuint> order(np);
+  for (ymuint i = 0; i < np; ++ i) {
+    order[i] = i;
+  }
+  stable_sort(order.begin(), order.end(), PartGt(tmp_node_list));
+
+  output_part_list.clear();
+  output_part_list.resize(np);
+  node_part_list.clear();
+  node_part_list.resize(np);
+  for (ymuint i = 0; i < np; ++ i) {
+    output_part_list[i].swap(tmp_output_list[order[i]]);
+    node_part_list[i].swap(tmp_node_list[order[i]]);
+  }
+}
+
+// @brief BDD を別の BddMgr に複製する．
+// @param[in] src 元の BDD
+// @param[in] dst_mgr 複製先の BddMgr
+// @param[inout] bdd_map 複製済みの BDD のマップ
+// @return 複製した BDD を返す．
+Bdd
+copy_bdd(Bdd src,
+	 BddMgr& dst_mgr,
+	 unordered_map<Bdd, Bdd>& bdd_map)
+{
+  if ( src.is_zero() ) {
+    return dst_mgr.make_zero();
+  }
+  if ( src.is_one() ) {
+    return dst_mgr.make_one();
+  }
+
+  unordered_map<Bdd, Bdd>::iterator p = bdd_map.find(src);
+  if ( p != bdd_map.end() ) {
+    return p->second;
+  }
+
+  Bdd src0;
+  Bdd src1;
+  VarId var = src.root_decomp(src0, src1);
+  Bdd dst0 = copy_bdd(src0, dst_mgr, bdd_map);
+  Bdd dst1 = copy_bdd(src1, dst_mgr, bdd_map);
+  Bdd lit = dst_mgr.make_posiliteral(var);
+  Bdd dst = (lit & dst1) | (~lit & dst0);
+  bdd_map.insert(make_pair(src, dst));
+
+  return dst;
+}
+
+END_NAMESPACE_YM
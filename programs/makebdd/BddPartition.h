@@ -0,0 +1,51 @@
+﻿#ifndef BDDPARTITION_H
+#define BDDPARTITION_H
+
+/// @file BddPartition.h
+/// @brief makebdd の出力の分割と BDD の複製を行う関数のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmNetworks/BdnMgr.h"
+#include "YmLogic/Bdd.h"
+#include "YmLogic/BddMgr.h"
+
+
+BEGIN_NAMESPACE_YM
+
+/// @brief 出力をファンインコーンの重なりで分割する．
+/// @param[in] network 対象のネットワーク
+/// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+/// @param[in] overlap 既存の分割に入れる共有ノードの割合の下限
+/// @param[out] output_part_list 分割ごとの出力番号のリスト
+/// @param[out] node_part_list 分割ごとの論理ノードのリスト(トポロジカル順)
+/// @note 出力を順に見て，ファンインコーンのうち overlap 以上の割合の
+/// ノードを既存の分割と共有していればその分割に入れ，そうでなければ
+/// 新しい分割を作る．分割の間で共有されるノードは両方に含まれる．
+/// @note 分割は論理ノード数の多い順に並べる．
+void
+partition_outputs(const BdnMgr& network,
+		  const vector<const BdnNode*>& node_list,
+		  double overlap,
+		  vector<vector<ymuint> >& output_part_list,
+		  vector<vector<const BdnNode*> >& node_part_list);
+
+/// @brief BDD を別の BddMgr に複製する．
+/// @param[in] src 元の BDD
+/// @param[in] dst_mgr 複製先の BddMgr
+/// @param[inout] bdd_map 複製済みの BDD のマップ
+/// @return 複製した BDD を返す．
+/// @note 変数番号はそのまま用いる．
+/// @note bdd_map は元の BddMgr ごとに用い，元の BddMgr を破壊する前に
+/// クリアすること．
+Bdd
+copy_bdd(Bdd src,
+	 BddMgr& dst_mgr,
+	 unordered_map<Bdd, Bdd>& bdd_map);
+
+END_NAMESPACE_YM
+
+#endif // BDDPARTITION_H
@@ -13,58 +13,257 @@
 #include "YmNetworks/BdnBlifReader.h"
 #include "YmNetworks/BdnNode.h"
 
+#include "BddOrder.h"
+#include "BddPartition.h"
+
 #include "YmUtils/MsgMgr.h"
 #include "YmUtils/MsgHandler.h"
 
 #include "YmUtils/StopWatch.h"
 
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+
 
 BEGIN_NAMESPACE_YM
 
-bool
-makebdd(const string& filename)
+// makebdd のオプション
+struct MakeBddOpt
 {
-  MsgHandler* msg_handler = new StreamMsgHandler(&cerr);
-  MsgMgr::reg_handler(msg_handler);
+  // コンストラクタ
+  MakeBddOpt() :
+    mRelease(true),
+    mGcThreshold(0.0),
+    mGcNodeLimit(0),
+    mMemLimit(0),
+    mVerbose(false),
+    mStatsFile(NULL),
+    mOrder(NULL),
+    mOrderFile(NULL),
+    mWriteOrder(NULL),
+    mSiftTrigger(0),
+    mSiftWindow(0),
+    mMaxReorder(4),
+    mJobNum(0),
+    mMerge(false),
+    mOverlap(0.5)
+  {
+  }
 
-  BdnBlifReader read;
-  BdnMgr network;
+  // 全てのファンアウトを作り終えた中間 BDD を解放する時 true
+  bool mRelease;
 
-  if ( !read(filename, network) ) {
-    cerr << "Error in reading " << filename << endl;
-    return false;
+  // GC を起動するゴミの割合(0 の時は BddMgr の既定値)
+  double mGcThreshold;
+
+  // GC を起動するノード数の下限(0 の時は BddMgr の既定値)
+  ymuint64 mGcNodeLimit;
+
+  // メモリ量の上限(MB 単位，0 の時は制限なし)
+  ymuint64 mMemLimit;
+
+  // ノードごとの統計情報を表示する時 true
+  bool mVerbose;
+
+  // ノードごとの統計情報を書き出すファイル名(NULL の時は書かない)
+  const char* mStatsFile;
+
+  // 静的な変数順の手法名(NULL の時は入力順)
+  const char* mOrder;
+
+  // 変数順を読み込むファイル名(NULL の時は読まない)
+  const char* mOrderFile;
+
+  // 最終的な変数順を書き出すファイル名(NULL の時は書かない)
+  const char* mWriteOrder;
+
+  // sifting を起動する生きているノード数(0 の時は行わない)
+  ymuint64 mSiftTrigger;
+
+  // sifting で1つの変数を動かす範囲(0 の時は全範囲)
+  ymuint mSiftWindow;
+
+  // sifting を行う最大回数
+  ymuint mMaxReorder;
+
+  // 出力を分割して並列に作る時の子プロセス数(0 の時は分割しない)
+  // mMerge が true の時は1でなければならず，分割をこのプロセスで1つずつ作る．
+  ymuint mJobNum;
+
+  // 分割ごとに作った BDD を最後に1つの BddMgr にまとめる時 true
+  bool mMerge;
+
+  // 出力を既存の分割に入れる共有ノードの割合の下限
+  double mOverlap;
+};
+
+// BDD を作った結果
+enum tBuildStat {
+  // 最後まで作った．
+  kBuildOk,
+  // メモリの上限を超えた．
+  kBuildMemOut,
+  // sifting を起動するノード数を超えた．
+  kBuildGrowth
+};
+
+// BDD を作った時の情報
+struct BuildInfo
+{
+  // コンストラクタ
+  BuildInfo() :
+    mNodeNum(0),
+    mReleased(0),
+    mPeakLive(0),
+    mPeakPos(0),
+    mFinalLive(0),
+    mUsedMem(0),
+    mOutputSize(0),
+    mMaxTime(0.0),
+    mMaxTimePos(0),
+    mStopPos(0),
+    mStopLive(0)
+  {
   }
 
-  BddMgr bddmgr("bmc", "Bdd Manager");
+  // 論理ノード数
+  ymuint mNodeNum;
+
+  // 解放した中間 BDD の数
+  ymuint64 mReleased;
 
+  // 生きているノード数の最大値
+  ymuint64 mPeakLive;
+
+  // mPeakLive になった位置
+  ymuint mPeakPos;
+
+  // 最後の生きているノード数
+  ymuint64 mFinalLive;
+
+  // 使用メモリ量
+  ymuint64 mUsedMem;
+
+  // 出力の BDD のサイズの和
+  ymuint64 mOutputSize;
+
+  // 1つのノードにかかった時間の最大値
+  double mMaxTime;
+
+  // mMaxTime になった位置
+  ymuint mMaxTimePos;
+
+  // sifting のために中断した位置
+  ymuint mStopPos;
+
+  // 中断した時の生きているノード数
+  ymuint64 mStopLive;
+};
+
+// @brief BddMgr にオプションのパラメータを設定する．
+// @param[in] bddmgr BddMgr
+// @param[in] opt オプション
+void
+set_param(BddMgr& bddmgr,
+	  const MakeBddOpt& opt)
+{
   BddMgrParam param;
-  param.mMemLimit = 0;
-  bddmgr.param(param, BddMgrParam::MEM_LIMIT);
+  ymuint mask = BddMgrParam::MEM_LIMIT;
+  param.mMemLimit = opt.mMemLimit * 1024 * 1024;
+  if ( opt.mGcThreshold > 0.0 ) {
+    param.mGcThreshold = opt.mGcThreshold;
+    mask |= BddMgrParam::GC_THRESHOLD;
+  }
+  if ( opt.mGcNodeLimit > 0 ) {
+    param.mGcNodeLimit = opt.mGcNodeLimit;
+    mask |= BddMgrParam::GC_NODE_LIMIT;
+  }
+  bddmgr.param(param, mask);
   //bddmgr.set_logstream(cerr);
+}
+
+// @brief 与えられた変数順で BDD を作る．
+// @param[in] bddmgr BddMgr
+// @param[in] network 対象のネットワーク
+// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+// @param[in] output_pos_list 作る出力の番号のリスト
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @param[in] opt オプション
+// @param[in] stats ノードごとの統計情報の出力先(NULL の時は書かない)
+// @param[in] sift_limit 生きているノード数の上限(0 の時は制限なし)
+// @param[out] output_bdd_list 出力の BDD のリスト(NULL の時は返さない)
+// @param[out] info 作った時の情報
+// @note output_bdd_list は output_pos_list と同じ順に並べる．
+// @note output_pos_list の出力のファンインコーンは全て node_list に
+// 含まれていなければならない．
+tBuildStat
+build_bdd(BddMgr& bddmgr,
+	  const BdnMgr& network,
+	  const vector<const BdnNode*>& node_list,
+	  const vector<ymuint>& output_pos_list,
+	  const vector<ymuint32>& input_var,
+	  const MakeBddOpt& opt,
+	  ostream* stats,
+	  ymuint64 sift_limit,
+	  vector<Bdd>* output_bdd_list,
+	  BuildInfo& info)
+{
+  bool node_stats = opt.mVerbose || stats != NULL;
 
+  tBuildStat stat = kBuildOk;
   {
     ymuint n = network.max_node_id();
     vector<Bdd> bddmap(n);
 
+    ymuint node_num = node_list.size();
+    info.mNodeNum = node_num;
+
+    // 各ノードのファンアウト数を数える．
+    // 出力のファンインは最後まで残すので余分に1つ数えておく．
+    vector<ymuint> ref_count(n, 0);
+    for (vector<const BdnNode*>::const_iterator p = node_list.begin();
+	 p != node_list.end(); ++ p) {
+      const BdnNode* node = *p;
+      ++ ref_count[node->fanin0()->id()];
+      ++ ref_count[node->fanin1()->id()];
+    }
+    // BdnNodeList は番号で引けないので配列にしておく．
+    const BdnNodeList& output_list0 = network.output_list();
+    vector<const BdnNode*> output_list(output_list0.begin(),
+				       output_list0.end());
+    for (vector<ymuint>::const_iterator p = output_pos_list.begin();
+	 p != output_pos_list.end(); ++ p) {
+      const BdnNode* node = output_list[*p]->output_fanin();
+      if ( node != NULL ) {
+	++ ref_count[node->id()];
+      }
+    }
+
     const BdnNodeList& input_list = network.input_list();
     ymuint id = 0;
     for (BdnNodeList::const_iterator p = input_list.begin();
-	 p != input_list.end(); ++ p) {
+	 p != input_list.end(); ++ p, ++ id) {
       const BdnNode* node = *p;
-      Bdd bdd = bddmgr.make_posiliteral(VarId(id));
-      ++ id;
+      Bdd bdd = bddmgr.make_posiliteral(VarId(input_var[id]));
       bddmap[node->id()] = bdd;
     }
 
-    vector<const BdnNode*> node_list;
-    network.sort(node_list);
-    ymuint node_num = node_list.size();
+    // ゴミになったノードは GC まで node_num() に含まれるので除いて数える．
+    info.mPeakLive = bddmgr.node_num() - bddmgr.garbage_num();
+    StopWatch node_sw;
     id = 0;
     for (vector<const BdnNode*>::const_iterator p = node_list.begin();
-	 p != node_list.end(); ++ p) {
+	 p != node_list.end(); ++ p, ++ id) {
       const BdnNode* node = *p;
-      cout << id << " / " << node_num;
-      ++ id;
+      if ( node_stats ) {
+	node_sw.reset();
+	node_sw.start();
+      }
       const BdnNode* fanin0 = node->fanin0();
       Bdd bdd0 = bddmap[fanin0->id()];
       if ( node->fanin0_inv() ) {
@@ -75,36 +274,609 @@ makebdd(const string& filename)
       if ( node->fanin1_inv() ) {
 	bdd1 = ~bdd1;
       }
-#if 0
-      cout << " " << bdd0.size() << " x " << bdd1.size();
-      cout.flush();
-#endif
+      Bdd bdd;
       if ( node->is_and() ) {
-	Bdd bdd = bdd0 & bdd1;
-	bddmap[node->id()] = bdd;
+	bdd = bdd0 & bdd1;
       }
       else if ( node->is_xor() ) {
-	Bdd bdd = bdd0 ^ bdd1;
-	bddmap[node->id()] = bdd;
+	bdd = bdd0 ^ bdd1;
       }
       else {
 	ASSERT_NOT_REACHED;
       }
-#if 0
-      cout << " = " << bddmap[node->id()].size();
-#endif
-      cout << endl;
+      if ( bdd.is_invalid() ) {
+	info.mStopPos = id;
+	stat = kBuildMemOut;
+	break;
+      }
+      bddmap[node->id()] = bdd;
+
+      if ( opt.mRelease ) {
+	// 最後のファンアウトを作ったファンインの BDD を解放する．
+	// 参照がなくなったノードは次の GC で回収される．
+	bdd0 = Bdd();
+	bdd1 = Bdd();
+	if ( -- ref_count[fanin0->id()] == 0 ) {
+	  bddmap[fanin0->id()] = Bdd();
+	  ++ info.mReleased;
+	}
+	if ( -- ref_count[fanin1->id()] == 0 ) {
+	  bddmap[fanin1->id()] = Bdd();
+	  ++ info.mReleased;
+	}
+      }
+
+      ymuint64 live = bddmgr.node_num() - bddmgr.garbage_num();
+      if ( info.mPeakLive < live ) {
+	info.mPeakLive = live;
+	info.mPeakPos = id;
+      }
+      if ( node_stats ) {
+	node_sw.stop();
+	double t = node_sw.time().usr_time();
+	if ( info.mMaxTime < t ) {
+	  info.mMaxTime = t;
+	  info.mMaxTimePos = id;
+	}
+	if ( opt.mVerbose ) {
+	  cout << id << " / " << node_num
+	       << ": size = " << bdd.size()
+	       << ", live = " << live
+	       << ", time = " << t << endl;
+	}
+	if ( stats != NULL ) {
+	  *stats << id << "," << bdd.size() << "," << live << "," << t << endl;
+	}
+      }
+      if ( sift_limit > 0 && live > sift_limit ) {
+	info.mStopPos = id;
+	info.mStopLive = live;
+	stat = kBuildGrowth;
+	break;
+      }
+    }
+
+    if ( stat == kBuildOk ) {
+      if ( output_bdd_list != NULL ) {
+	output_bdd_list->clear();
+	output_bdd_list->reserve(output_pos_list.size());
+      }
+      for (vector<ymuint>::const_iterator p = output_pos_list.begin();
+	   p != output_pos_list.end(); ++ p) {
+	const BdnNode* onode = output_list[*p];
+	const BdnNode* node = onode->output_fanin();
+	Bdd bdd;
+	if ( node != NULL ) {
+	  bdd = bddmap[node->id()];
+	  info.mOutputSize += bdd.size();
+	}
+	else {
+	  bdd = bddmgr.make_zero();
+	}
+	if ( output_bdd_list != NULL ) {
+	  if ( onode->output_fanin_inv() ) {
+	    bdd = ~bdd;
+	  }
+	  output_bdd_list->push_back(bdd);
+	}
+      }
+    }
+  }
+
+  info.mFinalLive = bddmgr.node_num() - bddmgr.garbage_num();
+  info.mUsedMem = bddmgr.used_mem();
+
+  return stat;
+}
+
+// @brief BDD を作った時の情報を表示する．
+// @param[in] stat BDD を作った結果
+// @param[in] info 作った時の情報
+// @param[in] opt オプション
+void
+print_info(tBuildStat stat,
+	   const BuildInfo& info,
+	   const MakeBddOpt& opt)
+{
+  if ( stat == kBuildMemOut ) {
+    cerr << "Memory limit exceeded at " << info.mStopPos
+	 << " / " << info.mNodeNum << endl;
+  }
+  cout << "Nodes:            \t" << info.mNodeNum << endl
+       << "Released BDDs:    \t" << info.mReleased << endl
+       << "Peak live nodes:  \t" << info.mPeakLive
+       << " (at " << info.mPeakPos << ")" << endl
+       << "Final live nodes: \t" << info.mFinalLive << endl
+       << "Memory:           \t" << info.mUsedMem << endl;
+  if ( stat == kBuildOk ) {
+    cout << "Output BDD size:  \t" << info.mOutputSize << endl;
+  }
+  if ( opt.mVerbose || opt.mStatsFile != NULL ) {
+    cout << "Max node time:    \t" << info.mMaxTime
+	 << " (at " << info.mMaxTimePos << ")" << endl;
+  }
+}
+
+// 出力を分割して BDD を作る時の1つの分割の仕事
+struct BuildJob
+{
+  // コンストラクタ
+  BuildJob() :
+    mBddMgr(NULL),
+    mStat(kBuildOk),
+    mTime(0.0),
+    mDone(false)
+  {
+  }
+
+  // 作る出力の番号のリスト
+  vector<ymuint> mOutputPosList;
+
+  // 論理ノードのリスト
+  vector<const BdnNode*> mNodeList;
+
+  // この分割専用の BddMgr
+  // 子プロセスで作った時は NULL のまま
+  BddMgr* mBddMgr;
+
+  // 出力の BDD のリスト
+  vector<Bdd> mOutputBddList;
+
+  // 作った結果
+  tBuildStat mStat;
+
+  // 作った時の情報
+  BuildInfo mInfo;
+
+  // かかった時間(実時間)
+  double mTime;
+
+  // 最後まで実行できた時 true
+  bool mDone;
+};
+
+// 子プロセスから親プロセスに返す結果
+struct BuildResult
+{
+  // 作った結果
+  tBuildStat mStat;
+
+  // 作った時の情報
+  BuildInfo mInfo;
+
+  // かかった時間(実時間)
+  double mTime;
+};
+
+// @brief 1つの分割の BDD を作る．
+// @param[in] bddmgr この分割専用の BddMgr
+// @param[in] network 対象のネットワーク
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @param[in] opt オプション
+// @param[inout] job 仕事
+void
+build_job(BddMgr& bddmgr,
+	  const BdnMgr& network,
+	  const vector<ymuint32>& input_var,
+	  const MakeBddOpt& opt,
+	  BuildJob& job)
+{
+  StopWatch sw;
+  sw.start();
+  set_param(bddmgr, opt);
+  job.mStat = build_bdd(bddmgr, network,
+			job.mNodeList, job.mOutputPosList,
+			input_var, opt, NULL, 0,
+			&job.mOutputBddList, job.mInfo);
+  bddmgr.disable_gc();
+  sw.stop();
+  job.mTime = sw.time().real_time();
+  job.mDone = true;
+}
+
+// @brief 分割ごとに子プロセスを作って並列に BDD を作る．
+// @param[in] network 対象のネットワーク
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @param[in] opt オプション
+// @param[in] nproc 同時に動かす子プロセス数の上限
+// @param[inout] job_list 仕事のリスト
+// @note BddMgr は別のインスタンスの間でもクラスの静的なデータ
+// (デフォルトの BddMgr やメモリ使用量のカウンタなど)を共有している
+// 可能性があり，スレッドで並列に用いて安全かどうか確かめられない．
+// そこで分割ごとに fork() してアドレス空間を分ける．
+// 子プロセスの作った BDD は親プロセスには戻らず，結果の情報だけを返す．
+void
+build_jobs_forked(const BdnMgr& network,
+		  const vector<ymuint32>& input_var,
+		  const MakeBddOpt& opt,
+		  ymuint nproc,
+		  vector<BuildJob>& job_list)
+{
+  ymuint np = job_list.size();
+  vector<pid_t> pid_list(np, -1);
+  vector<int> fd_list(np, -1);
+  ymuint next = 0;
+  ymuint nrun = 0;
+  while ( next < np || nrun > 0 ) {
+    if ( next < np && nrun < nproc ) {
+      ymuint pos = next;
+      ++ next;
+
+      int fds[2];
+      if ( pipe(fds) != 0 ) {
+	cerr << "pipe() failed" << endl;
+	continue;
+      }
+
+      cout.flush();
+      pid_t pid = fork();
+      if ( pid < 0 ) {
+	cerr << "fork() failed" << endl;
+	close(fds[0]);
+	close(fds[1]);
+	continue;
+      }
+
+      if ( pid == 0 ) {
+	// 子プロセス
+	close(fds[0]);
+	BuildJob& job = job_list[pos];
+	BddMgr bddmgr("bmc", "Bdd Manager");
+	build_job(bddmgr, network, input_var, opt, job);
+
+	BuildResult r;
+	r.mStat = job.mStat;
+	r.mInfo = job.mInfo;
+	r.mTime = job.mTime;
+	ssize_t n = write(fds[1], &r, sizeof(r));
+	close(fds[1]);
+	// BddMgr などの後始末はせずにそのまま終わる．
+	_exit(n == sizeof(r) ? 0 : 1);
+      }
+
+      // 親プロセス
+      close(fds[1]);
+      pid_list[pos] = pid;
+      fd_list[pos] = fds[0];
+      ++ nrun;
+      continue;
+    }
+
+    // 結果は PIPE_BUF より小さいので子プロセスは書き込みで止まらない．
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if ( pid < 0 ) {
+      break;
+    }
+    for (ymuint i = 0; i < np; ++ i) {
+      if ( pid_list[i] != pid ) {
+	continue;
+      }
+      BuildResult r;
+      ssize_t n = read(fd_list[i], &r, sizeof(r));
+      close(fd_list[i]);
+      pid_list[i] = -1;
+      fd_list[i] = -1;
+      -- nrun;
+      if ( n == sizeof(r) && WIFEXITED(status) && WEXITSTATUS(status) == 0 ) {
+	BuildJob& job = job_list[i];
+	job.mStat = r.mStat;
+	job.mInfo = r.mInfo;
+	job.mTime = r.mTime;
+	job.mDone = true;
+      }
+      break;
+    }
+  }
+}
+
+// @brief 出力を分割して並列に BDD を作る．
+// @param[in] network 対象のネットワーク
+// @param[in] node_list 論理ノードをトポロジカル順に並べたリスト
+// @param[in] input_var 入力番号から変数番号を得る配列
+// @param[in] opt オプション
+// @retval true 全ての分割で最後まで作れた．
+// @retval false どこかの分割でメモリの上限を超えたか，子プロセスが失敗した．
+bool
+makebdd_parallel(const BdnMgr& network,
+		 const vector<const BdnNode*>& node_list,
+		 const vector<ymuint32>& input_var,
+		 const MakeBddOpt& opt)
+{
+  vector<vector<ymuint> > output_part_list;
+  vector<vector<const BdnNode*> > node_part_list;
+  partition_outputs(network, node_list, opt.mOverlap,
+		    output_part_list, node_part_list);
+
+  ymuint np = output_part_list.size();
+  vector<BuildJob> job_list(np);
+  ymuint64 total_nodes = 0;
+  for (ymuint i = 0; i < np; ++ i) {
+    BuildJob& job = job_list[i];
+    job.mOutputPosList.swap(output_part_list[i]);
+    job.mNodeList.swap(node_part_list[i]);
+    total_nodes += job.mNodeList.size();
+  }
+  cout << "Partitions:       \t" << np << endl
+       << "Nodes:            \t" << node_list.size()
+       << " (" << total_nodes << " with duplicates)" << endl;
+
+  // 分割ごとの処理は標準出力に書かないようにする．
+  MakeBddOpt worker_opt = opt;
+  worker_opt.mVerbose = false;
+  worker_opt.mStatsFile = NULL;
+
+  if ( opt.mMerge ) {
+    // 複製するために全ての分割の BDD をこのプロセスに置く必要がある．
+    // BddMgr をスレッドで並列に使ってよいかは確かめられないので，
+    // 分割を1つずつ作る．
+    for (ymuint i = 0; i < np; ++ i) {
+      BuildJob& job = job_list[i];
+      job.mBddMgr = new BddMgr("bmc", "Bdd Manager");
+      build_job(*job.mBddMgr, network, input_var, worker_opt, job);
+    }
+  }
+  else {
+    build_jobs_forked(network, input_var, worker_opt, opt.mJobNum,
+		      job_list);
+  }
+
+  bool ok = true;
+  ymuint64 peak_sum = 0;
+  ymuint64 out_size = 0;
+  ymuint64 used_mem = 0;
+  for (ymuint i = 0; i < np; ++ i) {
+    const BuildJob& job = job_list[i];
+    const BuildInfo& info = job.mInfo;
+    if ( !job.mDone ) {
+      cout << "Partition #" << i << ":\toutputs = "
+	   << job.mOutputPosList.size() << ", failed" << endl;
+      ok = false;
+      continue;
+    }
+    cout << "Partition #" << i << ":\toutputs = " << job.mOutputPosList.size()
+	 << ", nodes = " << info.mNodeNum
+	 << ", peak live = " << info.mPeakLive
+	 << ", memory = " << info.mUsedMem;
+    if ( job.mStat == kBuildOk ) {
+      cout << ", output size = " << info.mOutputSize;
+    }
+    else {
+      cout << ", memory limit exceeded at " << info.mStopPos;
+      ok = false;
+    }
+    cout << ", time = " << job.mTime << endl;
+    peak_sum += info.mPeakLive;
+    out_size += info.mOutputSize;
+    used_mem += info.mUsedMem;
+  }
+  cout << "Peak live nodes:  \t" << peak_sum << " (sum)" << endl
+       << "Memory:           \t" << used_mem << " (sum)" << endl;
+  if ( ok ) {
+    cout << "Output BDD size:  \t" << out_size << " (sum)" << endl;
+  }
+
+  if ( ok && opt.mMerge ) {
+    // 1つの BddMgr に複製して分割の間で共有されるノードをまとめる．
+    BddMgr merge_mgr("bmc", "Bdd Manager");
+    set_param(merge_mgr, opt);
+    ymuint no = network.output_num();
+    vector<Bdd> merged_list(no);
+    for (ymuint i = 0; i < np && ok; ++ i) {
+      BuildJob& job = job_list[i];
+      unordered_map<Bdd, Bdd> bdd_map;
+      ymuint nj = job.mOutputPosList.size();
+      for (ymuint j = 0; j < nj; ++ j) {
+	Bdd bdd = copy_bdd(job.mOutputBddList[j], merge_mgr, bdd_map);
+	if ( bdd.is_invalid() ) {
+	  cerr << "Memory limit exceeded in merging" << endl;
+	  ok = false;
+	  break;
+	}
+	merged_list[job.mOutputPosList[j]] = bdd;
+      }
+      // 元の BddMgr を破壊する前に BDD を解放しておく．
+      bdd_map.clear();
+      job.mOutputBddList.clear();
+      delete job.mBddMgr;
+      job.mBddMgr = NULL;
     }
+    if ( ok ) {
+      ymuint64 merged_size = 0;
+      for (ymuint i = 0; i < no; ++ i) {
+	merged_size += merged_list[i].size();
+      }
+      cout << "Merged BDD size:  \t" << merged_size << endl
+	   << "Merged live nodes:\t"
+	   << merge_mgr.node_num() - merge_mgr.garbage_num() << endl;
+    }
+    merged_list.clear();
+    merge_mgr.disable_gc();
+  }
+
+  for (ymuint i = 0; i < np; ++ i) {
+    BuildJob& job = job_list[i];
+    job.mOutputBddList.clear();
+    delete job.mBddMgr;
+  }
+
+  return ok;
+}
 
+bool
+makebdd(const string& filename,
+	const MakeBddOpt& opt)
+{
+  MsgHandler* msg_handler = new StreamMsgHandler(&cerr);
+  MsgMgr::reg_handler(msg_handler);
+
+  BdnBlifReader read;
+  BdnMgr network;
+
+  if ( !read(filename, network) ) {
+    cerr << "Error in reading " << filename << endl;
+    return false;
+  }
+
+  vector<const BdnNode*> node_list;
+  network.sort(node_list);
+
+  // 変数順を決める．
+  // 指定がなければ入力順を用いる．
+  vector<ymuint32> input_var;
+  if ( opt.mOrderFile != NULL ) {
+    if ( !read_order(opt.mOrderFile, network, input_var) ) {
+      return false;
+    }
+  }
+  else if ( opt.mOrder != NULL ) {
+    if ( !static_order(network, opt.mOrder, input_var) ) {
+      cerr << "Unknown ordering method: " << opt.mOrder << endl;
+      return false;
+    }
+  }
+  else {
+    ymuint ni = network.input_num();
+    input_var.resize(ni);
+    for (ymuint i = 0; i < ni; ++ i) {
+      input_var[i] = i;
+    }
+  }
+
+  if ( opt.mJobNum > 0 ) {
+    bool ok = makebdd_parallel(network, node_list, input_var, opt);
+    if ( opt.mWriteOrder != NULL ) {
+      if ( !write_order(opt.mWriteOrder, network, input_var) ) {
+	return false;
+      }
+    }
+    return ok;
+  }
+
+  ofstream stats;
+  if ( opt.mStatsFile != NULL ) {
+    stats.open(opt.mStatsFile);
+    if ( !stats ) {
+      cerr << "Could not create " << opt.mStatsFile << endl;
+      return false;
+    }
+    stats << "# node,size,live,time" << endl;
+  }
+  ostream* stats_ptr = opt.mStatsFile != NULL ? &stats : NULL;
+
+  vector<ymuint> output_pos_list(network.output_num());
+  for (ymuint i = 0; i < output_pos_list.size(); ++ i) {
+    output_pos_list[i] = i;
+  }
+
+  // BddMgr は動的な変数順の変更ができないので，生きているノード数が
+  // 上限を超えたらそこまでのノードで sifting を行い，新しい変数順で
+  // 最初から作り直す．
+  // --max-reorder 0 の時は一度も行わない．
+  ymuint64 sift_limit = opt.mMaxReorder > 0 ? opt.mSiftTrigger : 0;
+  ymuint nreorder = 0;
+  tBuildStat stat;
+  for ( ; ; ) {
+    BddMgr bddmgr("bmc", "Bdd Manager");
+    set_param(bddmgr, opt);
+    BuildInfo info;
+    stat = build_bdd(bddmgr, network, node_list, output_pos_list, input_var,
+		     opt, stats_ptr, sift_limit, NULL, info);
     bddmgr.disable_gc();
+    if ( stat != kBuildGrowth ) {
+      print_info(stat, info, opt);
+      break;
+    }
+
+    ++ nreorder;
+    cout << "Reordering:       \tat " << info.mStopPos
+	 << " / " << node_list.size()
+	 << ", live nodes = " << info.mStopLive << endl;
+    ymuint64 live = sift_order(network, node_list, info.mStopPos + 1,
+			       input_var, opt.mSiftWindow, 1);
+    if ( stats_ptr != NULL ) {
+      *stats_ptr << "# reordered" << endl;
+    }
+
+    // 次の上限は sifting 後のノード数の2倍以上にする．
+    sift_limit *= 2;
+    if ( sift_limit < live * 2 ) {
+      sift_limit = live * 2;
+    }
+    if ( nreorder >= opt.mMaxReorder ) {
+      sift_limit = 0;
+    }
+  }
+  if ( opt.mSiftTrigger > 0 ) {
+    cout << "Reorderings:      \t" << nreorder << endl;
   }
 
-  return true;
+  if ( opt.mWriteOrder != NULL ) {
+    if ( !write_order(opt.mWriteOrder, network, input_var) ) {
+      return false;
+    }
+  }
+
+  return stat == kBuildOk;
 }
 
 END_NAMESPACE_YM
 
 
+BEGIN_NONAMESPACE
+
+void
+usage(const char* argv0)
+{
+  using namespace std;
+
+  cerr << "USAGE : " << argv0 << " [options] blif-file" << endl
+       << "  --no-release          keep all intermediate BDDs" << endl
+       << "  --gc-threshold <r>    run GC when the garbage ratio exceeds r" << endl
+       << "  --gc-node-limit <n>   do not run GC below n nodes" << endl
+       << "  --mem-limit <MB>      stop when BDD memory exceeds the limit" << endl
+       << "  --verbose             print per-node statistics" << endl
+       << "  --stats-file <file>   write per-node statistics (CSV)" << endl
+       << "  --order dfs|depth     compute a static variable order" << endl
+       << "  --read-order <file>   read variable order from file" << endl
+       << "  --write-order <file>  write final variable order to file" << endl
+       << "  --sift-trigger <n>    sift when live nodes exceed n" << endl
+       << "  --sift-window <w>     move each variable at most w positions" << endl
+       << "  --max-reorder <n>     sift at most n times (default 4, 0 disables)" << endl
+       << "  --jobs <n>            build output partitions in n child processes" << endl
+       << "  --overlap <r>         join a partition sharing r of the cone (default 0.5)" << endl
+       << "  --merge               merge partition BDDs into one manager" << endl
+       << "                        (partitions are built one at a time in this process;" << endl
+       << "                         cannot be used with --jobs n > 1)" << endl;
+}
+
+// @brief 符号なし整数の引数を読む．
+// @param[in] str 引数の文字列
+// @param[in] max_val 許される最大値
+// @param[out] val 読み込んだ値
+// @return 10進数の数字だけからなり，max_val 以下の時 true を返す．
+// @note strtoull は '-' を受け付けて値を反転させてしまうので先頭も調べる．
+bool
+parse_num(const char* str,
+	  nsYm::ymuint64 max_val,
+	  nsYm::ymuint64& val)
+{
+  if ( !isdigit(static_cast<unsigned char>(str[0])) ) {
+    return false;
+  }
+  char* end;
+  errno = 0;
+  unsigned long long tmp = strtoull(str, &end, 10);
+  if ( errno != 0 || *end != '\0' || tmp > max_val ) {
+    return false;
+  }
+  val = tmp;
+  return true;
+}
+
+END_NONAMESPACE
+
+
 int
 main(int argc,
      char** argv)
@@ -112,18 +884,134 @@ main(int argc,
   using namespace std;
   using namespace nsYm;
 
-  if ( argc != 2 ) {
-    cerr << "USAGE : " << argv[0] << " blif-file" << endl;
+  MakeBddOpt opt;
+  const char* filename = NULL;
+  for (int i = 1; i < argc; ++ i) {
+    const char* arg = argv[i];
+    // 引数をとるオプション
+    bool has_arg = i + 1 < argc;
+    if ( strcmp(arg, "--no-release") == 0 ) {
+      opt.mRelease = false;
+    }
+    else if ( strcmp(arg, "--verbose") == 0 ) {
+      opt.mVerbose = true;
+    }
+    else if ( strcmp(arg, "--gc-threshold") == 0 && has_arg ) {
+      opt.mGcThreshold = atof(argv[++ i]);
+    }
+    else if ( strcmp(arg, "--gc-node-limit") == 0 && has_arg ) {
+      const char* num_str = argv[++ i];
+      ymuint64 val;
+      if ( !parse_num(num_str, ULLONG_MAX, val) ) {
+	cerr << arg << ": non-negative integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      opt.mGcNodeLimit = val;
+    }
+    else if ( strcmp(arg, "--mem-limit") == 0 && has_arg ) {
+      const char* num_str = argv[++ i];
+      ymuint64 val;
+      if ( !parse_num(num_str, ULLONG_MAX, val) ) {
+	cerr << arg << ": non-negative integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      opt.mMemLimit = val;
+    }
+    else if ( strcmp(arg, "--stats-file") == 0 && has_arg ) {
+      opt.mStatsFile = argv[++ i];
+    }
+    else if ( strcmp(arg, "--order") == 0 && has_arg ) {
+      opt.mOrder = argv[++ i];
+    }
+    else if ( strcmp(arg, "--read-order") == 0 && has_arg ) {
+      opt.mOrderFile = argv[++ i];
+    }
+    else if ( strcmp(arg, "--write-order") == 0 && has_arg ) {
+      opt.mWriteOrder = argv[++ i];
+    }
+    else if ( strcmp(arg, "--sift-trigger") == 0 && has_arg ) {
+      const char* num_str = argv[++ i];
+      ymuint64 val;
+      if ( !parse_num(num_str, ULLONG_MAX, val) ) {
+	cerr << arg << ": non-negative integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      opt.mSiftTrigger = val;
+    }
+    else if ( strcmp(arg, "--sift-window") == 0 && has_arg ) {
+      const char* num_str = argv[++ i];
+      ymuint64 val;
+      if ( !parse_num(num_str, UINT_MAX, val) ) {
+	cerr << arg << ": non-negative integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      opt.mSiftWindow = val;
+    }
+    else if ( strcmp(arg, "--max-reorder") == 0 && has_arg ) {
+      const char* num_str = argv[++ i];
+      ymuint64 val;
+      if ( !parse_num(num_str, UINT_MAX, val) ) {
+	cerr << arg << ": non-negative integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      opt.mMaxReorder = val;
+    }
+    else if ( strcmp(arg, "--jobs") == 0 && has_arg ) {
+      const char* num_str = argv[++ i];
+      ymuint64 val;
+      if ( !parse_num(num_str, INT_MAX, val) || val == 0 ) {
+	cerr << arg << ": positive integer expected: " << num_str << endl;
+	usage(argv[0]);
+	return 2;
+      }
+      opt.mJobNum = val;
+    }
+    else if ( strcmp(arg, "--overlap") == 0 && has_arg ) {
+      opt.mOverlap = atof(argv[++ i]);
+    }
+    else if ( strcmp(arg, "--merge") == 0 ) {
+      opt.mMerge = true;
+    }
+    else if ( arg[0] == '-' || filename != NULL ) {
+      usage(argv[0]);
+      return 2;
+    }
+    else {
+      filename = arg;
+    }
+  }
+  if ( filename == NULL ) {
+    usage(argv[0]);
+    return 2;
+  }
+  if ( opt.mMerge ) {
+    // まとめる時は分割をこのプロセスで1つずつ作るので並列には動かない．
+    if ( opt.mJobNum > 1 ) {
+      cerr << "--merge builds partitions sequentially and cannot be used with --jobs "
+	   << opt.mJobNum << endl;
+      return 2;
+    }
+    opt.mJobNum = 1;
+  }
+  if ( opt.mJobNum > 0 && opt.mSiftTrigger > 0 ) {
+    cerr << "--sift-trigger cannot be used with --jobs" << endl;
     return 2;
   }
 
   StopWatch sw;
   sw.start();
 
-  makebdd(argv[1]);
+  bool stat = makebdd(filename, opt);
 
   sw.stop();
 
   USTime time = sw.time();
   cout << time << endl;
+
+  return stat ? 0 : 1;
 }
@@ -37,6 +37,32 @@ public:
   void
   delete_vector(TestVector* tv);
 
+  /// @brief テストベクタの配列を入力ごとのビットベクタに変換する．
+  /// @param[in] tv_array テストベクタの配列 ( 要素数は kPvBitLen 以下 )
+  /// @param[in] ni 入力数
+  /// @param[out] val_array 入力番号をキーにしたビットベクタの配列
+  /// @note val_array[i] の b ビット目が tv_array[b]->val(i) となる．
+  /// tv_array の要素数を越えるビットは 0 になる．
+  /// @note kPvWordLen x kPvWordLen のビット行列の転置をまとめて行うので
+  /// val() を1ビットずつ呼ぶよりもずっと速い．
+  static
+  void
+  pack(const vector<TestVector*>& tv_array,
+       ymuint ni,
+       vector<tPackedVal>& val_array);
+
+  /// @brief 乱数パタンを入力ごとのビットベクタの形で直接作る．
+  /// @param[in] randgen 乱数生成器
+  /// @param[in] ni 入力数
+  /// @param[out] val_array 入力番号をキーにしたビットベクタの配列
+  /// @note kPvBitLen 個のテストベクタに set_from_random() を行って
+  /// pack() したものと同じ分布になる．
+  static
+  void
+  random_pack(RandGen& randgen,
+	      ymuint ni,
+	      vector<tPackedVal>& val_array);
+
 
 public:
   //////////////////////////////////////////////////////////////////////
@@ -143,14 +169,14 @@ private:
   ymuint32 mInputNum;
 
   // ベクタ本体(ただしサイズは可変)
-  tPackedVal mPat[1];
+  tPvWord mPat[1];
 
 
 private:
 
   // 1ワードあたりのHEX文字数
   static
-  const ymuint32 HPW = kPvBitLen / 4;
+  const ymuint32 HPW = kPvWordLen / 4;
 
 };
 
@@ -198,7 +224,7 @@ TestVector::set_val(ymuint pos,
 {
   ymuint shift = shift_num(pos);
   ymuint block = block_idx(pos);
-  tPackedVal mask = 1UL << shift;
+  tPvWord mask = 1UL << shift;
   if ( val ) {
     mPat[block] |= mask;
   }
@@ -212,7 +238,7 @@ inline
 ymuint
 TestVector::block_num(ymuint ni)
 {
-  return (ni + kPvBitLen - 1) / kPvBitLen;
+  return (ni + kPvWordLen - 1) / kPvWordLen;
 }
 
 // @brief HEX文字列の長さを返す．
@@ -228,7 +254,7 @@ inline
 ymuint
 TestVector::block_idx(ymuint ipos)
 {
-  return ipos / kPvBitLen;
+  return ipos / kPvWordLen;
 }
 
 // 入力位置からシフト量を得る．
@@ -236,7 +262,7 @@ inline
 ymuint
 TestVector::shift_num(ymuint ipos)
 {
-  return (kPvBitLen - 1 - ipos) % kPvBitLen;
+  return (kPvWordLen - 1 - ipos) % kPvWordLen;
 }
 
 // @brief 内容を出力する．
@@ -11,15 +11,38 @@
 /// All rights reserved.
 
 #include "seal_nsdef.h"
+#include <cmath>
 
 
 BEGIN_NAMESPACE_YM_SEAL
 
 
+// tPackedVal のワード数
+// 1 の時は tPackedVal は1ワードの整数型となる．
+// 2 以上の時はワードの配列を持つ PackedVal となり，1回のシミュレーションで
+// SEAL_PV_WORDS 倍のパタンを扱う．
+#ifndef SEAL_PV_WORDS
+#define SEAL_PV_WORDS 1
+#endif
+
+
 //////////////////////////////////////////////////////////////////////
 /// @brief 1ワードのビットベクタを表す型
 //////////////////////////////////////////////////////////////////////
-typedef ymulong tPackedVal;
+typedef ymulong tPvWord;
+
+/// @brief tPvWord のビット長
+const size_t kPvWordLen = SIZEOF_UNSIGNED_LONG * 8;
+
+/// @brief tPackedVal のワード数
+const size_t kPvWordNum = SEAL_PV_WORDS;
+
+#if SEAL_PV_WORDS == 1
+
+//////////////////////////////////////////////////////////////////////
+/// @brief 並列に扱うパタンのビットベクタを表す型
+//////////////////////////////////////////////////////////////////////
+typedef tPvWord tPackedVal;
 
 /// @brief 全てのビットが0の定数
 const tPackedVal kPvAll0 = 0UL;
@@ -27,8 +50,180 @@ const tPackedVal kPvAll0 = 0UL;
 /// @brief 全てのビットが1の定数
 const tPackedVal kPvAll1 = ~0UL;
 
+#else
+
+//////////////////////////////////////////////////////////////////////
+/// @class PackedVal seal_utils.h "seal_utils.h"
+/// @brief kPvWordNum ワードのビットベクタ
+///
+/// ビット演算は各ワードに対するループで行う．ループ回数が定数なので
+/// コンパイラが SIMD 命令にベクトル化する．
+/// 境界合わせは tPvWord と同じなので new や vector でそのまま確保できる．
+//////////////////////////////////////////////////////////////////////
+class PackedVal
+{
+public:
+
+  /// @brief 空のコンストラクタ
+  /// @note 内容は不定
+  PackedVal()
+  {
+  }
+
+  /// @brief 全てのワードを word にするコンストラクタ
+  explicit
+  PackedVal(tPvWord word)
+  {
+    for (size_t i = 0; i < kPvWordNum; ++ i) {
+      mWord[i] = word;
+    }
+  }
+
+
+public:
+
+  /// @brief pos 番目のワードを返す．
+  tPvWord
+  word(size_t pos) const
+  {
+    return mWord[pos];
+  }
+
+  /// @brief pos 番目のワードを返す．
+  tPvWord&
+  word(size_t pos)
+  {
+    return mWord[pos];
+  }
+
+  /// @brief 否定
+  PackedVal
+  operator~() const
+  {
+    PackedVal ans;
+    for (size_t i = 0; i < kPvWordNum; ++ i) {
+      ans.mWord[i] = ~mWord[i];
+    }
+    return ans;
+  }
+
+  /// @brief AND 付き代入
+  PackedVal&
+  operator&=(const PackedVal& right)
+  {
+    for (size_t i = 0; i < kPvWordNum; ++ i) {
+      mWord[i] &= right.mWord[i];
+    }
+    return *this;
+  }
+
+  /// @brief OR 付き代入
+  PackedVal&
+  operator|=(const PackedVal& right)
+  {
+    for (size_t i = 0; i < kPvWordNum; ++ i) {
+      mWord[i] |= right.mWord[i];
+    }
+    return *this;
+  }
+
+  /// @brief XOR 付き代入
+  PackedVal&
+  operator^=(const PackedVal& right)
+  {
+    for (size_t i = 0; i < kPvWordNum; ++ i) {
+      mWord[i] ^= right.mWord[i];
+    }
+    return *this;
+  }
+
+  /// @brief 等価比較
+  bool
+  operator==(const PackedVal& right) const
+  {
+    tPvWord diff = 0UL;
+    for (size_t i = 0; i < kPvWordNum; ++ i) {
+      diff |= mWord[i] ^ right.mWord[i];
+    }
+    return diff == 0UL;
+  }
+
+  /// @brief 非等価比較
+  bool
+  operator!=(const PackedVal& right) const
+  {
+    return !operator==(right);
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ワードの配列
+  tPvWord mWord[kPvWordNum];
+
+};
+
+/// @brief AND
+inline
+PackedVal
+operator&(const PackedVal& left,
+	  const PackedVal& right)
+{
+  return PackedVal(left) &= right;
+}
+
+/// @brief OR
+inline
+PackedVal
+operator|(const PackedVal& left,
+	  const PackedVal& right)
+{
+  return PackedVal(left) |= right;
+}
+
+/// @brief XOR
+inline
+PackedVal
+operator^(const PackedVal& left,
+	  const PackedVal& right)
+{
+  return PackedVal(left) ^= right;
+}
+
+/// @brief 内容を出力する．
+/// @note 上位のワードから順に，ワードごとに0詰めで出力する．
+/// 基数はストリームの設定に従う．
+inline
+ostream&
+operator<<(ostream& s,
+	   const PackedVal& val)
+{
+  ios::fmtflags base = s.flags() & ios::basefield;
+  size_t w = (base == ios::hex) ? kPvWordLen / 4 : 0;
+  char fill = s.fill('0');
+  for (size_t i = kPvWordNum; i > 0; -- i) {
+    s << setw(w) << val.word(i - 1);
+  }
+  s.fill(fill);
+  return s;
+}
+
+/// @brief 並列に扱うパタンのビットベクタを表す型
+typedef PackedVal tPackedVal;
+
+/// @brief 全てのビットが0の定数
+const tPackedVal kPvAll0(0UL);
+
+/// @brief 全てのビットが1の定数
+const tPackedVal kPvAll1(~0UL);
+
+#endif
+
 /// @brief tPackedVal のビット長
-const size_t kPvBitLen = SIZEOF_UNSIGNED_LONG * 8;
+const size_t kPvBitLen = kPvWordLen * kPvWordNum;
 
 
 /// @brief word 中の1のビット数を数える．
@@ -36,7 +231,7 @@ const size_t kPvBitLen = SIZEOF_UNSIGNED_LONG * 8;
 /// @return word 中の1のビット数
 inline
 size_t
-count_ones(tPackedVal word)
+count_ones(tPvWord word)
 {
 #if SIZEOF_UNSIGNED_LONG == 4
   const size_t mask1   = 0x55555555;
@@ -81,6 +276,101 @@ count_ones(tPackedVal word)
 #endif
 }
 
+#if SEAL_PV_WORDS > 1
+/// @brief val 中の1のビット数を数える．
+inline
+size_t
+count_ones(const PackedVal& val)
+{
+  size_t n = 0;
+  for (size_t i = 0; i < kPvWordNum; ++ i) {
+    n += count_ones(val.word(i));
+  }
+  return n;
+}
+#endif
+
+/// @brief val の pos ビット目を1にする．
+/// @param[in] val 対象のビットベクタ
+/// @param[in] pos ビット位置 ( 0 <= pos < kPvBitLen )
+inline
+void
+set_bit(tPackedVal& val,
+	size_t pos)
+{
+#if SEAL_PV_WORDS == 1
+  val |= (1UL << pos);
+#else
+  val.word(pos / kPvWordLen) |= (1UL << (pos % kPvWordLen));
+#endif
+}
+
+/// @brief val の pos 番目のワードを設定する．
+/// @param[in] val 対象のビットベクタ
+/// @param[in] pos ワード位置 ( 0 <= pos < kPvWordNum )
+/// @param[in] word 設定するワード
+inline
+void
+set_word(tPackedVal& val,
+	 size_t pos,
+	 tPvWord word)
+{
+#if SEAL_PV_WORDS == 1
+  val = word;
+#else
+  val.word(pos) = word;
+#endif
+}
+
+/// @brief 信頼係数に対する標準正規分布の両側の臨界値を求める．
+/// @param[in] confidence 信頼係数 ( 0 < confidence < 1 )
+/// @return P(|Z| <= z) = confidence となる z を返す．
+inline
+double
+normal_quantile(double confidence)
+{
+  // P(|Z| > z) = erfc(z / sqrt(2)) は z に対して単調減少なので二分法で求める．
+  double alpha = 1.0 - confidence;
+  double lo = 0.0;
+  double hi = 40.0;
+  for (size_t i = 0; i < 64; ++ i) {
+    double mid = (lo + hi) * 0.5;
+    if ( erfc(mid / sqrt(2.0)) > alpha ) {
+      lo = mid;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  return (lo + hi) * 0.5;
+}
+
+/// @brief 標本の和と二乗和から平均値の信頼区間の幅の半分を求める．
+/// @param[in] n 標本数
+/// @param[in] sum 標本の和
+/// @param[in] sq_sum 標本の二乗和
+/// @param[in] z normal_quantile() で求めた臨界値
+/// @note n が 2 未満の時は分散が求まらないので HUGE_VAL を返す．
+inline
+double
+conf_interval(size_t n,
+	      double sum,
+	      double sq_sum,
+	      double z)
+{
+  if ( n < 2 ) {
+    return HUGE_VAL;
+  }
+  double dn = static_cast<double>(n);
+  double mean = sum / dn;
+  double var = (sq_sum - sum * mean) / (dn - 1.0);
+  if ( var < 0.0 ) {
+    // 丸め誤差
+    var = 0.0;
+  }
+  return z * sqrt(var / dn);
+}
+
 END_NAMESPACE_YM_SEAL
 
 #endif // SEAL_UTILS_H
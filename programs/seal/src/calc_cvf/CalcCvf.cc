@@ -62,9 +62,13 @@ CalcCvf::clear()
   mInputArray.clear();
   mOutputArray.clear();
   mLogicArray.clear();
+  mTypeArray.clear();
+  mIvalArray.clear();
 
   mFFRArray.clear();
 
+  mFlatSim.clear();
+
   mClearArray.clear();
 
   mNodeAlloc.destroy();
@@ -206,6 +210,9 @@ CalcCvf::set_network(const TgNetwork& network,
   }
   mEventQ.init(max_level);
 
+  // 正常値と可観測性の計算用に平坦な配列に展開しておく．
+  mFlatSim.set(mNodeArray, mTypeArray);
+
   if ( dss ) {
     find_dss(new_algorithm);
   }
@@ -650,44 +657,48 @@ CalcCvf::make_node(tTgGateType type,
     break;
   }
   mNodeArray.push_back(node);
+  mTypeArray.push_back(type);
   if ( type != kTgInput ) {
     mLogicArray.push_back(node);
   }
   return node;
 }
 
-// @brief 正常値のシミュレーションを行う．
+// @brief テストベクタの配列を入力ごとのビットベクタに変換する．
 // @param[in] tv_array テストベクタの配列
+// @note 結果は mIvalArray に入る．
+// @note tv_array の要素数が kPvBitLen に満たない時は残りのビットは 0 になる．
 void
-CalcCvf::calc_gval(const vector<TestVector*>& tv_array)
+CalcCvf::pack_input(const vector<TestVector*>& tv_array)
 {
-  size_t nt = tv_array.size();
   size_t ni = mNetwork->input_num2();
+  TestVector::pack(tv_array, ni, mIvalArray);
+}
+
+// @brief 正常値のシミュレーションを行う．
+// @param[in] ival_array 入力番号をキーにした入力値の配列
+void
+CalcCvf::calc_gval(const vector<tPackedVal>& ival_array)
+{
+  size_t ni = mNetwork->input_num2();
+  ASSERT_COND( ival_array.size() == ni );
   for (size_t i = 0; i < ni; ++ i) {
-    tPackedVal val = kPvAll0;
-    tPackedVal bit = 1UL;
-    for (size_t b = 0; b < nt; ++ b, bit <<= 1) {
-      if ( tv_array[b]->val(i) ) {
-	val |= bit;
-      }
-    }
     SimNode* simnode = mInputArray[i];
-    simnode->set_gval(val);
+    mFlatSim.set_gval(simnode->id(), ival_array[i]);
   }
 
-  for (vector<SimNode*>::iterator q = mLogicArray.begin();
-       q != mLogicArray.end(); ++ q) {
-    SimNode* node = *q;
-    node->calc_gval();
-  }
+  mFlatSim.calc_gval();
+
+  // 故障シミュレーションは SimNode 上で行うので結果を書き戻しておく．
+  mFlatSim.store_gval();
 }
 
 // @brief 全てのノードの出力に対する観測性の計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
 void
-CalcCvf::calc_exact(const vector<TestVector*>& tv_array)
+CalcCvf::calc_exact(const vector<tPackedVal>& ival_array)
 {
-  calc_gval(tv_array);
+  calc_gval(ival_array);
 
   for (vector<SimFFR>::iterator p = mFFRArray.begin();
        p != mFFRArray.end(); ++ p) {
@@ -749,33 +760,29 @@ CalcCvf::calc_exact(const vector<TestVector*>& tv_array)
 }
 
 // @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
 void
-CalcCvf::calc_pseudo_min(const vector<TestVector*>& tv_array)
+CalcCvf::calc_pseudo_min(const vector<tPackedVal>& ival_array)
 {
-  calc_gval(tv_array);
+  calc_gval(ival_array);
 
   size_t no = mOutputArray.size();
   for (size_t i = 0; i < no; ++ i) {
     SimNode* node = mOutputArray[i];
-    node->set_obs(kPvAll1);
+    mFlatSim.set_obs(node->id(), kPvAll1);
   }
 
-  size_t nl = mLogicArray.size();
-  for (size_t i = nl; i > 0; ) {
-    -- i;
-    SimNode* node = mLogicArray[i];
-    node->calc_pseudo_min_iobs();
-  }
+  mFlatSim.calc_pseudo_min_obs();
+  mFlatSim.store_obs();
 }
 
 // @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
 void
-CalcCvf::calc_max(const vector<TestVector*>& tv_array,
+CalcCvf::calc_max(const vector<tPackedVal>& ival_array,
 		  size_t ns)
 {
-  calc_gval(tv_array);
+  calc_gval(ival_array);
 
   size_t nl = mLogicArray.size();
   size_t ni = mInputArray.size();
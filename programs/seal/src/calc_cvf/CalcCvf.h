@@ -19,6 +19,7 @@
 #include <ym_lexp/Expr.h>
 #include <YmUtils/Alloc.h>
 #include "SimFFR.h"
+#include "FlatSim.h"
 
 
 BEGIN_NAMESPACE_YM_SEAL_CVF
@@ -48,16 +49,33 @@ public:
 	      bool dss,
 	      bool new_algorithm = true);
 
+  /// @brief 全てのノードの出力に対する観測性の計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  void
+  calc_exact(const vector<tPackedVal>& ival_array);
+
   /// @brief 全てのノードの出力に対する観測性の計算を行う．
   /// @param[in] tv_array テストベクタの配列
   void
   calc_exact(const vector<TestVector*>& tv_array);
 
+  /// @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  void
+  calc_pseudo_min(const vector<tPackedVal>& ival_array);
+
   /// @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
   /// @param[in] tv_array テストベクタの配列
   void
   calc_pseudo_min(const vector<TestVector*>& tv_array);
 
+  /// @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  /// @param[in] ns サンプリング数
+  void
+  calc_max(const vector<tPackedVal>& ival_array,
+	   size_t ns);
+
   /// @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
   /// @param[in] tv_array テストベクタの配列
   /// @param[in] ns サンプリング数
@@ -72,10 +90,16 @@ public:
 
 private:
   
-  /// @brief 正常値のシミュレーションを行う．
+  /// @brief テストベクタの配列を入力ごとのビットベクタに変換する．
   /// @param[in] tv_array テストベクタの配列
+  /// @note 結果は mIvalArray に入る．
+  void
+  pack_input(const vector<TestVector*>& tv_array);
+
+  /// @brief 正常値のシミュレーションを行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
   void
-  calc_gval(const vector<TestVector*>& tv_array);
+  calc_gval(const vector<tPackedVal>& ival_array);
 
   /// @brief SimNode のネットワークをダンプする．
   void
@@ -136,9 +160,18 @@ private:
   // 入力からのトポロジカル順に並べた logic ノードの配列
   vector<SimNode*> mLogicArray;
 
+  // ID 番号をキーにしたゲートの種類の配列
+  vector<tTgGateType> mTypeArray;
+
   // FFR を納めた配列
   vector<SimFFR> mFFRArray;
 
+  // 平坦な配列に展開したシミュレータ
+  FlatSim mFlatSim;
+
+  // テストベクタから変換した入力値の配列
+  vector<tPackedVal> mIvalArray;
+
   // イベントキュー
   EventQ mEventQ;
 
@@ -147,6 +180,38 @@ private:
   
 };
 
+// @brief 全てのノードの出力に対する観測性の計算を行う．
+// @param[in] tv_array テストベクタの配列
+inline
+void
+CalcCvf::calc_exact(const vector<TestVector*>& tv_array)
+{
+  pack_input(tv_array);
+  calc_exact(mIvalArray);
+}
+
+// @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
+// @param[in] tv_array テストベクタの配列
+inline
+void
+CalcCvf::calc_pseudo_min(const vector<TestVector*>& tv_array)
+{
+  pack_input(tv_array);
+  calc_pseudo_min(mIvalArray);
+}
+
+// @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
+// @param[in] tv_array テストベクタの配列
+// @param[in] ns サンプリング数
+inline
+void
+CalcCvf::calc_max(const vector<TestVector*>& tv_array,
+		  size_t ns)
+{
+  pack_input(tv_array);
+  calc_max(mIvalArray, ns);
+}
+
 // @brief node に対応する SimNode* を得る．
 inline
 SimNode*
@@ -20,6 +20,9 @@
 #include "TestVector.h"
 #include <YmTclpp/TclPopt.h>
 #include "CalcCvf.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 
 BEGIN_NAMESPACE_YM_SEAL_CVF
@@ -30,7 +33,9 @@ BEGIN_NAMESPACE_YM_SEAL_CVF
 
 // @brief コンストラクタ
 CvfCmd::CvfCmd(SealMgr* mgr) :
-  SealCmd(mgr)
+  SealCmd(mgr),
+  mDss(false),
+  mNewAlgorithm(true)
 {
   mPoptLoop = new TclPoptUint(this, "loop",
 			      "loop count");
@@ -56,6 +61,17 @@ CvfCmd::CvfCmd(SealMgr* mgr) :
 			  "calclate diffence");
   mPoptGate = new TclPopt(this, "gate",
 			  "display gates' information");
+  mPoptThreads = new TclPoptUint(this, "threads",
+				 "number of threads");
+  mPoptSeed = new TclPoptUint(this, "seed",
+			      "random seed");
+  mPoptError = new TclPoptDouble(this, "error",
+				 "stop when the confidence interval "
+				 "is within +/- the given value");
+  mPoptConf = new TclPoptDouble(this, "confidence",
+				"confidence level for -error (default 0.95)");
+  mPoptNodeError = new TclPopt(this, "node-error",
+			       "apply -error to every node");
   new_popt_group(mPoptInit, mPoptDss, mPoptOldDss);
   new_popt_group(mPoptExact, mPoptMin, mPoptMax, mPoptDiff);
 }
@@ -65,6 +81,359 @@ CvfCmd::~CvfCmd()
 {
 }
   
+BEGIN_NONAMESPACE
+
+// -error 指定時の収束判定の間隔(スレッドあたりのループ数)
+// 最初の判定もこのループ数を行った後に行う．
+const size_t kCheckInterval = 16;
+
+// -error 指定時に -loop が指定されていない時のループ数の上限
+const ymuint kMaxLoop = 1000000;
+
+// サンプリングの方法
+struct CvfOpt
+{
+  bool mTrace;
+  bool mTraceCount;
+  bool mExact;
+  bool mMin;
+  bool mMax;
+  bool mDiff;
+
+  // calc_max() のサンプリング数
+  int mMaxSample;
+};
+
+// サンプリング結果
+struct CvfSample
+{
+  CvfSample(size_t nn) :
+    mTotal(0.0),
+    mTotal2(0.0),
+    mTotalSq(0.0),
+    mSamples1(nn, 0),
+    mSamples2(nn, 0),
+    mSqSamples1(nn, 0)
+  {
+  }
+
+  // src の結果を足し込み，src をクリアする．
+  // mOut は対象外
+  void
+  merge(CvfSample& src)
+  {
+    mTotal += src.mTotal;
+    mTotal2 += src.mTotal2;
+    mTotalSq += src.mTotalSq;
+    src.mTotal = 0.0;
+    src.mTotal2 = 0.0;
+    src.mTotalSq = 0.0;
+    size_t nn = mSamples1.size();
+    for (size_t i = 0; i < nn; ++ i) {
+      mSamples1[i] += src.mSamples1[i];
+      mSamples2[i] += src.mSamples2[i];
+      mSqSamples1[i] += src.mSqSamples1[i];
+      src.mSamples1[i] = 0;
+      src.mSamples2[i] = 0;
+      src.mSqSamples1[i] = 0;
+    }
+  }
+
+  double mTotal;
+  double mTotal2;
+
+  // mTotal に足した値の二乗和
+  double mTotalSq;
+
+  vector<size_t> mSamples1;
+  vector<size_t> mSamples2;
+
+  // mSamples1 に足した値の二乗和
+  vector<ymuint64> mSqSamples1;
+
+  // trace モードの出力
+  ostringstream mOut;
+};
+
+// 全ての入力と論理ノードの obs の1の数を samples に足す．
+// sq_samples が NULL でない時はその二乗を sq_samples に足す．
+// 足した数の合計を返す．
+size_t
+count_obs(const TgNetwork& network,
+	  CalcCvf& calc,
+	  vector<size_t>& samples,
+	  vector<ymuint64>* sq_samples = NULL)
+{
+  size_t ni = network.input_num2();
+  size_t nl = network.logic_num();
+  size_t n_total = 0;
+  for (size_t i = 0; i < ni; ++ i) {
+    const TgNode* node = network.input(i);
+    tPackedVal obs = calc.get_obs(node);
+    size_t n = count_ones(obs);
+    samples[node->gid()] += n;
+    if ( sq_samples ) {
+      (*sq_samples)[node->gid()] += n * n;
+    }
+    n_total += n;
+  }
+  for (size_t i = 0; i < nl; ++ i) {
+    const TgNode* node = network.logic(i);
+    tPackedVal obs = calc.get_obs(node);
+    size_t n = count_ones(obs);
+    samples[node->gid()] += n;
+    if ( sq_samples ) {
+      (*sq_samples)[node->gid()] += n * n;
+    }
+    n_total += n;
+  }
+  return n_total;
+}
+
+// 全ての入力と論理ノードの obs を出力する．
+void
+dump_obs(const TgNetwork& network,
+	 CalcCvf& calc,
+	 ostream& out)
+{
+  size_t ni = network.input_num2();
+  size_t nl = network.logic_num();
+  for (size_t i = 0; i < ni; ++ i) {
+    const TgNode* node = network.input(i);
+    tPackedVal obs = calc.get_obs(node);
+    if ( node->name() ) {
+      out << setw(20) << std::setfill(' ') << node->name();
+    }
+    out << ": " << hex << setw(16) << std::setfill('0') << obs << dec << endl;
+  }
+  for (size_t i = 0; i < nl; ++ i) {
+    const TgNode* node = network.logic(i);
+    tPackedVal obs = calc.get_obs(node);
+    if ( node->name() ) {
+      out << setw(20) << std::setfill(' ') << node->name();
+    }
+    out << ": " << hex << setw(16) << std::setfill('0') << obs << dec << endl;
+  }
+}
+
+// [begin, end) 番目のサンプリングを行う．
+// 複数のスレッドから呼ばれるので calc, rgen, result はスレッドごとに
+// 別のものを渡す必要がある．
+void
+sample_loop(const TgNetwork* network,
+	    CalcCvf* calc,
+	    RandGen* rgen,
+	    const CvfOpt* opt,
+	    size_t begin,
+	    size_t end,
+	    CvfSample* result)
+{
+  size_t ni = network->input_num2();
+
+  // 乱数パタンはテストベクタを経由せずに入力ごとのビットベクタで作る．
+  vector<tPackedVal> ival_array(ni);
+
+  for (size_t l = begin; l < end; ++ l) {
+    TestVector::random_pack(*rgen, ni, ival_array);
+
+    if ( opt->mExact ) {
+      calc->calc_exact(ival_array);
+    }
+    else if ( opt->mMin ) {
+      calc->calc_pseudo_min(ival_array);
+    }
+    else if ( opt->mMax ) {
+      calc->calc_max(ival_array, opt->mMaxSample);
+    }
+    else if ( opt->mDiff ) {
+      calc->calc_exact(ival_array);
+      size_t n_total = count_obs(*network, *calc, result->mSamples1,
+				 &result->mSqSamples1);
+      double v = static_cast<double>(n_total) / static_cast<double>(kPvBitLen);
+      result->mTotal += v;
+      result->mTotalSq += v * v;
+
+      calc->calc_pseudo_min(ival_array);
+      size_t n_total2 = count_obs(*network, *calc, result->mSamples2);
+      result->mTotal2 += static_cast<double>(n_total2) / static_cast<double>(kPvBitLen);
+    }
+
+    if ( opt->mTrace ) {
+      ostream& out = result->mOut;
+      out << "===============[ " << l << " ]==============" << endl;
+      dump_obs(*network, *calc, out);
+      out << endl;
+    }
+    if ( opt->mTraceCount ) {
+      size_t n_total = count_obs(*network, *calc, result->mSamples1,
+				 &result->mSqSamples1);
+      double v = static_cast<double>(n_total) / static_cast<double>(kPvBitLen);
+      result->mTotal += v;
+      result->mTotalSq += v * v;
+    }
+  }
+}
+
+// サンプリングを行うスレッドの共有データ
+// スレッドは最初に作ったものを最後まで使い，収束判定のたびに
+// mRound を進めて次の範囲を割り当てる．
+struct SampleRound
+{
+  // コンストラクタ
+  SampleRound(const TgNetwork& network,
+	      const CvfOpt& opt,
+	      const vector<CalcCvf*>& calc_array,
+	      vector<RandGen>& rgen_array,
+	      const vector<CvfSample*>& result_array) :
+    mNetwork(network),
+    mOpt(opt),
+    mCalcArray(calc_array),
+    mRgenArray(rgen_array),
+    mResultArray(result_array),
+    mBegin(0),
+    mNum(0),
+    mRound(0),
+    mRunning(0),
+    mQuit(false)
+  {
+  }
+
+  // id 番目のスレッドに割り当てる範囲を [begin, end) で返す．
+  // mMutex をロックしているか，割り当てを変えるスレッドから呼ぶこと．
+  void
+  range(size_t id,
+	size_t& begin,
+	size_t& end) const
+  {
+    size_t nth = mCalcArray.size();
+    begin = mBegin + (mNum * id) / nth;
+    end = mBegin + (mNum * (id + 1)) / nth;
+  }
+
+  // 対象のネットワーク
+  const TgNetwork& mNetwork;
+
+  // サンプリングの方法
+  const CvfOpt& mOpt;
+
+  // スレッドごとの CalcCvf
+  const vector<CalcCvf*>& mCalcArray;
+
+  // スレッドごとの乱数発生器
+  vector<RandGen>& mRgenArray;
+
+  // スレッドごとの結果
+  const vector<CvfSample*>& mResultArray;
+
+  // 現在の範囲の先頭
+  size_t mBegin;
+
+  // 現在の範囲のループ数
+  size_t mNum;
+
+  // 範囲を割り当てた回数
+  size_t mRound;
+
+  // 現在の範囲を終えていないスレッド数(0 番目のスレッドは除く)
+  size_t mRunning;
+
+  // スレッドを終了させる時 true
+  bool mQuit;
+
+  // 上のデータを守るミューテックス
+  mutex mMutex;
+
+  // mRound と mQuit の変化を知らせる条件変数
+  condition_variable mStartCond;
+
+  // mRunning の変化を知らせる条件変数
+  condition_variable mDoneCond;
+};
+
+// @brief id 番目(id > 0)のサンプリングを行うスレッドの本体
+// @param[in] round 共有データ
+// @param[in] id スレッド番号
+// @note 0 番目の範囲は範囲を割り当てたスレッドが自分で行う．
+void
+sample_worker(SampleRound* round,
+	      size_t id)
+{
+  size_t last = 0;
+  for ( ; ; ) {
+    size_t begin;
+    size_t end;
+    {
+      unique_lock<mutex> lock(round->mMutex);
+      while ( !round->mQuit && round->mRound == last ) {
+	round->mStartCond.wait(lock);
+      }
+      if ( round->mQuit ) {
+	break;
+      }
+      last = round->mRound;
+      round->range(id, begin, end);
+    }
+
+    sample_loop(&round->mNetwork, round->mCalcArray[id],
+		&round->mRgenArray[id], &round->mOpt, begin, end,
+		round->mResultArray[id]);
+
+    {
+      lock_guard<mutex> lock(round->mMutex);
+      -- round->mRunning;
+    }
+    round->mDoneCond.notify_one();
+  }
+}
+
+// node の可観測性の推定値の信頼区間の幅の半分を求める．
+double
+node_error(const CvfSample& sample,
+	   const TgNode* node,
+	   size_t loop_num,
+	   double z)
+{
+  // 1回(kPvBitLen パタン)ごとの可観測性を標本とする．
+  double w = static_cast<double>(kPvBitLen);
+  double sum = sample.mSamples1[node->gid()] / w;
+  double sq_sum = sample.mSqSamples1[node->gid()] / (w * w);
+  return conf_interval(loop_num, sum, sq_sum, z);
+}
+
+// 可観測性の推定値の誤差を求める．
+// per_node が true の時は各ノードの信頼区間の幅の半分の最大値を，
+// false の時は Total の信頼区間の幅の半分をノード数で割ったものを返す．
+double
+calc_error(const TgNetwork& network,
+	   const CvfSample& sample,
+	   size_t loop_num,
+	   double z,
+	   bool per_node)
+{
+  size_t ni = network.input_num2();
+  size_t nl = network.logic_num();
+  if ( !per_node ) {
+    double e = conf_interval(loop_num, sample.mTotal, sample.mTotalSq, z);
+    return e / static_cast<double>(ni + nl);
+  }
+  double max_e = 0.0;
+  for (size_t i = 0; i < ni; ++ i) {
+    double e = node_error(sample, network.input(i), loop_num, z);
+    if ( max_e < e ) {
+      max_e = e;
+    }
+  }
+  for (size_t i = 0; i < nl; ++ i) {
+    double e = node_error(sample, network.logic(i), loop_num, z);
+    if ( max_e < e ) {
+      max_e = e;
+    }
+  }
+  return max_e;
+}
+
+END_NONAMESPACE
+
 // コマンド処理関数
 int
 CvfCmd::cmd_proc(TclObjVector& objv)
@@ -79,168 +448,244 @@ CvfCmd::cmd_proc(TclObjVector& objv)
   if ( mPoptLoop->is_specified() ) {
     loop_num = mPoptLoop->val();
   }
-  bool trace = mPoptTrace->is_specified();
-  bool trace_count = mPoptTraceCount->is_specified();
+  size_t thread_num = 1;
+  if ( mPoptThreads->is_specified() ) {
+    thread_num = mPoptThreads->val();
+    if ( thread_num == 0 ) {
+      thread_num = 1;
+    }
+  }
+  bool has_seed = mPoptSeed->is_specified();
+  ymuint32 seed = 0;
+  if ( has_seed ) {
+    seed = mPoptSeed->val();
+  }
+  bool adaptive = mPoptError->is_specified();
+  double error = 0.0;
+  double confidence = 0.95;
+  bool per_node = mPoptNodeError->is_specified();
+  if ( adaptive ) {
+    error = mPoptError->val();
+    if ( mPoptConf->is_specified() ) {
+      confidence = mPoptConf->val();
+    }
+    if ( error <= 0.0 || confidence <= 0.0 || confidence >= 1.0 ) {
+      print_usage();
+      return TCL_ERROR;
+    }
+    if ( !mPoptLoop->is_specified() ) {
+      // -loop は上限となる．
+      loop_num = kMaxLoop;
+    }
+  }
+  CvfOpt opt;
+  opt.mTrace = mPoptTrace->is_specified();
+  opt.mTraceCount = mPoptTraceCount->is_specified();
   bool init = mPoptInit->is_specified();
   bool dss = mPoptDss->is_specified();
   bool old_dss = mPoptOldDss->is_specified();
   bool gate = mPoptGate->is_specified();
-  bool exact = true;
-  bool min = false;
-  bool max = false;
-  int max_sample = 1;
-  bool diff = false;
+  opt.mExact = true;
+  opt.mMin = false;
+  opt.mMax = false;
+  opt.mMaxSample = 1;
+  opt.mDiff = false;
   if ( mPoptExact->is_specified() ) {
     ;
   }
   else if ( mPoptMin->is_specified() ) {
-    exact = false;
-    min = true;
-    max = false;
-    diff = false;
+    opt.mExact = false;
+    opt.mMin = true;
+    opt.mMax = false;
+    opt.mDiff = false;
   }
   else if ( mPoptMax->is_specified() ) {
-    exact = false;
-    min = false;
-    max = true;
-    diff = false;
+    opt.mExact = false;
+    opt.mMin = false;
+    opt.mMax = true;
+    opt.mDiff = false;
     if ( mPoptMaxSample->is_specified() ) {
-      max_sample = mPoptMaxSample->val();
+      opt.mMaxSample = mPoptMaxSample->val();
     }
   }
   else if ( mPoptDiff->is_specified() ) {
-    exact = false;
-    min = false;
-    max = false;
-    diff = true;
-    trace = false;
-    trace_count = false;
+    opt.mExact = false;
+    opt.mMin = false;
+    opt.mMax = false;
+    opt.mDiff = true;
+    opt.mTrace = false;
+    opt.mTraceCount = false;
+  }
+  if ( adaptive && !opt.mDiff ) {
+    // 収束判定のために数える必要がある．
+    opt.mTraceCount = true;
   }
+  bool trace_count = opt.mTraceCount;
+  bool diff = opt.mDiff;
   
   if ( init ) {
     mCalc.set_network(_network(), false);
+    mDss = false;
+    mNewAlgorithm = true;
     return TCL_OK;
   }
   else if ( dss ) {
     mCalc.set_network(_network(), true, true);
+    mDss = true;
+    mNewAlgorithm = true;
     return TCL_OK;
   }
   else if ( old_dss ) {
     mCalc.set_network(_network(), true, false);
+    mDss = true;
+    mNewAlgorithm = false;
     return TCL_OK;
   }
   
-  RandGen rgen;
-  
   ostringstream out;
   const TgNetwork& network = _network();
   
   size_t ni = network.input_num2();
   size_t nl = network.logic_num();
   size_t nn = network.node_num();
-  
-  vector<TestVector*> tv_array(kPvBitLen, NULL);
-  for (size_t i = 0; i < kPvBitLen; ++ i) {
-    tv_array[i] = TestVector::new_vector(ni);
+
+  // サンプリングを行うスレッド数
+  if ( thread_num > loop_num ) {
+    thread_num = loop_num;
   }
-  
-  double total = 0.0;
-  double total2 = 0.0;
-  vector<size_t> samples1(nn, 0);
-  vector<size_t> samples2(nn, 0);
-  for (size_t l = 0; l < loop_num; ++ l) {
-    for (size_t i = 0; i < kPvBitLen; ++ i) {
-      TestVector* tv = tv_array[i];
-      tv->set_from_random(rgen);
-    }
-    
-    if ( exact ) {
-      mCalc.calc_exact(tv_array);
-    }
-    else if ( min ) {
-      mCalc.calc_pseudo_min(tv_array);
-    }
-    else if ( max ) {
-      mCalc.calc_max(tv_array, max_sample);
-    }
-    else if ( diff ) {
-      mCalc.calc_exact(tv_array);
-      size_t n_total = 0;
-      for (size_t i = 0; i < ni; ++ i) {
-	const TgNode* node = network.input(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	size_t n = count_ones(obs);
-	samples1[node->gid()] += n;
-	n_total += n;
-      }
-      for (size_t i = 0; i < nl; ++ i) {
-	const TgNode* node = network.logic(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	size_t n = count_ones(obs);
-	samples1[node->gid()] += n;
-	n_total += n;
-      }
-      total += static_cast<double>(n_total) / static_cast<double>(kPvBitLen);
-      
-      mCalc.calc_pseudo_min(tv_array);
-      size_t n_total2 = 0;
-      for (size_t i = 0; i < ni; ++ i) {
-	const TgNode* node = network.input(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	size_t n = count_ones(obs);
-	samples2[node->gid()] += n;
-	n_total2 += n;
-      }
-      for (size_t i = 0; i < nl; ++ i) {
-	const TgNode* node = network.logic(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	size_t n = count_ones(obs);
-	samples2[node->gid()] += n;
-	n_total2 += n;
-      }
-      total2 += static_cast<double>(n_total2) / static_cast<double>(kPvBitLen);
+  if ( thread_num == 0 ) {
+    thread_num = 1;
+  }
+
+  // 乱数発生器はスレッドごとに独立に持ち，seed + スレッド番号で初期化する．
+  // 結果は seed とスレッド数が同じなら常に同じになる．
+  vector<RandGen> rgen_array(thread_num);
+  if ( has_seed || thread_num > 1 ) {
+    for (size_t i = 0; i < thread_num; ++ i) {
+      rgen_array[i].init(seed + i);
     }
+  }
 
-    if ( trace ) {
-      out << "===============[ " << l << " ]==============" << endl;
-      for (size_t i = 0; i < ni; ++ i) {
-	const TgNode* node = network.input(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	if ( node->name() ) {
-	  out << setw(20) << std::setfill(' ') << node->name();
-	}
-	out << ": " << hex << setw(16) << std::setfill('0') << obs << dec << endl;
-      }
-      for (size_t i = 0; i < nl; ++ i) {
-	const TgNode* node = network.logic(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	if ( node->name() ) {
-	  out << setw(20) << std::setfill(' ') << node->name();
-	}
-	out << ": " << hex << setw(16) << std::setfill('0') << obs << dec << endl;
-      }
-      out << endl;
+  // 0 番目のスレッドは mCalc を用い，それ以外のスレッドは
+  // 同じネットワークから CalcCvf を作り直す．
+  vector<CalcCvf*> calc_array(thread_num, NULL);
+  calc_array[0] = &mCalc;
+  for (size_t i = 1; i < thread_num; ++ i) {
+    calc_array[i] = new CalcCvf;
+    calc_array[i]->set_network(network, mDss, mNewAlgorithm);
+  }
+
+  vector<CvfSample*> result_array(thread_num, NULL);
+  for (size_t i = 0; i < thread_num; ++ i) {
+    result_array[i] = new CvfSample(nn);
+  }
+
+  // 全スレッドの結果の和
+  CvfSample sum(nn);
+
+  // -error が指定されていない時は全てのループを1回で行う．
+  // 指定されている時は各スレッドが kCheckInterval 回ずつ行うたびに
+  // 収束判定を行う．
+  // ループは連続した範囲に分けるので trace の出力は
+  // スレッド番号の順につなげれば元の順番になる．
+  double z = normal_quantile(confidence);
+  double achieved_error = 0.0;
+  bool converged = false;
+  size_t loop_count = 0;
+
+  // 1 番目以降のスレッドは最初に作って収束判定のたびに次の範囲を与える．
+  SampleRound round(network, opt, calc_array, rgen_array, result_array);
+  vector<thread> thread_list;
+  thread_list.reserve(thread_num - 1);
+  for (size_t i = 1; i < thread_num; ++ i) {
+    thread_list.push_back(thread(sample_worker, &round, i));
+  }
+
+  while ( loop_count < loop_num ) {
+    size_t n = loop_num - loop_count;
+    if ( adaptive && n > thread_num * kCheckInterval ) {
+      n = thread_num * kCheckInterval;
     }
-    if ( trace_count ) {
-      size_t n_total = 0;
-      for (size_t i = 0; i < ni; ++ i) {
-	const TgNode* node = network.input(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	size_t n = count_ones(obs);
-	samples1[node->gid()] += n;
-	n_total += n;
+    {
+      lock_guard<mutex> lock(round.mMutex);
+      round.mBegin = loop_count;
+      round.mNum = n;
+      round.mRunning = thread_num - 1;
+      ++ round.mRound;
+    }
+    round.mStartCond.notify_all();
+
+    size_t begin;
+    size_t end;
+    round.range(0, begin, end);
+    sample_loop(&network, calc_array[0], &rgen_array[0], &opt,
+		begin, end, result_array[0]);
+
+    {
+      unique_lock<mutex> lock(round.mMutex);
+      while ( round.mRunning > 0 ) {
+	round.mDoneCond.wait(lock);
       }
-      for (size_t i = 0; i < nl; ++ i) {
-	const TgNode* node = network.logic(i);
-	tPackedVal obs = mCalc.get_obs(node);
-	size_t n = count_ones(obs);
-	samples1[node->gid()] += n;
-	n_total += n;
+    }
+    loop_count += n;
+
+    // 各スレッドの結果をスレッド番号の順に足し合わせる．
+    for (size_t i = 0; i < thread_num; ++ i) {
+      CvfSample* result = result_array[i];
+      sum.merge(*result);
+      out << result->mOut.str();
+      result->mOut.str(string());
+    }
+
+    if ( adaptive && loop_count >= kCheckInterval ) {
+      achieved_error = calc_error(network, sum, loop_count, z, per_node);
+      if ( achieved_error <= error ) {
+	converged = true;
+	break;
       }
-      double v = static_cast<double>(n_total) / static_cast<double>(kPvBitLen);
-      total += v;
     }
   }
+
+  {
+    lock_guard<mutex> lock(round.mMutex);
+    round.mQuit = true;
+  }
+  round.mStartCond.notify_all();
+  for (size_t i = 0; i < thread_list.size(); ++ i) {
+    thread_list[i].join();
+  }
+  loop_num = loop_count;
+
+  for (size_t i = 0; i < thread_num; ++ i) {
+    delete result_array[i];
+  }
+  for (size_t i = 1; i < thread_num; ++ i) {
+    delete calc_array[i];
+  }
+
+  double total = sum.mTotal;
+  double total2 = sum.mTotal2;
+  const vector<size_t>& samples1 = sum.mSamples1;
+  const vector<size_t>& samples2 = sum.mSamples2;
+
+  if ( adaptive ) {
+    out << "Loops: " << loop_num;
+    if ( !converged ) {
+      out << " (not converged)";
+    }
+    out << endl;
+    out << "Error: +/- " << achieved_error
+	<< " (confidence " << confidence;
+    if ( per_node ) {
+      out << ", max. of nodes)" << endl;
+    }
+    else {
+      out << ", average per node)" << endl;
+      double e = conf_interval(loop_num, total, sum.mTotalSq, z);
+      out << "Total error: +/- " << e << endl;
+    }
+  }
+
   if ( trace_count ) {
     double ave = total / static_cast<double>(loop_num);
     out << "Total: " << ave << endl;
@@ -249,13 +694,21 @@ CvfCmd::cmd_proc(TclObjVector& objv)
 	const TgNode* node = network.input(i);
 	size_t n = samples1[node->gid()];
 	double d = n / static_cast<double>(loop_num * kPvBitLen);
-	out << node->name() << ": " << d << endl;
+	out << node->name() << ": " << d;
+	if ( adaptive ) {
+	  out << " +/- " << node_error(sum, node, loop_num, z);
+	}
+	out << endl;
       }
       for (size_t i = 0; i < nl; ++ i) {
 	const TgNode* node = network.logic(i);
 	size_t n = samples1[node->gid()];
 	double d = n / static_cast<double>(loop_num * kPvBitLen);
-	out << node->name() << ": " << d << endl;
+	out << node->name() << ": " << d;
+	if ( adaptive ) {
+	  out << " +/- " << node_error(sum, node, loop_num, z);
+	}
+	out << endl;
       }
     }
   }
@@ -300,10 +753,6 @@ CvfCmd::cmd_proc(TclObjVector& objv)
   TclObj msg = out.str();
   set_result(msg);
   
-  for (size_t i = 0; i < kPvBitLen; ++ i) {
-    TestVector::delete_vector(tv_array[i]);
-  }
-  
   return TCL_OK;
 }
 
@@ -81,8 +81,29 @@ private:
   
   // gate オプションの解析用オブジェクト
   TclPopt* mPoptGate;
+
+  // threads オプションの解析用オブジェクト
+  TclPoptUint* mPoptThreads;
+
+  // seed オプションの解析用オブジェクト
+  TclPoptUint* mPoptSeed;
+
+  // error オプションの解析用オブジェクト
+  TclPoptDouble* mPoptError;
+
+  // confidence オプションの解析用オブジェクト
+  TclPoptDouble* mPoptConf;
+
+  // node-error オプションの解析用オブジェクト
+  TclPopt* mPoptNodeError;
   
   CalcCvf mCalc;
+
+  // mCalc にセットした DSS フラグ
+  bool mDss;
+
+  // mCalc にセットした DSS のアルゴリズム
+  bool mNewAlgorithm;
   
 };
 
@@ -42,8 +42,8 @@ PoMark::~PoMark()
 void
 PoMark::init(size_t no)
 {
-  mBlockNum = (no + kPvBitLen - 1) / kPvBitLen;
-  mBitVector = new tPackedVal[mBlockNum];
+  mBlockNum = (no + kPvWordLen - 1) / kPvWordLen;
+  mBitVector = new tPvWord[mBlockNum];
   for (size_t i = 0; i < mBlockNum; ++ i) {
     mBitVector[i] = 0UL;
   }
@@ -67,8 +67,8 @@ PoMark::clear()
 void
 PoMark::set(size_t pos)
 {
-  size_t idx = pos / kPvBitLen;
-  size_t sft = pos % kPvBitLen;
+  size_t idx = pos / kPvWordLen;
+  size_t sft = pos % kPvWordLen;
   mBitVector[idx] |= (1UL << sft);
   if ( mStart > idx ) {
     mStart = idx;
@@ -25,6 +25,9 @@
 #include "SnOr.h"
 #include "SnXor.h"
 #include "NodeSet.h"
+#include "FvalSim.h"
+#include <thread>
+#include <mutex>
 
 
 BEGIN_NAMESPACE_YM_SEAL_SVF
@@ -35,7 +38,9 @@ BEGIN_NAMESPACE_YM_SEAL_SVF
 
 // @brief コンストラクタ
 CalcSvf::CalcSvf() :
-  mNodeAlloc(4096)
+  mNodeAlloc(4096),
+  mMaxLevel(0),
+  mFrameNum(1)
 {
 }
 
@@ -63,9 +68,22 @@ CalcSvf::clear()
   mOutputArray.clear();
   mOutput1Array.clear();
   mLogicArray.clear();
+  mTypeArray.clear();
+  mPpoArray.clear();
+  mPpiArray.clear();
+  for (vector<FvalSim*>::iterator p = mFvalSimArray.begin();
+       p != mFvalSimArray.end(); ++ p) {
+    delete *p;
+  }
+  mFvalSimArray.clear();
+  mFrameGvalArray.clear();
+  mIvalArray.clear();
+  mFrameNum = 1;
 
   mFFRArray.clear();
 
+  mFlatSim.clear();
+
   mClearArray.clear();
 
   mNodeAlloc.destroy();
@@ -107,10 +125,15 @@ END_NONAMESPACE
 
 
 // @brief シミュレーション対象のネットワークをセットする．
+// @param[in] network 対象のネットワーク
+// @param[in] time_frame 時間展開数
+// @param[in] dss DSS を求める時 true
+// @param[in] compact 時間展開を値の配列だけで行う時 true
 void
 CalcSvf::set_network(const TgNetwork& network,
 		     size_t time_frame,
-		     bool dss)
+		     bool dss,
+		     bool compact)
 {
   ASSERT_COND(time_frame > 0 );
 
@@ -125,12 +148,23 @@ CalcSvf::set_network(const TgNetwork& network,
   size_t no1 = mNetwork->output_num1();
   size_t nl = mNetwork->logic_num();
 
+  // compact の時は1フレーム分だけ作り，残りは値の配列で扱う．
+  if ( compact && time_frame > 1 ) {
+    mFrameNum = time_frame;
+    time_frame = 1;
+  }
+
   // SimNode の生成
   // 対応付けを行うマップの初期化
   mSimMapOffset = nn;
   mSimMap.resize(mSimMapOffset * time_frame);
   mInputArray.resize(ni + ni1 * (time_frame - 1));
-  mOutputArray.resize(no + no1 * (time_frame - 1));
+  if ( mFrameNum > 1 ) {
+    mOutputArray.resize(no1);
+  }
+  else {
+    mOutputArray.resize(no + no1 * (time_frame - 1));
+  }
   mOutput1Array.resize(no);
   mNodeArray.reserve(nn * time_frame);
 
@@ -245,15 +279,30 @@ CalcSvf::set_network(const TgNetwork& network,
     }
   }
 
-  // 外部出力に対応する SimNode の生成
-  size_t offset = nn * (time_frame - 1);
-  size_t ooffset = no1 * (time_frame - 1);
-  for (size_t i = no1; i < no; ++ i) {
-    const TgNode* onode = mNetwork->output(i);
-    SimNode* inode = find_simnode(onode->fanin(0), time_frame - 1);
-    inode->set_output();
-    mSimMap[onode->gid() + offset] = inode;
-    mOutputArray[i + ooffset] = inode;
+  if ( mFrameNum > 1 ) {
+    // フリップフロップの入力と出力の対応を記録しておく．
+    // 最後のタイムフレームのフリップフロップの入力は FvalSim が
+    // 外部出力として扱う．
+    for (size_t i = ni1; i < ni; ++ i) {
+      const TgNode* tgnode = mNetwork->input(i);
+      ASSERT_COND(tgnode->is_ffout() );
+      const TgNode* tginode = tgnode->alt_node();
+      ASSERT_COND(tginode != NULL && tginode->is_ffin() );
+      mPpoArray.push_back(find_simnode(tginode->fanin(0), 0));
+      mPpiArray.push_back(mInputArray[i]);
+    }
+  }
+  else {
+    // 外部出力に対応する SimNode の生成
+    size_t offset = nn * (time_frame - 1);
+    size_t ooffset = no1 * (time_frame - 1);
+    for (size_t i = no1; i < no; ++ i) {
+      const TgNode* onode = mNetwork->output(i);
+      SimNode* inode = find_simnode(onode->fanin(0), time_frame - 1);
+      inode->set_output();
+      mSimMap[onode->gid() + offset] = inode;
+      mOutputArray[i + ooffset] = inode;
+    }
   }
 
   // 各ノードのファンアウト数を数える．
@@ -320,24 +369,64 @@ CalcSvf::set_network(const TgNetwork& network,
   mClearArray.reserve(node_num);
 
   // 最大レベルを求め，イベントキューを初期化する．
-  size_t max_level = 0;
-  for (vector<SimNode*>::iterator p = mOutput1Array.begin();
-       p != mOutput1Array.end(); ++ p) {
+  // 2フレーム目以降のノードやファンアウトのないノードも含めて求める．
+  mMaxLevel = 0;
+  for (vector<SimNode*>::iterator p = mNodeArray.begin();
+       p != mNodeArray.end(); ++ p) {
     SimNode* node = *p;
-    if ( max_level < node->level() ) {
-      max_level = node->level();
+    if ( mMaxLevel < node->level() ) {
+      mMaxLevel = node->level();
+    }
+  }
+  mEventQ.init(mMaxLevel);
+
+  // 正常値と可観測性の計算用に平坦な配列に展開しておく．
+  mFlatSim.set(mNodeArray, mTypeArray);
+  mFrameGvalArray.resize(node_num * mFrameNum, kPvAll0);
+
+  // FFR の根を支配する FFR の根を求める．
+  // 値の配列で時間展開する時は支配関係がフレームをまたぐので求めない．
+  vector<SimNode*> idom_array;
+  if ( mFrameNum == 1 ) {
+    find_idom(idom_array);
+
+    // ID 番号の大きい方から順に最も近い FFR の根の支配点を求めておく．
+    // 支配点は必ず ID 番号が大きい．
+    vector<SimNode*> dom_array(node_num, NULL);
+    for (size_t i = node_num; i > 0; ) {
+      -- i;
+      SimNode* node = mNodeArray[i];
+      SimNode* idom = idom_array[node->id()];
+      if ( idom == NULL ) continue;
+      if ( idom->time_frame() == 0 && idom->ffr()->root() == idom ) {
+	dom_array[node->id()] = idom;
+      }
+      else {
+	dom_array[node->id()] = dom_array[idom->id()];
+      }
+    }
+    for (vector<SimFFR>::iterator p = mFFRArray.begin();
+	 p != mFFRArray.end(); ++ p) {
+      SimFFR& ffr = *p;
+      ffr.set_dom(dom_array[ffr.root()->id()]);
     }
   }
-  mEventQ.init(max_level);
 
   if ( dss ) {
-    find_dss();
+    // 時間展開した時は calc_exact2() が1フレーム目の出力で伝搬を
+    // 打ち切るので，支配点はそのまま使えない．
+    if ( time_frame > 1 ) {
+      idom_array.clear();
+    }
+    find_dss(idom_array);
   }
 }
 
 // @brief DSS を求める．
+// @param[in] idom_array ID 番号をキーにした直接支配点の配列
+// @note 直接支配点を持つ FFR の根はそれだけを DSS とする．
 void
-CalcSvf::find_dss()
+CalcSvf::find_dss(const vector<SimNode*>& idom_array)
 {
   size_t fn = mFFRArray.size();
   size_t no = mOutput1Array.size();
@@ -390,6 +479,13 @@ CalcSvf::find_dss()
 
     dss.clear();
 
+    if ( !idom_array.empty() && idom_array[node->id()] != NULL ) {
+      // 直接支配点が1つで DSS になる．
+      dss.push_back(idom_array[node->id()]);
+      ffr.set_dss(dss);
+      continue;
+    }
+
     // node のファンアウトを cur_set に入れる．
     cur_set.clear();
     size_t nfo = node->nfo();
@@ -584,6 +680,182 @@ CalcSvf::find_dss()
   }
 }
 
+BEGIN_NONAMESPACE
+
+// find_idom() で用いる無効な番号
+const ymuint32 kNone = static_cast<ymuint32>(-1);
+
+// Lengauer-Tarjan の EVAL 操作
+// v から森の根の手前までの間で semi が最小のノードを返す．
+// 途中の経路は圧縮する．
+// path は作業領域
+ymuint32
+eval_dom(ymuint32 v,
+	 vector<ymuint32>& ancestor_array,
+	 vector<ymuint32>& label_array,
+	 const vector<ymuint32>& semi_array,
+	 vector<ymuint32>& path)
+{
+  if ( ancestor_array[v] == kNone ) {
+    return v;
+  }
+
+  path.clear();
+  for (ymuint32 x = v; ancestor_array[ancestor_array[x]] != kNone;
+       x = ancestor_array[x]) {
+    path.push_back(x);
+  }
+  // 森の根に近い方から圧縮する．
+  for (size_t k = path.size(); k > 0; ) {
+    -- k;
+    ymuint32 x = path[k];
+    ymuint32 a = ancestor_array[x];
+    if ( semi_array[label_array[a]] < semi_array[label_array[x]] ) {
+      label_array[x] = label_array[a];
+    }
+    ancestor_array[x] = ancestor_array[a];
+  }
+  return label_array[v];
+}
+
+END_NONAMESPACE
+
+// @brief 各ノードの直接支配点を求める．
+// @param[out] idom_array ID 番号をキーにした直接支配点の配列
+// @note ファンアウトの向きを逆にし，全ての外部出力につながる仮想的な
+// ノードを根としたグラフに対して Lengauer-Tarjan のアルゴリズムを用いる．
+// 外部出力のノードからは仮想的な根以外には進まない．
+// @note スタックがあふれないように DFS と経路圧縮は再帰を用いずに行う．
+void
+CalcSvf::find_idom(vector<SimNode*>& idom_array)
+{
+  size_t nn = mNodeArray.size();
+  // 仮想的な根の ID 番号は nn とする．
+  size_t root_id = nn;
+
+  // 以下の配列は DFS の順序番号をキーにする．
+  // vertex_array[i]   : ノードの ID 番号
+  // parent_array[i]   : DFS 木の親の順序番号
+  // semi_array[i]     : 準支配点の順序番号
+  // label_array[i]    : 経路圧縮で求めた semi が最小のノードの順序番号
+  // ancestor_array[i] : 森の親の順序番号
+  // idom_num[i]       : 直接支配点の順序番号
+  // bucket_head/next  : 準支配点ごとのバケツ
+  vector<ymuint32> dfnum_array(nn + 1, kNone);
+  vector<ymuint32> vertex_array;
+  vertex_array.reserve(nn + 1);
+  vector<ymuint32> parent_array;
+  parent_array.reserve(nn + 1);
+
+  // 仮想的な根からの DFS
+  // 逆向きのグラフでの後続は外部出力でないファンインである．
+  vector<pair<ymuint32, ymuint32> > stack;
+  stack.reserve(nn + 1);
+  dfnum_array[root_id] = 0;
+  vertex_array.push_back(root_id);
+  parent_array.push_back(kNone);
+  stack.push_back(make_pair(root_id, 0U));
+  while ( !stack.empty() ) {
+    ymuint32 v = stack.back().first;
+    ymuint32& pos = stack.back().second;
+    SimNode* next = NULL;
+    if ( v == root_id ) {
+      while ( pos < mOutputArray.size() && next == NULL ) {
+	SimNode* onode = mOutputArray[pos];
+	++ pos;
+	if ( dfnum_array[onode->id()] == kNone ) {
+	  next = onode;
+	}
+      }
+    }
+    else {
+      SimNode* node = mNodeArray[v];
+      size_t ni = node->nfi();
+      while ( pos < ni && next == NULL ) {
+	SimNode* inode = node->fanin(pos);
+	++ pos;
+	if ( !inode->is_output() && dfnum_array[inode->id()] == kNone ) {
+	  next = inode;
+	}
+      }
+    }
+    if ( next == NULL ) {
+      stack.pop_back();
+      continue;
+    }
+    ymuint32 w = next->id();
+    dfnum_array[w] = vertex_array.size();
+    parent_array.push_back(dfnum_array[v]);
+    vertex_array.push_back(w);
+    stack.push_back(make_pair(w, 0U));
+  }
+
+  size_t n = vertex_array.size();
+  vector<ymuint32> semi_array(n);
+  vector<ymuint32> label_array(n);
+  vector<ymuint32> ancestor_array(n, kNone);
+  vector<ymuint32> idom_num(n, kNone);
+  vector<ymuint32> bucket_head(n, kNone);
+  vector<ymuint32> bucket_next(n, kNone);
+  for (size_t i = 0; i < n; ++ i) {
+    semi_array[i] = i;
+    label_array[i] = i;
+  }
+
+  // 経路圧縮の作業領域
+  vector<ymuint32> path;
+
+  for (size_t i = n - 1; i > 0; -- i) {
+    ymuint32 w = vertex_array[i];
+    SimNode* node = mNodeArray[w];
+
+    // 逆向きのグラフでの先行はファンアウト(外部出力なら仮想的な根)
+    // である．
+    size_t nfo = node->is_output() ? 1 : node->nfo();
+    for (size_t j = 0; j < nfo; ++ j) {
+      ymuint32 v = node->is_output() ? root_id : node->fanout(j)->id();
+      ymuint32 vnum = dfnum_array[v];
+      if ( vnum == kNone ) {
+	// 外部出力に到達しないノード
+	continue;
+      }
+      ymuint32 u = eval_dom(vnum, ancestor_array, label_array,
+			    semi_array, path);
+      if ( semi_array[u] < semi_array[i] ) {
+	semi_array[i] = semi_array[u];
+      }
+    }
+    ymuint32 s = semi_array[i];
+    bucket_next[i] = bucket_head[s];
+    bucket_head[s] = i;
+
+    ymuint32 p = parent_array[i];
+    ancestor_array[i] = p;
+
+    for (ymuint32 v = bucket_head[p]; v != kNone; v = bucket_next[v]) {
+      ymuint32 u = eval_dom(v, ancestor_array, label_array,
+			    semi_array, path);
+      idom_num[v] = (semi_array[u] < semi_array[v]) ? u : p;
+    }
+    bucket_head[p] = kNone;
+  }
+
+  for (size_t i = 1; i < n; ++ i) {
+    if ( idom_num[i] != semi_array[i] ) {
+      idom_num[i] = idom_num[idom_num[i]];
+    }
+  }
+
+  idom_array.clear();
+  idom_array.resize(nn, NULL);
+  for (size_t i = 1; i < n; ++ i) {
+    ymuint32 d = idom_num[i];
+    if ( d != 0 ) {
+      idom_array[vertex_array[i]] = mNodeArray[vertex_array[d]];
+    }
+  }
+}
+
 // @brief logic ノードを作る．
 SimNode*
 CalcSvf::make_logic(const Expr& lexp,
@@ -774,49 +1046,101 @@ CalcSvf::make_node(tTgGateType type,
     break;
   }
   mNodeArray.push_back(node);
+  mTypeArray.push_back(type);
   if ( type != kTgInput ) {
     mLogicArray.push_back(node);
   }
   return node;
 }
 
-// @brief 正常値のシミュレーションを行う．
+// @brief テストベクタの配列を入力ごとのビットベクタに変換する．
 // @param[in] tv_array テストベクタの配列
+// @note 結果は mIvalArray に入る．
+// @note tv_array の要素数が kPvBitLen に満たない時は残りのビットに
+// tv_array[0] の値を用いる．
 void
-CalcSvf::calc_gval(const vector<TestVector*>& tv_array)
+CalcSvf::pack_input(const vector<TestVector*>& tv_array)
 {
+  size_t ni = mNetwork->input_num2();
   size_t nt = tv_array.size();
+  if ( nt < kPvBitLen ) {
+    vector<TestVector*> tmp_array(tv_array);
+    tmp_array.resize(kPvBitLen, tv_array[0]);
+    TestVector::pack(tmp_array, ni, mIvalArray);
+  }
+  else {
+    TestVector::pack(tv_array, ni, mIvalArray);
+  }
+}
+
+// @brief 正常値のシミュレーションを行う．
+// @param[in] ival_array 入力番号をキーにした入力値の配列
+void
+CalcSvf::calc_gval(const vector<tPackedVal>& ival_array)
+{
   size_t ni = mNetwork->input_num2();
+  ASSERT_COND( ival_array.size() == ni );
   for (size_t i = 0; i < ni; ++ i) {
-    tPackedVal val = kPvAll0;
-    tPackedVal bit = 1UL;
-    for (size_t b = 0; b < nt; ++ b, bit <<= 1) {
-      if ( tv_array[b]->val(i) ) {
-	val |= bit;
-      }
+    SimNode* simnode = mInputArray[i];
+    mFlatSim.set_gval(simnode->id(), ival_array[i]);
+  }
+
+  mFlatSim.calc_gval();
+
+  // 故障シミュレーションは SimNode 上で行うので結果を書き戻しておく．
+  mFlatSim.store_gval();
+
+  // FvalSim のために1フレーム目の正常値を写しておく．
+  size_t nn = mNodeArray.size();
+  for (size_t i = 0; i < nn; ++ i) {
+    mFrameGvalArray[i] = mFlatSim.gval(i);
+  }
+
+  if ( mFrameNum == 1 ) {
+    return;
+  }
+
+  // 2フレーム目以降の正常値を求める．
+  // フリップフロップの出力には前のタイムフレームの入力の値を入れる．
+  // 外部入力は時間展開する場合と同じく 0 とする．
+  size_t ni1 = mNetwork->input_num1();
+  size_t nff = mPpoArray.size();
+  for (size_t f = 1; f < mFrameNum; ++ f) {
+    for (size_t i = 0; i < ni1; ++ i) {
+      mFlatSim.set_gval(mInputArray[i]->id(), kPvAll0);
     }
-    for (size_t b = nt; b < kPvBitLen; ++ b, bit <<= 1) {
-      if ( tv_array[0]->val(i) ) {
-	val |= bit;
-      }
+    size_t offset0 = (f - 1) * nn;
+    for (size_t i = 0; i < nff; ++ i) {
+      tPackedVal val = mFrameGvalArray[offset0 + mPpoArray[i]->id()];
+      mFlatSim.set_gval(mPpiArray[i]->id(), val);
+    }
+    mFlatSim.calc_gval();
+    size_t offset = f * nn;
+    for (size_t i = 0; i < nn; ++ i) {
+      mFrameGvalArray[offset + i] = mFlatSim.gval(i);
     }
-    SimNode* simnode = mInputArray[i];
-    simnode->set_gval(val);
   }
 
-  for (vector<SimNode*>::iterator q = mLogicArray.begin();
-       q != mLogicArray.end(); ++ q) {
-    SimNode* node = *q;
-    node->calc_gval();
+  // FFR 内の可観測性の計算は1フレーム目の値で行う．
+  for (size_t i = 0; i < nn; ++ i) {
+    mFlatSim.set_gval(i, mFrameGvalArray[i]);
   }
 }
 
 // @brief 全てのノードの出力に対する観測性の計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
+// @param[in] thread_num スレッド数
 void
-CalcSvf::calc_exact(const vector<TestVector*>& tv_array)
+CalcSvf::calc_exact(const vector<tPackedVal>& ival_array,
+		    size_t thread_num)
 {
-  calc_gval(tv_array);
+  calc_gval(ival_array);
+
+  // 値の配列で時間展開する時は FvalSim を用いる．
+  if ( mFrameNum > 1 || (thread_num > 1 && mFFRArray.size() > 1) ) {
+    calc_exact_mt(thread_num);
+    return;
+  }
 
   for (vector<SimFFR>::iterator p = mFFRArray.begin();
        p != mFFRArray.end(); ++ p) {
@@ -829,6 +1153,14 @@ CalcSvf::calc_exact(const vector<TestVector*>& tv_array)
       obs = kPvAll1;
     }
     else {
+      // root を支配する FFR の根があればそこで伝搬を打ち切り，
+      // 既に求めてある可観測性を用いる．
+      // mFFRArray は出力側から並んでいるので dom は処理済みである．
+      SimNode* dom = ffr.dom();
+      if ( dom ) {
+	dom->set_target();
+      }
+
       // root の値を反転させてその影響が PO で観測されるか調べる．
       tPackedVal pat = root->get_gval() ^ kPvAll1;
       root->set_fval(pat);
@@ -847,6 +1179,9 @@ CalcSvf::calc_exact(const vector<TestVector*>& tv_array)
 	  if ( node->is_output() ) {
 	    obs |= diff;
 	  }
+	  else if ( node->target() ) {
+	    obs |= diff & mFlatSim.obs(node->id());
+	  }
 	  else {
 	    size_t no = node->nfo();
 	    for (size_t i = 0; i < no; ++ i) {
@@ -861,19 +1196,173 @@ CalcSvf::calc_exact(const vector<TestVector*>& tv_array)
 	   p != mClearArray.end(); ++ p) {
 	(*p)->clear_fval();
       }
+
+      if ( dom ) {
+	dom->clear_target();
+      }
     }
 
-    // FFR 内のノードの obs を計算しセットする．
-    root->calc_iobs(obs, true);
+    mFlatSim.set_obs(root->id(), obs);
+  }
+
+  // FFR 内のノードの obs を計算しセットする．
+  mFlatSim.calc_ffr_obs();
+  mFlatSim.store_obs();
+}
+
+BEGIN_NONAMESPACE
+
+// 各スレッドが受け持つ FFR 番号の範囲 [mBegin, mEnd)
+struct FFRRange
+{
+  mutex mMutex;
+  size_t mBegin;
+  size_t mEnd;
+};
+
+// 次に処理する FFR 番号を取り出す．
+// 自分の範囲が空の時は他のスレッドの範囲の後半を盗んでくる．
+// 全ての範囲が空の時には false を返す．
+bool
+get_ffr(vector<FFRRange>& range_array,
+	size_t id,
+	size_t& ffr_id)
+{
+  FFRRange& my_range = range_array[id];
+  {
+    lock_guard<mutex> lock(my_range.mMutex);
+    if ( my_range.mBegin < my_range.mEnd ) {
+      ffr_id = my_range.mBegin;
+      ++ my_range.mBegin;
+      return true;
+    }
+  }
+
+  size_t n = range_array.size();
+  for (size_t k = 1; k < n; ++ k) {
+    FFRRange& victim = range_array[(id + k) % n];
+    size_t begin;
+    size_t end;
+    {
+      lock_guard<mutex> lock(victim.mMutex);
+      if ( victim.mBegin >= victim.mEnd ) {
+	continue;
+      }
+      begin = victim.mBegin + (victim.mEnd - victim.mBegin) / 2;
+      end = victim.mEnd;
+      victim.mEnd = begin;
+    }
+    ffr_id = begin;
+    {
+      lock_guard<mutex> lock(my_range.mMutex);
+      my_range.mBegin = begin + 1;
+      my_range.mEnd = end;
+    }
+    return true;
+  }
+  return false;
+}
+
+// calc_exact_mt() のワーカースレッドの本体
+// 故障値の初期化も各スレッドで自分の FvalSim に対して行う．
+void
+obs_worker(const vector<SimFFR>& ffr_array,
+	   FvalSim* fsim_ptr,
+	   vector<FFRRange>& range_array,
+	   size_t id,
+	   vector<tPackedVal>& obs_array)
+{
+  FvalSim& fsim = *fsim_ptr;
+  fsim.init();
+
+  size_t ffr_id;
+  while ( get_ffr(range_array, id, ffr_id) ) {
+    SimNode* root = ffr_array[ffr_id].root();
+    if ( root->is_output() ) {
+      // 外部出力ならすべて可観測
+      obs_array[ffr_id] = kPvAll1;
+    }
+    else {
+      obs_array[ffr_id] = fsim.calc_obs(root);
+    }
+  }
+}
+
+END_NONAMESPACE
+
+// @brief calc_exact() の故障伝搬を並列に行う．
+// @param[in] thread_num スレッド数
+// @note 各スレッドは自前の故障値とイベントキューを持つ FvalSim を用いて
+// FFR の根の可観測性を求める．FFR は最初に均等に分けておき，
+// 手の空いたスレッドが他のスレッドの残りを盗んで処理する．
+// FFR 内のノードの obs は最後に1つのスレッドでまとめて計算する．
+// @note thread_num が1の時はスレッドを作らずに FvalSim を用いる．
+// @note FvalSim は mFrameGvalArray を参照するので最初に1度だけ作り，
+// 呼ばれるたびには故障値だけを初期化する．
+void
+CalcSvf::calc_exact_mt(size_t thread_num)
+{
+  size_t nf = mFFRArray.size();
+  if ( thread_num > nf ) {
+    thread_num = nf;
+  }
+  if ( thread_num == 0 ) {
+    thread_num = 1;
+  }
+
+  vector<FFRRange> range_array(thread_num);
+  for (size_t i = 0; i < thread_num; ++ i) {
+    range_array[i].mBegin = (nf * i) / thread_num;
+    range_array[i].mEnd = (nf * (i + 1)) / thread_num;
   }
+
+  vector<FvalSim*>& fsim_array = mFvalSimArray;
+  const tPackedVal* gval_array =
+    mFrameGvalArray.empty() ? NULL : &mFrameGvalArray[0];
+  while ( fsim_array.size() < thread_num ) {
+    FvalSim* fsim = new FvalSim(mNodeArray, mMaxLevel);
+    fsim->set(gval_array, mFrameNum, mPpoArray, mPpiArray);
+    fsim_array.push_back(fsim);
+  }
+
+  vector<tPackedVal> obs_array(nf, kPvAll0);
+  if ( thread_num == 1 ) {
+    obs_worker(mFFRArray, fsim_array[0], range_array, 0, obs_array);
+  }
+  else {
+    vector<thread> thread_array;
+    thread_array.reserve(thread_num);
+    for (size_t i = 0; i < thread_num; ++ i) {
+      thread_array.push_back(thread(obs_worker,
+				    cref(mFFRArray),
+				    fsim_array[i],
+				    ref(range_array),
+				    i,
+				    ref(obs_array)));
+    }
+    for (vector<thread>::iterator p = thread_array.begin();
+	 p != thread_array.end(); ++ p) {
+      p->join();
+    }
+  }
+
+  // FFR 内のノードの obs を計算しセットする．
+  for (size_t i = 0; i < nf; ++ i) {
+    SimNode* root = mFFRArray[i].root();
+    mFlatSim.set_obs(root->id(), obs_array[i]);
+  }
+  mFlatSim.calc_ffr_obs();
+  mFlatSim.store_obs();
 }
 
 // @brief 全てのノードの出力に対する観測性の計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
 void
-CalcSvf::calc_exact2(const vector<TestVector*>& tv_array)
+CalcSvf::calc_exact2(const vector<tPackedVal>& ival_array)
 {
-  calc_gval(tv_array);
+  ASSERT_COND( mFrameNum == 1 );
+
+  calc_gval(ival_array);
 
   size_t no = mOutputArray.size();
   for (size_t i = 0; i < no; ++ i) {
@@ -956,32 +1445,32 @@ CalcSvf::calc_exact2(const vector<TestVector*>& tv_array)
 }
 
 // @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
 void
-CalcSvf::calc_pseudo_min(const vector<TestVector*>& tv_array)
+CalcSvf::calc_pseudo_min(const vector<tPackedVal>& ival_array)
 {
-  calc_gval(tv_array);
+  ASSERT_COND( mFrameNum == 1 );
+
+  calc_gval(ival_array);
 
   size_t no = mOutputArray.size();
   for (size_t i = 0; i < no; ++ i) {
     SimNode* node = mOutputArray[i];
-    node->set_obs(kPvAll1);
+    mFlatSim.set_obs(node->id(), kPvAll1);
   }
 
-  size_t nl = mLogicArray.size();
-  for (size_t i = nl; i > 0; ) {
-    -- i;
-    SimNode* node = mLogicArray[i];
-    node->calc_pseudo_min_iobs();
-  }
+  mFlatSim.calc_pseudo_min_obs();
+  mFlatSim.store_obs();
 }
 
 // @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
-// @param[in] tv_array テストベクタの配列
+// @param[in] ival_array 入力番号をキーにした入力値の配列
 void
-CalcSvf::calc_max(const vector<TestVector*>& tv_array)
+CalcSvf::calc_max(const vector<tPackedVal>& ival_array)
 {
-  calc_gval(tv_array);
+  ASSERT_COND( mFrameNum == 1 );
+
+  calc_gval(ival_array);
 
   size_t no = mOutputArray.size();
   for (size_t i = 0; i < no; ++ i) {
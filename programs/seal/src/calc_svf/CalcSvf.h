@@ -19,11 +19,13 @@
 #include <ym_lexp/Expr.h>
 #include <YmUtils/Alloc.h>
 #include "SimFFR.h"
+#include "FlatSim.h"
 
 
 BEGIN_NAMESPACE_YM_SEAL_SVF
 
 class SimNode;
+class FvalSim;
 
 //////////////////////////////////////////////////////////////////////
 /// @class CalcSvf CalcSvf.h "CalcSvf.h"
@@ -43,26 +45,62 @@ public:
 public:
 
   /// @brief シミュレーション対象のネットワークをセットする．
+  /// @param[in] network 対象のネットワーク
+  /// @param[in] time_frame 時間展開数
+  /// @param[in] dss DSS を求める時 true
+  /// @param[in] compact 時間展開を値の配列だけで行う時 true
+  /// @note compact が true の時は SimNode を1フレーム分しか作らず，
+  /// タイムフレームごとの正常値だけを持つ．この場合に使えるのは
+  /// calc_exact() だけとなる．
   void
   set_network(const TgNetwork& network,
 	      size_t time_frame,
-	      bool dss);
+	      bool dss,
+	      bool compact = false);
+
+  /// @brief 全てのノードの出力に対する観測性の計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  /// @param[in] thread_num スレッド数
+  /// @note thread_num が2以上の時は FFR の根からの故障伝搬を並列に行う．
+  /// 結果は thread_num によらず同じになる．
+  /// @note thread_num が1の時は FFR の根を支配する FFR の根で伝搬を
+  /// 打ち切り，そこで求めてある可観測性を用いる．
+  void
+  calc_exact(const vector<tPackedVal>& ival_array,
+	     size_t thread_num = 1);
 
   /// @brief 全てのノードの出力に対する観測性の計算を行う．
   /// @param[in] tv_array テストベクタの配列
+  /// @param[in] thread_num スレッド数
+  void
+  calc_exact(const vector<TestVector*>& tv_array,
+	     size_t thread_num = 1);
+
+  /// @brief 全てのノードの出力に対する観測性の計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
   void
-  calc_exact(const vector<TestVector*>& tv_array);
+  calc_exact2(const vector<tPackedVal>& ival_array);
 
   /// @brief 全てのノードの出力に対する観測性の計算を行う．
   /// @param[in] tv_array テストベクタの配列
   void
   calc_exact2(const vector<TestVector*>& tv_array);
 
+  /// @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  void
+  calc_pseudo_min(const vector<tPackedVal>& ival_array);
+
   /// @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
   /// @param[in] tv_array テストベクタの配列
   void
   calc_pseudo_min(const vector<TestVector*>& tv_array);
 
+  /// @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  void
+  calc_max(const vector<tPackedVal>& ival_array);
+
   /// @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
   /// @param[in] tv_array テストベクタの配列
   void
@@ -75,10 +113,21 @@ public:
 
 private:
   
-  /// @brief 正常値のシミュレーションを行う．
+  /// @brief テストベクタの配列を入力ごとのビットベクタに変換する．
   /// @param[in] tv_array テストベクタの配列
+  /// @note 結果は mIvalArray に入る．
+  void
+  pack_input(const vector<TestVector*>& tv_array);
+
+  /// @brief 正常値のシミュレーションを行う．
+  /// @param[in] ival_array 入力番号をキーにした入力値の配列
+  void
+  calc_gval(const vector<tPackedVal>& ival_array);
+
+  /// @brief calc_exact() の故障伝搬を FvalSim を用いて行う．
+  /// @param[in] thread_num スレッド数
   void
-  calc_gval(const vector<TestVector*>& tv_array);
+  calc_exact_mt(size_t thread_num);
 
   /// @brief SimNode のネットワークをダンプする．
   void
@@ -109,9 +158,21 @@ private:
   make_node(tTgGateType type,
 	    const vector<SimNode*>& inputs);
   
+  /// @brief 各ノードの直接支配点を求める．
+  /// @param[out] idom_array ID 番号をキーにした直接支配点の配列
+  /// @note ファンアウト方向に外部出力へ向かう経路について求める．
+  /// 外部出力で観測されるパタンは必ず直接支配点を通って伝搬する．
+  /// 直接支配点がない(外部出力の手前で合流しない)ノードと
+  /// 外部出力に到達しないノードの要素は NULL になる．
+  void
+  find_idom(vector<SimNode*>& idom_array);
+
   /// @brief DSS を求める．
+  /// @param[in] idom_array ID 番号をキーにした直接支配点の配列
+  /// @note 直接支配点を持つ FFR の根はそれだけを DSS とする．
+  /// idom_array が空の時は支配点を用いない．
   void
-  find_dss();
+  find_dss(const vector<SimNode*>& idom_array);
 
   
 private:
@@ -146,9 +207,42 @@ private:
   // 入力からのトポロジカル順に並べた logic ノードの配列
   vector<SimNode*> mLogicArray;
 
+  // ID 番号をキーにしたゲートの種類の配列
+  vector<tTgGateType> mTypeArray;
+
   // FFR を納めた配列
   vector<SimFFR> mFFRArray;
 
+  // 最大レベル
+  size_t mMaxLevel;
+
+  // 平坦な配列に展開したシミュレータ
+  FlatSim mFlatSim;
+
+  // 値の配列で扱うタイムフレーム数
+  // 時間展開で SimNode を作った時は 1
+  size_t mFrameNum;
+
+  // フリップフロップの入力に対応する SimNode を納めた配列
+  // mFrameNum > 1 の時のみ用いる．
+  vector<SimNode*> mPpoArray;
+
+  // フリップフロップの出力に対応する SimNode を納めた配列
+  // mPpoArray と同じ順に並んでいる．
+  vector<SimNode*> mPpiArray;
+
+  // (タイムフレーム番号 * ノード数 + ID 番号) をキーにした正常値の配列
+  // 2フレーム目以降は mFrameNum > 1 の時のみ用いる．
+  // mFvalSimArray の FvalSim はこの配列を参照する．
+  vector<tPackedVal> mFrameGvalArray;
+
+  // calc_exact_mt() でスレッドごとに用いる FvalSim の配列
+  // 必要になった時に作り，ネットワークを破棄するまで使い回す．
+  vector<FvalSim*> mFvalSimArray;
+
+  // テストベクタから変換した入力値の配列
+  vector<tPackedVal> mIvalArray;
+
   // イベントキュー
   EventQ mEventQ;
 
@@ -157,6 +251,48 @@ private:
   
 };
 
+// @brief 全てのノードの出力に対する観測性の計算を行う．
+// @param[in] tv_array テストベクタの配列
+// @param[in] thread_num スレッド数
+inline
+void
+CalcSvf::calc_exact(const vector<TestVector*>& tv_array,
+		    size_t thread_num)
+{
+  pack_input(tv_array);
+  calc_exact(mIvalArray, thread_num);
+}
+
+// @brief 全てのノードの出力に対する観測性の計算を行う．
+// @param[in] tv_array テストベクタの配列
+inline
+void
+CalcSvf::calc_exact2(const vector<TestVector*>& tv_array)
+{
+  pack_input(tv_array);
+  calc_exact2(mIvalArray);
+}
+
+// @brief 全てのノードの出力に対する観測性の最小値もどきの計算を行う．
+// @param[in] tv_array テストベクタの配列
+inline
+void
+CalcSvf::calc_pseudo_min(const vector<TestVector*>& tv_array)
+{
+  pack_input(tv_array);
+  calc_pseudo_min(mIvalArray);
+}
+
+// @brief 全てのノードの出力に対する観測性の最大値の計算を行う．
+// @param[in] tv_array テストベクタの配列
+inline
+void
+CalcSvf::calc_max(const vector<TestVector*>& tv_array)
+{
+  pack_input(tv_array);
+  calc_max(mIvalArray);
+}
+
 // @brief node に対応する SimNode* を得る．
 inline
 SimNode*
@@ -0,0 +1,480 @@
+﻿
+/// @file calc_svf/FlatSim.cc
+/// @brief FlatSim の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2008 Yusuke Matsunaga
+/// All rights reserved.
+
+#if HAVE_CONFIG_H
+#include "seal_config.h"
+#endif
+
+
+#include "FlatSim.h"
+#include "SimNode.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_YM_SEAL_SVF
+
+BEGIN_NONAMESPACE
+
+// グループ分けのためのキー
+struct FlatKey
+{
+  size_t mLevel;
+  int mKind;
+  ymuint32 mId;
+};
+
+// FlatKey の比較関数
+// レベル，種類，ID 番号の順に比較する．
+bool
+operator<(const FlatKey& left,
+	  const FlatKey& right)
+{
+  if ( left.mLevel != right.mLevel ) {
+    return left.mLevel < right.mLevel;
+  }
+  if ( left.mKind != right.mKind ) {
+    return left.mKind < right.mKind;
+  }
+  return left.mId < right.mId;
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// SimNode のネットワークを平坦な配列に展開したシミュレータ
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+FlatSim::FlatSim()
+{
+}
+
+// @brief デストラクタ
+FlatSim::~FlatSim()
+{
+}
+
+// @brief SimNode のネットワークから作る．
+// @param[in] node_array 全ての SimNode を納めた配列
+// @param[in] type_array ID 番号をキーにしたゲートの種類の配列
+void
+FlatSim::set(const vector<SimNode*>& node_array,
+	     const vector<tTgGateType>& type_array)
+{
+  clear();
+
+  size_t n = node_array.size();
+  ASSERT_COND( type_array.size() == n );
+
+  mNodeArray = node_array;
+  mGvalArray.resize(n, kPvAll0);
+  mObsArray.resize(n, kPvAll0);
+  mStopArray.resize(n, 0);
+
+  vector<FlatKey> key_array;
+  key_array.reserve(n);
+  size_t nf = 0;
+  size_t max_ni = 0;
+  for (size_t i = 0; i < n; ++ i) {
+    SimNode* node = node_array[i];
+    ASSERT_COND( node->id() == i );
+    if ( node->is_output() || node->is_output1() || node->nfo() != 1 ) {
+      mStopArray[i] = 1;
+    }
+    if ( type_array[i] == kTgInput ) {
+      continue;
+    }
+    size_t ni = node->nfi();
+    FlatKey key;
+    key.mLevel = node->level();
+    key.mKind = get_kind(type_array[i], ni);
+    key.mId = i;
+    key_array.push_back(key);
+    nf += ni;
+    if ( max_ni < ni ) {
+      max_ni = ni;
+    }
+  }
+  sort(key_array.begin(), key_array.end());
+
+  size_t nl = key_array.size();
+  mIdArray.reserve(nl);
+  mFaninPos.reserve(nl + 1);
+  mFaninArray.reserve(nf);
+  for (size_t i = 0; i < nl; ++ i) {
+    const FlatKey& key = key_array[i];
+    if ( i == 0 ||
+	 key.mLevel != key_array[i - 1].mLevel ||
+	 key.mKind != key_array[i - 1].mKind ) {
+      Group group;
+      group.mKind = static_cast<tKind>(key.mKind);
+      group.mBegin = i;
+      group.mEnd = i;
+      mGroupArray.push_back(group);
+    }
+    ++ mGroupArray.back().mEnd;
+
+    SimNode* node = node_array[key.mId];
+    mIdArray.push_back(key.mId);
+    mFaninPos.push_back(mFaninArray.size());
+    size_t ni = node->nfi();
+    for (size_t j = 0; j < ni; ++ j) {
+      mFaninArray.push_back(node->fanin(j)->id());
+    }
+  }
+  mFaninPos.push_back(mFaninArray.size());
+
+  mTmp.resize(max_ni, kPvAll0);
+}
+
+// @brief 内容をクリアする．
+void
+FlatSim::clear()
+{
+  mNodeArray.clear();
+  mGvalArray.clear();
+  mObsArray.clear();
+  mStopArray.clear();
+  mGroupArray.clear();
+  mIdArray.clear();
+  mFaninPos.clear();
+  mFaninArray.clear();
+  mTmp.clear();
+}
+
+// @brief 全ての論理ノードの正常値を計算する．
+// @note 外部入力の値は set_gval() でセットしておくこと．
+// @note 全てのノードの可観測性は 0 になる．
+void
+FlatSim::calc_gval()
+{
+  tPackedVal* gval = &mGvalArray[0];
+  const ymuint32* fanin = &mFaninArray[0];
+  const ymuint32* fpos = &mFaninPos[0];
+  const ymuint32* id = &mIdArray[0];
+  for (vector<Group>::const_iterator p = mGroupArray.begin();
+       p != mGroupArray.end(); ++ p) {
+    const Group& group = *p;
+    size_t begin = group.mBegin;
+    size_t end = group.mEnd;
+    switch ( group.mKind ) {
+    case kBuff:
+      for (size_t i = begin; i < end; ++ i) {
+	gval[id[i]] = gval[fanin[fpos[i]]];
+      }
+      break;
+
+    case kNot:
+      for (size_t i = begin; i < end; ++ i) {
+	gval[id[i]] = ~gval[fanin[fpos[i]]];
+      }
+      break;
+
+    case kAnd2:
+      for (size_t i = begin; i < end; ++ i) {
+	const ymuint32* f = &fanin[fpos[i]];
+	gval[id[i]] = gval[f[0]] & gval[f[1]];
+      }
+      break;
+
+    case kNand2:
+      for (size_t i = begin; i < end; ++ i) {
+	const ymuint32* f = &fanin[fpos[i]];
+	gval[id[i]] = ~(gval[f[0]] & gval[f[1]]);
+      }
+      break;
+
+    case kOr2:
+      for (size_t i = begin; i < end; ++ i) {
+	const ymuint32* f = &fanin[fpos[i]];
+	gval[id[i]] = gval[f[0]] | gval[f[1]];
+      }
+      break;
+
+    case kNor2:
+      for (size_t i = begin; i < end; ++ i) {
+	const ymuint32* f = &fanin[fpos[i]];
+	gval[id[i]] = ~(gval[f[0]] | gval[f[1]]);
+      }
+      break;
+
+    case kXor2:
+      for (size_t i = begin; i < end; ++ i) {
+	const ymuint32* f = &fanin[fpos[i]];
+	gval[id[i]] = gval[f[0]] ^ gval[f[1]];
+      }
+      break;
+
+    case kXnor2:
+      for (size_t i = begin; i < end; ++ i) {
+	const ymuint32* f = &fanin[fpos[i]];
+	gval[id[i]] = ~(gval[f[0]] ^ gval[f[1]]);
+      }
+      break;
+
+    case kAnd:
+    case kNand:
+      for (size_t i = begin; i < end; ++ i) {
+	size_t e = fpos[i + 1];
+	tPackedVal val = gval[fanin[fpos[i]]];
+	for (size_t j = fpos[i] + 1; j < e; ++ j) {
+	  val &= gval[fanin[j]];
+	}
+	gval[id[i]] = (group.mKind == kAnd) ? val : ~val;
+      }
+      break;
+
+    case kOr:
+    case kNor:
+      for (size_t i = begin; i < end; ++ i) {
+	size_t e = fpos[i + 1];
+	tPackedVal val = gval[fanin[fpos[i]]];
+	for (size_t j = fpos[i] + 1; j < e; ++ j) {
+	  val |= gval[fanin[j]];
+	}
+	gval[id[i]] = (group.mKind == kOr) ? val : ~val;
+      }
+      break;
+
+    case kXor:
+    case kXnor:
+      for (size_t i = begin; i < end; ++ i) {
+	size_t e = fpos[i + 1];
+	tPackedVal val = gval[fanin[fpos[i]]];
+	for (size_t j = fpos[i] + 1; j < e; ++ j) {
+	  val ^= gval[fanin[j]];
+	}
+	gval[id[i]] = (group.mKind == kXor) ? val : ~val;
+      }
+      break;
+    }
+  }
+
+  fill(mObsArray.begin(), mObsArray.end(), kPvAll0);
+}
+
+// @brief FFR 内のノードの可観測性を計算する．
+// @note FFR の根の可観測性は set_obs() でセットしておくこと．
+// @note FFR の境界のノードには書き込まないので，FFR の根を処理する順番に
+// よらず SimNode::calc_iobs() と同じ結果になる．
+void
+FlatSim::calc_ffr_obs()
+{
+  const tPackedVal* gval = &mGvalArray[0];
+  tPackedVal* obs = &mObsArray[0];
+  const ymuint8* stop = &mStopArray[0];
+  const ymuint32* fanin = &mFaninArray[0];
+  const ymuint32* fpos = &mFaninPos[0];
+  const ymuint32* id = &mIdArray[0];
+  for (size_t g = mGroupArray.size(); g > 0; ) {
+    -- g;
+    const Group& group = mGroupArray[g];
+    size_t begin = group.mBegin;
+    for (size_t i = group.mEnd; i > begin; ) {
+      -- i;
+      tPackedVal o = obs[id[i]];
+      if ( o == kPvAll0 ) {
+	continue;
+      }
+      const ymuint32* f = &fanin[fpos[i]];
+      switch ( group.mKind ) {
+      case kAnd2:
+      case kNand2:
+	if ( !stop[f[0]] ) {
+	  obs[f[0]] = o & gval[f[1]];
+	}
+	if ( !stop[f[1]] ) {
+	  obs[f[1]] = o & gval[f[0]];
+	}
+	break;
+
+      case kOr2:
+      case kNor2:
+	if ( !stop[f[0]] ) {
+	  obs[f[0]] = o & ~gval[f[1]];
+	}
+	if ( !stop[f[1]] ) {
+	  obs[f[1]] = o & ~gval[f[0]];
+	}
+	break;
+
+      case kBuff:
+      case kNot:
+      case kXor2:
+      case kXnor2:
+      case kXor:
+      case kXnor:
+	{
+	  size_t n = fpos[i + 1] - fpos[i];
+	  for (size_t j = 0; j < n; ++ j) {
+	    if ( !stop[f[j]] ) {
+	      obs[f[j]] = o;
+	    }
+	  }
+	}
+	break;
+
+      case kAnd:
+      case kNand:
+	calc_and_iobs(i, o, false, true);
+	break;
+
+      case kOr:
+      case kNor:
+	calc_and_iobs(i, o, true, true);
+	break;
+      }
+    }
+  }
+}
+
+// @brief 可観測性の最小値もどきを計算する．
+// @note 外部出力の可観測性は set_obs() でセットしておくこと．
+// @note SimNode::calc_pseudo_min_iobs() を逆順に行うのと同じ．
+void
+FlatSim::calc_pseudo_min_obs()
+{
+  const tPackedVal* gval = &mGvalArray[0];
+  tPackedVal* obs = &mObsArray[0];
+  const ymuint32* fanin = &mFaninArray[0];
+  const ymuint32* fpos = &mFaninPos[0];
+  const ymuint32* id = &mIdArray[0];
+  for (size_t g = mGroupArray.size(); g > 0; ) {
+    -- g;
+    const Group& group = mGroupArray[g];
+    size_t begin = group.mBegin;
+    for (size_t i = group.mEnd; i > begin; ) {
+      -- i;
+      tPackedVal o = obs[id[i]];
+      if ( o == kPvAll0 ) {
+	continue;
+      }
+      const ymuint32* f = &fanin[fpos[i]];
+      switch ( group.mKind ) {
+      case kAnd2:
+      case kNand2:
+	obs[f[0]] |= o & gval[f[1]];
+	obs[f[1]] |= o & gval[f[0]];
+	break;
+
+      case kOr2:
+      case kNor2:
+	obs[f[0]] |= o & ~gval[f[1]];
+	obs[f[1]] |= o & ~gval[f[0]];
+	break;
+
+      case kBuff:
+      case kNot:
+      case kXor2:
+      case kXnor2:
+      case kXor:
+      case kXnor:
+	{
+	  size_t n = fpos[i + 1] - fpos[i];
+	  for (size_t j = 0; j < n; ++ j) {
+	    obs[f[j]] |= o;
+	  }
+	}
+	break;
+
+      case kAnd:
+      case kNand:
+	calc_and_iobs(i, o, false, false);
+	break;
+
+      case kOr:
+      case kNor:
+	calc_and_iobs(i, o, true, false);
+	break;
+      }
+    }
+  }
+}
+
+// @brief 正常値を SimNode に書き戻す．
+// @note SimNode の可観測性は 0 になる．
+void
+FlatSim::store_gval() const
+{
+  size_t n = mNodeArray.size();
+  for (size_t i = 0; i < n; ++ i) {
+    mNodeArray[i]->set_gval(mGvalArray[i]);
+  }
+}
+
+// @brief 可観測性を SimNode に書き戻す．
+void
+FlatSim::store_obs() const
+{
+  size_t n = mNodeArray.size();
+  for (size_t i = 0; i < n; ++ i) {
+    mNodeArray[i]->set_obs(mObsArray[i]);
+  }
+}
+
+// @brief ゲートの種類とファンイン数から tKind を求める．
+FlatSim::tKind
+FlatSim::get_kind(tTgGateType type,
+		  size_t ni)
+{
+  switch ( type ) {
+  case kTgBuff: return kBuff;
+  case kTgNot:  return kNot;
+  case kTgAnd:  return ni == 2 ? kAnd2  : kAnd;
+  case kTgNand: return ni == 2 ? kNand2 : kNand;
+  case kTgOr:   return ni == 2 ? kOr2   : kOr;
+  case kTgNor:  return ni == 2 ? kNor2  : kNor;
+  case kTgXor:  return ni == 2 ? kXor2  : kXor;
+  case kTgXnor: return ni == 2 ? kXnor2 : kXnor;
+  default:
+    break;
+  }
+  ASSERT_NOT_REACHED;
+  return kBuff;
+}
+
+// @brief AND 系のゲートの入力の可観測性を計算する．
+// @param[in] pos mIdArray 上の位置
+// @param[in] obs 出力の可観測性
+// @param[in] inv ファンインの値を反転させる時 true
+// @param[in] ffr FFR の中だけを計算する時 true
+// @note ファンイン i の可観測性は obs と i 以外のファンインの値の AND
+// なので，後ろからの累積を mTmp に入れておいて前から順に求める．
+void
+FlatSim::calc_and_iobs(size_t pos,
+		       tPackedVal obs,
+		       bool inv,
+		       bool ffr)
+{
+  const ymuint32* f = &mFaninArray[mFaninPos[pos]];
+  size_t ni = mFaninPos[pos + 1] - mFaninPos[pos];
+  tPackedVal tmp0 = kPvAll1;
+  for (size_t i = ni; i > 0; ) {
+    -- i;
+    mTmp[i] = tmp0;
+    tPackedVal val = mGvalArray[f[i]];
+    tmp0 &= inv ? ~val : val;
+  }
+  tmp0 = obs;
+  for (size_t i = 0; i < ni; ++ i) {
+    ymuint32 iid = f[i];
+    if ( ffr ) {
+      if ( !mStopArray[iid] ) {
+	mObsArray[iid] = tmp0 & mTmp[i];
+      }
+    }
+    else {
+      mObsArray[iid] |= tmp0 & mTmp[i];
+    }
+    tPackedVal val = mGvalArray[iid];
+    tmp0 &= inv ? ~val : val;
+  }
+}
+
+END_NAMESPACE_YM_SEAL_SVF
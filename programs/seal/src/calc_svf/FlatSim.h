@@ -0,0 +1,242 @@
+﻿#ifndef CALC_SVF_FLATSIM_H
+#define CALC_SVF_FLATSIM_H
+
+/// @file calc_svf/FlatSim.h
+/// @brief FlatSim のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2008 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "nsdef.h"
+#include "seal_utils.h"
+#include <YmNetworks/TgGateTemplate.h>
+
+
+BEGIN_NAMESPACE_YM_SEAL_SVF
+
+class SimNode;
+
+//////////////////////////////////////////////////////////////////////
+/// @class FlatSim FlatSim.h "FlatSim.h"
+/// @brief SimNode のネットワークを平坦な配列に展開したシミュレータ
+///
+/// 論理ノードをレベルとゲートの種類でグループ分けし，ファンインの
+/// ID 番号を連続した配列に並べておく．正常値と可観測性の計算は
+/// グループごとに種類で分岐するだけで，ノードごとの仮想関数呼び出しは
+/// 行わない．
+/// 同じレベルのノードの間には依存関係がないので，レベルの中で
+/// 並べ替えても結果は SimNode を用いた計算と同じになる．
+//////////////////////////////////////////////////////////////////////
+class FlatSim
+{
+public:
+
+  /// @brief コンストラクタ
+  FlatSim();
+
+  /// @brief デストラクタ
+  ~FlatSim();
+
+
+public:
+
+  /// @brief SimNode のネットワークから作る．
+  /// @param[in] node_array 全ての SimNode を納めた配列
+  /// @param[in] type_array ID 番号をキーにしたゲートの種類の配列
+  void
+  set(const vector<SimNode*>& node_array,
+      const vector<tTgGateType>& type_array);
+
+  /// @brief 内容をクリアする．
+  void
+  clear();
+
+  /// @brief 正常値をセットする．
+  /// @param[in] id ノードの ID 番号
+  /// @param[in] val 値
+  /// @note 通常は外部入力に対して行われる．
+  void
+  set_gval(ymuint32 id,
+	   tPackedVal val);
+
+  /// @brief 正常値を得る．
+  /// @param[in] id ノードの ID 番号
+  tPackedVal
+  gval(ymuint32 id) const;
+
+  /// @brief 可観測性をセットする．
+  /// @param[in] id ノードの ID 番号
+  /// @param[in] val 値
+  void
+  set_obs(ymuint32 id,
+	  tPackedVal val);
+
+  /// @brief 可観測性を得る．
+  /// @param[in] id ノードの ID 番号
+  tPackedVal
+  obs(ymuint32 id) const;
+
+  /// @brief 全ての論理ノードの正常値を計算する．
+  /// @note 外部入力の値は set_gval() でセットしておくこと．
+  /// @note 全てのノードの可観測性は 0 になる．
+  void
+  calc_gval();
+
+  /// @brief FFR 内のノードの可観測性を計算する．
+  /// @note FFR の根の可観測性は set_obs() でセットしておくこと．
+  /// @note SimNode::calc_iobs() を全ての FFR の根に対して行うのと同じ．
+  void
+  calc_ffr_obs();
+
+  /// @brief 可観測性の最小値もどきを計算する．
+  /// @note 外部出力の可観測性は set_obs() でセットしておくこと．
+  /// @note SimNode::calc_pseudo_min_iobs() を逆順に行うのと同じ．
+  void
+  calc_pseudo_min_obs();
+
+  /// @brief 正常値を SimNode に書き戻す．
+  /// @note SimNode の可観測性は 0 になる．
+  void
+  store_gval() const;
+
+  /// @brief 可観測性を SimNode に書き戻す．
+  void
+  store_obs() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // ゲートの種類
+  enum tKind {
+    kBuff,
+    kNot,
+    kAnd2,
+    kAnd,
+    kNand2,
+    kNand,
+    kOr2,
+    kOr,
+    kNor2,
+    kNor,
+    kXor2,
+    kXor,
+    kXnor2,
+    kXnor
+  };
+
+  // 同じレベルで同じ種類のノードのグループ
+  // mIdArray 上の [mBegin, mEnd) のノードを表す．
+  struct Group
+  {
+    tKind mKind;
+    ymuint32 mBegin;
+    ymuint32 mEnd;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ゲートの種類とファンイン数から tKind を求める．
+  static
+  tKind
+  get_kind(tTgGateType type,
+	   size_t ni);
+
+  /// @brief AND 系のゲートの入力の可観測性を計算する．
+  /// @param[in] pos mIdArray 上の位置
+  /// @param[in] obs 出力の可観測性
+  /// @param[in] inv ファンインの値を反転させる時 true
+  /// @param[in] ffr FFR の中だけを計算する時 true
+  void
+  calc_and_iobs(size_t pos,
+		tPackedVal obs,
+		bool inv,
+		bool ffr);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 全ての SimNode を納めた配列
+  vector<SimNode*> mNodeArray;
+
+  // ID 番号をキーにした正常値の配列
+  vector<tPackedVal> mGvalArray;
+
+  // ID 番号をキーにした可観測性の配列
+  vector<tPackedVal> mObsArray;
+
+  // ID 番号をキーにした FFR の境界の印
+  // 外部出力，1フレーム目の出力，ファンアウト数が1でないノードの時 1 になる．
+  vector<ymuint8> mStopArray;
+
+  // グループの配列
+  // レベルの昇順に並んでいる．
+  vector<Group> mGroupArray;
+
+  // グループ順に並べた論理ノードの ID 番号の配列
+  vector<ymuint32> mIdArray;
+
+  // mIdArray の各ノードのファンインの mFaninArray 上の先頭位置
+  // 最後の要素は番兵
+  vector<ymuint32> mFaninPos;
+
+  // ファンインの ID 番号の配列
+  vector<ymuint32> mFaninArray;
+
+  // calc_and_iobs() で用いる作業領域
+  vector<tPackedVal> mTmp;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 正常値をセットする．
+inline
+void
+FlatSim::set_gval(ymuint32 id,
+		  tPackedVal val)
+{
+  mGvalArray[id] = val;
+}
+
+// @brief 正常値を得る．
+inline
+tPackedVal
+FlatSim::gval(ymuint32 id) const
+{
+  return mGvalArray[id];
+}
+
+// @brief 可観測性をセットする．
+inline
+void
+FlatSim::set_obs(ymuint32 id,
+		 tPackedVal val)
+{
+  mObsArray[id] = val;
+}
+
+// @brief 可観測性を得る．
+inline
+tPackedVal
+FlatSim::obs(ymuint32 id) const
+{
+  return mObsArray[id];
+}
+
+END_NAMESPACE_YM_SEAL_SVF
+
+#endif // CALC_SVF_FLATSIM_H
@@ -0,0 +1,242 @@
+﻿
+/// @file calc_svf/FvalSim.cc
+/// @brief FvalSim の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2008 Yusuke Matsunaga
+/// All rights reserved.
+
+#if HAVE_CONFIG_H
+#include "seal_config.h"
+#endif
+
+
+#include "FvalSim.h"
+#include "SimNode.h"
+
+
+BEGIN_NAMESPACE_YM_SEAL_SVF
+
+//////////////////////////////////////////////////////////////////////
+// 自前の故障値を持つ故障シミュレータ
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] node_array 全ての SimNode を納めた配列
+// @param[in] max_level 最大レベル
+FvalSim::FvalSim(const vector<SimNode*>& node_array,
+		 size_t max_level) :
+  mNodeArray(node_array),
+  mFrameNum(1),
+  mGvalArray(NULL),
+  mQueueArray(max_level + 1, NULL),
+  mLinkArray(node_array.size(), NULL),
+  mInQueue(node_array.size(), false),
+  mCurLevel(0),
+  mNum(0)
+{
+  // mClearArray の最大サイズは全ノード数
+  mClearArray.reserve(node_array.size());
+}
+
+// @brief デストラクタ
+FvalSim::~FvalSim()
+{
+}
+
+// @brief 正常値の配列とフリップフロップの対応を設定する．
+// @param[in] gval_array 正常値の配列
+// @param[in] frame_num タイムフレーム数
+// @param[in] ppo_array フリップフロップの入力に対応するノードの配列
+// @param[in] ppi_array フリップフロップの出力に対応するノードの配列
+void
+FvalSim::set(const tPackedVal* gval_array,
+	     size_t frame_num,
+	     const vector<SimNode*>& ppo_array,
+	     const vector<SimNode*>& ppi_array)
+{
+  ASSERT_COND( ppo_array.size() == ppi_array.size() );
+
+  size_t n = mNodeArray.size();
+  mFrameNum = frame_num;
+  mGvalArray = gval_array;
+  mFvalArray.clear();
+  mFvalArray.resize(n * frame_num);
+  mClearArray.reserve(n * frame_num);
+
+  // ppo_array のノードごとに ppi_array のノードをまとめておく．
+  size_t nff = ppo_array.size();
+  mPpiPos.clear();
+  mPpiList.clear();
+  if ( nff == 0 ) {
+    return;
+  }
+  mPpiPos.resize(n + 1, 0);
+  for (size_t i = 0; i < nff; ++ i) {
+    ++ mPpiPos[ppo_array[i]->id() + 1];
+  }
+  for (size_t i = 0; i < n; ++ i) {
+    mPpiPos[i + 1] += mPpiPos[i];
+  }
+  mPpiList.resize(nff);
+  vector<ymuint32> pos(mPpiPos.begin(), mPpiPos.end() - 1);
+  for (size_t i = 0; i < nff; ++ i) {
+    mPpiList[pos[ppo_array[i]->id()] ++] = ppi_array[i]->id();
+  }
+}
+
+// @brief 故障値を正常値で初期化する．
+void
+FvalSim::init()
+{
+  size_t nv = mFvalArray.size();
+  for (size_t i = 0; i < nv; ++ i) {
+    mFvalArray[i] = mGvalArray[i];
+  }
+}
+
+// @brief root の値を反転させた時の可観測性を求める．
+// @param[in] root FFR の根のノード
+// @return 外部出力で観測されるパタンを返す．
+// @note CalcSvf::calc_exact() の故障伝搬と同じ処理を自前の故障値で行う．
+tPackedVal
+FvalSim::calc_obs(SimNode* root)
+{
+  tPackedVal obs = kPvAll0;
+
+  size_t n = mNodeArray.size();
+  mClearArray.clear();
+  mCarryArray.clear();
+
+  size_t id = root->id();
+  mFvalArray[id] = mGvalArray[id] ^ kPvAll1;
+  mClearArray.push_back(id);
+  record(root, kPvAll1, 0, obs);
+
+  for (size_t frame = 0; ; ) {
+    const tPackedVal* gval_array = &mGvalArray[frame * n];
+    tPackedVal* fval_array = &mFvalArray[frame * n];
+    for ( ; ; ) {
+      SimNode* node = get();
+      if ( node == NULL ) break;
+      tPackedVal diff = node->calc_fval(gval_array, fval_array, ~obs);
+      if ( diff != kPvAll0 ) {
+	mClearArray.push_back(frame * n + node->id());
+	record(node, diff, frame, obs);
+      }
+    }
+
+    ++ frame;
+    if ( frame == mFrameNum || mCarryArray.empty() ) {
+      break;
+    }
+
+    // フリップフロップの入力の故障差を次のタイムフレームの
+    // 擬似外部入力に移す．
+    mCarryArray2.swap(mCarryArray);
+    mCarryArray.clear();
+    for (vector<SimNode*>::iterator p = mCarryArray2.begin();
+	 p != mCarryArray2.end(); ++ p) {
+      SimNode* node = *p;
+      size_t pos0 = (frame - 1) * n + node->id();
+      tPackedVal diff = (mFvalArray[pos0] ^ mGvalArray[pos0]) & ~obs;
+      if ( diff == kPvAll0 ) {
+	continue;
+      }
+      size_t e = mPpiPos[node->id() + 1];
+      for (size_t i = mPpiPos[node->id()]; i < e; ++ i) {
+	ymuint32 iid = mPpiList[i];
+	size_t pos = frame * n + iid;
+	mFvalArray[pos] = mGvalArray[pos] ^ diff;
+	mClearArray.push_back(pos);
+	record(mNodeArray[iid], diff, frame, obs);
+      }
+    }
+  }
+
+  // 今の故障シミュレーションで値の変わったノードを元にもどしておく
+  for (vector<size_t>::iterator p = mClearArray.begin();
+       p != mClearArray.end(); ++ p) {
+    size_t pos = *p;
+    mFvalArray[pos] = mGvalArray[pos];
+  }
+
+  return obs;
+}
+
+// @brief 故障差のあるノードを記録する．
+// @param[in] node ノード
+// @param[in] diff 故障差
+// @param[in] frame タイムフレーム
+// @param[in,out] obs 外部出力で観測されるパタン
+// @note 外部出力なら obs に加え，そうでなければファンアウトをキューに積む．
+// フリップフロップの入力なら次のタイムフレームに移すために
+// mCarryArray に入れておく．
+void
+FvalSim::record(SimNode* node,
+		tPackedVal diff,
+		size_t frame,
+		tPackedVal& obs)
+{
+  if ( node->is_output() ) {
+    obs |= diff;
+    return;
+  }
+  if ( !mPpiPos.empty() ) {
+    size_t id = node->id();
+    if ( mPpiPos[id] < mPpiPos[id + 1] ) {
+      if ( frame + 1 == mFrameNum ) {
+	// 最後のタイムフレームでは外部出力とみなす．
+	obs |= diff;
+	return;
+      }
+      mCarryArray.push_back(node);
+    }
+  }
+  size_t no = node->nfo();
+  for (size_t i = 0; i < no; ++ i) {
+    put(node->fanout(i));
+  }
+}
+
+// @brief キューに積む
+void
+FvalSim::put(SimNode* node)
+{
+  size_t id = node->id();
+  if ( !mInQueue[id] ) {
+    mInQueue[id] = true;
+    size_t level = node->level();
+    SimNode*& w = mQueueArray[level];
+    mLinkArray[id] = w;
+    w = node;
+    if ( mNum == 0 || mCurLevel > level ) {
+      mCurLevel = level;
+    }
+    ++ mNum;
+  }
+}
+
+// @brief キューから取り出す．
+// @retval NULL キューが空だった．
+SimNode*
+FvalSim::get()
+{
+  if ( mNum > 0 ) {
+    // mNum が正しければ mCurLevel がオーバーフローすることはない．
+    for ( ; ; ++ mCurLevel) {
+      SimNode*& w = mQueueArray[mCurLevel];
+      SimNode* node = w;
+      if ( node ) {
+	size_t id = node->id();
+	mInQueue[id] = false;
+	w = mLinkArray[id];
+	-- mNum;
+	return node;
+      }
+    }
+  }
+  return NULL;
+}
+
+END_NAMESPACE_YM_SEAL_SVF
@@ -0,0 +1,161 @@
+﻿#ifndef CALC_SVF_FVALSIM_H
+#define CALC_SVF_FVALSIM_H
+
+/// @file calc_svf/FvalSim.h
+/// @brief FvalSim のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2008 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "nsdef.h"
+#include "seal_utils.h"
+
+
+BEGIN_NAMESPACE_YM_SEAL_SVF
+
+class SimNode;
+
+//////////////////////////////////////////////////////////////////////
+/// @class FvalSim FvalSim.h "FvalSim.h"
+/// @brief 自前の故障値を持つ故障シミュレータ
+///
+/// 故障値，イベントキュー，値を元に戻すためのリストを全て自分で持ち，
+/// SimNode の状態を変えないので，スレッドごとに1つずつ用いれば
+/// 複数の FFR の根からの故障伝搬を並列に行うことができる．
+///
+/// 時間展開を行わないネットワークに対しては，タイムフレームごとの
+/// 正常値の配列を与えると，フリップフロップの入力に現れた故障差を
+/// 次のタイムフレームの擬似外部入力に移して伝搬を続ける．
+///
+/// 正常値の配列は複製せずに参照するので，複数の FvalSim で共有できる．
+/// set() は最初に1度だけ呼び，正常値が変わるたびに init() で
+/// 故障値だけを初期化する．
+//////////////////////////////////////////////////////////////////////
+class FvalSim
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] node_array 全ての SimNode を納めた配列
+  /// @param[in] max_level 最大レベル
+  FvalSim(const vector<SimNode*>& node_array,
+	  size_t max_level);
+
+  /// @brief デストラクタ
+  ~FvalSim();
+
+
+public:
+
+  /// @brief 正常値の配列とフリップフロップの対応を設定する．
+  /// @param[in] gval_array 正常値の配列
+  /// @param[in] frame_num タイムフレーム数
+  /// @param[in] ppo_array フリップフロップの入力に対応するノードの配列
+  /// @param[in] ppi_array フリップフロップの出力に対応するノードの配列
+  /// @note タイムフレーム f のノード id の正常値は
+  /// gval_array[f * ノード数 + id] に入っている．
+  /// gval_array はこの FvalSim を使い終わるまで変えずに置いておくこと．
+  /// @note ppo_array[i] のタイムフレーム f の値が ppi_array[i] の
+  /// タイムフレーム f + 1 の値となる．
+  /// @note 最後のタイムフレームの ppo_array のノードは外部出力とみなす．
+  /// @note 時間展開しない時は frame_num = 1 で ppo_array と ppi_array を
+  /// 空にする．
+  void
+  set(const tPackedVal* gval_array,
+      size_t frame_num,
+      const vector<SimNode*>& ppo_array,
+      const vector<SimNode*>& ppi_array);
+
+  /// @brief 故障値を正常値で初期化する．
+  /// @note set() で与えた配列の正常値が変わるたびに呼ぶ必要がある．
+  void
+  init();
+
+  /// @brief root の値を反転させた時の可観測性を求める．
+  /// @param[in] root FFR の根のノード
+  /// @return 外部出力で観測されるパタンを返す．
+  tPackedVal
+  calc_obs(SimNode* root);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 故障差のあるノードを記録する．
+  /// @param[in] node ノード
+  /// @param[in] diff 故障差
+  /// @param[in] frame タイムフレーム
+  /// @param[in,out] obs 外部出力で観測されるパタン
+  void
+  record(SimNode* node,
+	 tPackedVal diff,
+	 size_t frame,
+	 tPackedVal& obs);
+
+  /// @brief キューに積む
+  void
+  put(SimNode* node);
+
+  /// @brief キューから取り出す．
+  /// @retval NULL キューが空だった．
+  SimNode*
+  get();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 全ての SimNode を納めた配列
+  const vector<SimNode*>& mNodeArray;
+
+  // タイムフレーム数
+  size_t mFrameNum;
+
+  // (タイムフレーム番号 * ノード数 + ID 番号) をキーにした正常値の配列
+  // 持ち主は FvalSim の外にある．
+  const tPackedVal* mGvalArray;
+
+  // (タイムフレーム番号 * ノード数 + ID 番号) をキーにした故障値の配列
+  vector<tPackedVal> mFvalArray;
+
+  // ID 番号をキーにした mPpiList 上の先頭位置
+  // 最後の要素は番兵．フリップフロップがない時は空
+  vector<ymuint32> mPpiPos;
+
+  // フリップフロップの入力のノードごとの擬似外部入力の ID 番号のリスト
+  vector<ymuint32> mPpiList;
+
+  // 次のタイムフレームに故障差を移すノードの配列
+  vector<SimNode*> mCarryArray;
+
+  // mCarryArray の作業用の配列
+  vector<SimNode*> mCarryArray2;
+
+  // レベルごとのキューの先頭ノードの配列
+  vector<SimNode*> mQueueArray;
+
+  // ID 番号をキーにしたキューの次のノードの配列
+  vector<SimNode*> mLinkArray;
+
+  // ID 番号をキーにしたキューに積まれている印
+  vector<bool> mInQueue;
+
+  // 現在のレベル
+  size_t mCurLevel;
+
+  // キューに入っているノード数
+  size_t mNum;
+
+  // 故障値を元にもどすために mFvalArray 上の位置を入れておく配列
+  vector<size_t> mClearArray;
+
+};
+
+END_NAMESPACE_YM_SEAL_SVF
+
+#endif // CALC_SVF_FVALSIM_H
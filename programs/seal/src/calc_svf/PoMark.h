@@ -78,7 +78,7 @@ private:
   size_t mBlockNum;
   
   // 要素の集合を表すビットベクタ
-  tPackedVal* mBitVector;
+  tPvWord* mBitVector;
 
   // 非0 要素の最初のブロック
   size_t mStart;
@@ -169,8 +169,8 @@ check(const PoMark& left,
   }
   bool overlap = false;
   for (size_t i = s; i < e; ++ i) {
-    tPackedVal l = left.mBitVector[i];
-    tPackedVal r = right.mBitVector[i];
+    tPvWord l = left.mBitVector[i];
+    tPvWord r = right.mBitVector[i];
     if ( l & r ) {
       overlap = true;
       if ( l & ~r ) {
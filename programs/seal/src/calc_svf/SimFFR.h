@@ -42,6 +42,16 @@ public:
   /// @brief 根のノードを得る．
   SimNode*
   root() const;
+
+  /// @brief 根を支配する FFR の根を設定する．
+  void
+  set_dom(SimNode* dom);
+
+  /// @brief 根を支配する FFR の根のうち最も近いものを得る．
+  /// @note 根から外部出力への経路が全てこのノードを通る．
+  /// そのようなノードがない時は NULL を返す．
+  SimNode*
+  dom() const;
   
   /// @breif DSS ノードを設定する．
   void
@@ -68,6 +78,9 @@ private:
   // 根のノード
   SimNode* mRoot;
 
+  // 根を支配する FFR の根
+  SimNode* mDom;
+
   // DSS のリスト
   vector<SimNode*> mDSS;
   
@@ -80,7 +93,8 @@ private:
   
 // @brief コンストラクタ
 inline
-SimFFR::SimFFR()
+SimFFR::SimFFR() :
+  mDom(NULL)
 {
 }
 
@@ -105,6 +119,22 @@ SimFFR::root() const
 {
   return mRoot;
 }
+
+// @brief 根を支配する FFR の根を設定する．
+inline
+void
+SimFFR::set_dom(SimNode* dom)
+{
+  mDom = dom;
+}
+
+// @brief 根を支配する FFR の根のうち最も近いものを得る．
+inline
+SimNode*
+SimFFR::dom() const
+{
+  return mDom;
+}
   
 // @brief DSS ノードのリストを取り出す．
 inline
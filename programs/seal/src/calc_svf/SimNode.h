@@ -132,6 +132,20 @@ public:
   virtual
   tPackedVal
   calc_fval(tPackedVal mask);
+
+  /// @brief 正常値と故障値の配列を用いて故障値の計算を行う．
+  /// @param[in] gval_array ID 番号をキーにした正常値の配列
+  /// @param[in] fval_array ID 番号をキーにした故障値の配列
+  /// @param[in] mask マスク値
+  /// @return 故障差を返す．
+  /// @note 結果は mFval ではなく fval_array[id()] にセットされる．
+  /// @note ノードの状態を変えないので，異なる fval_array を用いれば
+  /// 複数のスレッドから同時に呼び出せる．
+  /// @note gval_array を取り替えれば別のタイムフレームの値でも計算できる．
+  tPackedVal
+  calc_fval(const tPackedVal* gval_array,
+	    tPackedVal* fval_array,
+	    tPackedVal mask);
   
   /// @brief 出力の obs を設定する．
   void
@@ -198,6 +212,11 @@ private:
   virtual
   tPackedVal
   _calc_fval() = 0;
+
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array) = 0;
   
   /// @brief calc_iobs の下請け関数
   virtual
@@ -434,6 +453,24 @@ SimNode::calc_fval(tPackedVal mask)
   return diff;
 }
 
+// @brief 正常値と故障値の配列を用いて故障値の計算を行う．
+// @param[in] gval_array ID 番号をキーにした正常値の配列
+// @param[in] fval_array ID 番号をキーにした故障値の配列
+// @param[in] mask マスク値
+// @return 故障差を返す．
+// @note 結果は fval_array[id()] にセットされる．
+inline
+tPackedVal
+SimNode::calc_fval(const tPackedVal* gval_array,
+		   tPackedVal* fval_array,
+		   tPackedVal mask)
+{
+  tPackedVal val = _calc_fval(fval_array);
+  tPackedVal diff = (gval_array[mId] ^ val) & mask;
+  fval_array[mId] ^= diff;
+  return diff;
+}
+
 // @brief 出力における観測性を得る．
 inline
 tPackedVal
@@ -58,6 +58,18 @@ SnAnd::_calc_fval()
   return new_val;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnAnd::_calc_fval(const tPackedVal* fval_array)
+{
+  size_t n = mNfi;
+  tPackedVal new_val = fval_array[mFanins[0]->id()];
+  for (size_t i = 1; i < n; ++ i) {
+    new_val &= fval_array[mFanins[i]->id()];
+  }
+  return new_val;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnAnd::calc_pseudo_min_iobs()
@@ -102,7 +114,7 @@ void
 SnAnd::_calc_iobs(tPackedVal obs)
 {
   size_t ni = mNfi;
-  tPackedVal tmp0 = ~0UL;
+  tPackedVal tmp0 = kPvAll1;
   for (size_t i = 1; i <= ni; ++ i) {
     size_t j = ni - i;
     mTmp[j] = tmp0;
@@ -163,6 +175,15 @@ SnAnd2::_calc_fval()
   return pat0 & pat1;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnAnd2::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  return pat0 & pat1;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnAnd2::calc_pseudo_min_iobs()
@@ -237,6 +258,16 @@ SnAnd3::_calc_fval()
   return pat0 & pat1 & pat2;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnAnd3::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  return pat0 & pat1 & pat2;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnAnd3::calc_pseudo_min_iobs()
@@ -329,6 +360,17 @@ SnAnd4::_calc_fval()
   return pat0 & pat1 & pat2 & pat3;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnAnd4::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  tPackedVal pat3 = fval_array[mFanins[3]->id()];
+  return pat0 & pat1 & pat2 & pat3;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnAnd4::calc_pseudo_min_iobs()
@@ -446,6 +488,18 @@ SnNand::_calc_fval()
   return ~new_val;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNand::_calc_fval(const tPackedVal* fval_array)
+{
+  size_t n = mNfi;
+  tPackedVal new_val = fval_array[mFanins[0]->id()];
+  for (size_t i = 1; i < n; ++ i) {
+    new_val &= fval_array[mFanins[i]->id()];
+  }
+  return ~new_val;
+}
+
 // @brief 内容をダンプする．
 void
 SnNand::dump(ostream& s) const
@@ -493,6 +547,15 @@ SnNand2::_calc_fval()
   return ~(pat0 & pat1);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNand2::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  return ~(pat0 & pat1);
+}
+
 // @brief 内容をダンプする．
 void
 SnNand2::dump(ostream& s) const
@@ -539,6 +602,16 @@ SnNand3::_calc_fval()
   return ~(pat0 & pat1 & pat2);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNand3::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  return ~(pat0 & pat1 & pat2);
+}
+
 // @brief 内容をダンプする．
 void
 SnNand3::dump(ostream& s) const
@@ -588,6 +661,17 @@ SnNand4::_calc_fval()
   return ~(pat0 & pat1 & pat2 & pat3);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNand4::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  tPackedVal pat3 = fval_array[mFanins[3]->id()];
+  return ~(pat0 & pat1 & pat2 & pat3);
+}
+
 // @brief 内容をダンプする．
 void
 SnNand4::dump(ostream& s) const
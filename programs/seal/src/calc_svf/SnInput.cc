@@ -63,6 +63,13 @@ SnInput::_calc_fval()
   return kPvAll0;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnInput::_calc_fval(const tPackedVal* fval_array)
+{
+  return kPvAll0;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnInput::calc_pseudo_min_iobs()
@@ -119,6 +126,13 @@ SnBuff::_calc_fval()
   return mFanin->get_fval();
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnBuff::_calc_fval(const tPackedVal* fval_array)
+{
+  return fval_array[mFanin->id()];
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnBuff::calc_pseudo_min_iobs()
@@ -178,6 +192,13 @@ SnNot::_calc_fval()
   return ~mFanin->get_fval();
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNot::_calc_fval(const tPackedVal* fval_array)
+{
+  return ~fval_array[mFanin->id()];
+}
+
 // @brief 内容をダンプする．
 void
 SnNot::dump(ostream& s) const
@@ -56,6 +56,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -109,6 +114,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -162,6 +172,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 内容をダンプする．
   virtual
   void
@@ -58,6 +58,18 @@ SnOr::_calc_fval()
   return new_val;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnOr::_calc_fval(const tPackedVal* fval_array)
+{
+  size_t n = mNfi;
+  tPackedVal new_val = fval_array[mFanins[0]->id()];
+  for (size_t i = 1; i < n; ++ i) {
+    new_val |= fval_array[mFanins[i]->id()];
+  }
+  return new_val;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnOr::calc_pseudo_min_iobs()
@@ -163,6 +175,15 @@ SnOr2::_calc_fval()
   return pat0 | pat1;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnOr2::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  return pat0 | pat1;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnOr2::calc_pseudo_min_iobs()
@@ -237,6 +258,16 @@ SnOr3::_calc_fval()
   return pat0 | pat1 | pat2;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnOr3::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  return pat0 | pat1 | pat2;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnOr3::calc_pseudo_min_iobs()
@@ -329,6 +360,17 @@ SnOr4::_calc_fval()
   return pat0 | pat1 | pat2 | pat3;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnOr4::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  tPackedVal pat3 = fval_array[mFanins[3]->id()];
+  return pat0 | pat1 | pat2 | pat3;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnOr4::calc_pseudo_min_iobs()
@@ -445,6 +487,18 @@ SnNor::_calc_fval()
   return ~new_val;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNor::_calc_fval(const tPackedVal* fval_array)
+{
+  size_t n = mNfi;
+  tPackedVal new_val = fval_array[mFanins[0]->id()];
+  for (size_t i = 1; i < n; ++ i) {
+    new_val |= fval_array[mFanins[i]->id()];
+  }
+  return ~new_val;
+}
+
 // @brief 内容をダンプする．
 void
 SnNor::dump(ostream& s) const
@@ -492,6 +546,15 @@ SnNor2::_calc_fval()
   return ~(pat0 | pat1);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNor2::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  return ~(pat0 | pat1);
+}
+
 // @brief 内容をダンプする．
 void
 SnNor2::dump(ostream& s) const
@@ -538,6 +601,16 @@ SnNor3::_calc_fval()
   return ~(pat0 | pat1 | pat2);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNor3::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  return ~(pat0 | pat1 | pat2);
+}
+
 // @brief 内容をダンプする．
 void
 SnNor3::dump(ostream& s) const
@@ -587,6 +660,17 @@ SnNor4::_calc_fval()
   return ~(pat0 | pat1 | pat2 | pat3);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnNor4::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  tPackedVal pat2 = fval_array[mFanins[2]->id()];
+  tPackedVal pat3 = fval_array[mFanins[3]->id()];
+  return ~(pat0 | pat1 | pat2 | pat3);
+}
+
 // @brief 内容をダンプする．
 void
 SnNor4::dump(ostream& s) const
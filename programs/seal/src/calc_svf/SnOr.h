@@ -45,6 +45,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -98,6 +103,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -151,6 +161,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -204,6 +219,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -257,6 +277,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 内容をダンプする．
   virtual
   void
@@ -294,6 +319,11 @@ public:
   virtual
   tPackedVal
   _calc_fval();
+
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
   
   /// @brief 内容をダンプする．
   virtual
@@ -332,6 +362,11 @@ public:
   virtual
   tPackedVal
   _calc_fval();
+
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
   
   /// @brief 内容をダンプする．
   virtual
@@ -370,6 +405,11 @@ public:
   virtual
   tPackedVal
   _calc_fval();
+
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
   
   /// @brief 内容をダンプする．
   virtual
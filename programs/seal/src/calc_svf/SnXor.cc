@@ -58,6 +58,18 @@ SnXor::_calc_fval()
   return new_val;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnXor::_calc_fval(const tPackedVal* fval_array)
+{
+  size_t n = mNfi;
+  tPackedVal new_val = fval_array[mFanins[0]->id()];
+  for (size_t i = 1; i < n; ++ i) {
+    new_val ^= fval_array[mFanins[i]->id()];
+  }
+  return new_val;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnXor::calc_pseudo_min_iobs()
@@ -134,6 +146,15 @@ SnXor2::_calc_fval()
   return pat0 ^ pat1;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnXor2::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  return pat0 ^ pat1;
+}
+
 // @brief 入力の擬似最小 obs を計算する．
 void
 SnXor2::calc_pseudo_min_iobs()
@@ -210,6 +231,18 @@ SnXnor::_calc_fval()
   return ~new_val;
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnXnor::_calc_fval(const tPackedVal* fval_array)
+{
+  size_t n = mNfi;
+  tPackedVal new_val = fval_array[mFanins[0]->id()];
+  for (size_t i = 1; i < n; ++ i) {
+    new_val ^= fval_array[mFanins[i]->id()];
+  }
+  return ~new_val;
+}
+
 // @brief 内容をダンプする．
 void
 SnXnor::dump(ostream& s) const
@@ -257,6 +290,15 @@ SnXnor2::_calc_fval()
   return ~(pat0 ^ pat1);
 }
 
+// @brief 故障値の配列を用いて故障値の計算を行う．
+tPackedVal
+SnXnor2::_calc_fval(const tPackedVal* fval_array)
+{
+  tPackedVal pat0 = fval_array[mFanins[0]->id()];
+  tPackedVal pat1 = fval_array[mFanins[1]->id()];
+  return ~(pat0 ^ pat1);
+}
+
 // @brief 内容をダンプする．
 void
 SnXnor2::dump(ostream& s) const
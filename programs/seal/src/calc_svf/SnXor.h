@@ -45,6 +45,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -98,6 +103,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 入力の擬似最小 obs を計算する．
   virtual
   void
@@ -151,6 +161,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 内容をダンプする．
   virtual
   void
@@ -189,6 +204,11 @@ public:
   tPackedVal
   _calc_fval();
 
+  /// @brief 故障値の配列を用いて故障値の計算を行う．
+  virtual
+  tPackedVal
+  _calc_fval(const tPackedVal* fval_array);
+
   /// @brief 内容をダンプする．
   virtual
   void
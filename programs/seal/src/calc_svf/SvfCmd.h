@@ -51,6 +51,9 @@ private:
   
   // time_frame オプションの解析用オブジェクト
   TclPoptUint* mPoptTf;
+
+  // compact オプションの解析用オブジェクト
+  TclPopt* mPoptCompact;
   
   // trace オプションの解析用オブジェクト
   TclPopt* mPoptTrace;
@@ -81,8 +84,32 @@ private:
   
   // gate オプションの解析用オブジェクト
   TclPopt* mPoptGate;
+
+  // threads オプションの解析用オブジェクト
+  TclPoptUint* mPoptThreads;
+
+  // seed オプションの解析用オブジェクト
+  TclPoptUint* mPoptSeed;
+
+  // error オプションの解析用オブジェクト
+  TclPoptDouble* mPoptError;
+
+  // confidence オプションの解析用オブジェクト
+  TclPoptDouble* mPoptConf;
+
+  // node-error オプションの解析用オブジェクト
+  TclPopt* mPoptNodeError;
   
   CalcSvf mCalc;
+
+  // mCalc にセットした時間展開数
+  size_t mTimeFrame;
+
+  // mCalc にセットした DSS フラグ
+  bool mDss;
+
+  // mCalc にセットした compact フラグ
+  bool mCompact;
   
 };
 
@@ -23,7 +23,7 @@ TestVector*
 TestVector::new_vector(ymuint ni)
 {
   ymuint nb = block_num(ni);
-  ymuint size = sizeof(TestVector) + kPvBitLen * (nb - 1);
+  ymuint size = sizeof(TestVector) + kPvWordLen * (nb - 1);
   char* p = new char[size];
   TestVector* tv = new (p) TestVector(ni);
   return tv;
@@ -36,6 +36,89 @@ TestVector::delete_vector(TestVector* tv)
   delete [] reinterpret_cast<char*>(tv);
 }
 
+BEGIN_NONAMESPACE
+
+// kPvWordLen x kPvWordLen のビット行列を転置する．
+// mat[r] の(最上位から数えて) c ビット目が mat[c] の r ビット目になる．
+// 半分の大きさのブロックの入れ替えを log2(kPvWordLen) 回行う．
+// 内側のループは互いに独立なのでコンパイラが SIMD 命令にベクトル化する．
+inline
+void
+transpose_block(tPvWord mat[])
+{
+  tPvWord mask = ~0UL >> (kPvWordLen / 2);
+  for (size_t j = kPvWordLen / 2; j > 0; j >>= 1, mask ^= (mask << j)) {
+    for (size_t k = 0; k < kPvWordLen; k = ((k | j) + 1) & ~j) {
+      tPvWord t = (mat[k] ^ (mat[k | j] >> j)) & mask;
+      mat[k] ^= t;
+      mat[k | j] ^= (t << j);
+    }
+  }
+}
+
+END_NONAMESPACE
+
+// @brief テストベクタの配列を入力ごとのビットベクタに変換する．
+// @param[in] tv_array テストベクタの配列 ( 要素数は kPvBitLen 以下 )
+// @param[in] ni 入力数
+// @param[out] val_array 入力番号をキーにしたビットベクタの配列
+void
+TestVector::pack(const vector<TestVector*>& tv_array,
+		 ymuint ni,
+		 vector<tPackedVal>& val_array)
+{
+  size_t nt = tv_array.size();
+  ASSERT_COND( nt <= kPvBitLen );
+
+  val_array.clear();
+  val_array.resize(ni, kPvAll0);
+
+  // ブロックごと，kPvWordLen パタンごとにビット行列を転置する．
+  tPvWord mat[kPvWordLen];
+  ymuint nb = block_num(ni);
+  for (ymuint blk = 0; blk < nb; ++ blk) {
+    ymuint base_i = blk * kPvWordLen;
+    ymuint ni1 = ni - base_i;
+    if ( ni1 > kPvWordLen ) {
+      ni1 = kPvWordLen;
+    }
+    for (size_t w = 0; w < kPvWordNum; ++ w) {
+      size_t base_b = w * kPvWordLen;
+      if ( base_b >= nt ) {
+	break;
+      }
+      // 転置後の r ビット目がパタン base_b + r になるように
+      // 逆順に並べておく．
+      for (size_t r = 0; r < kPvWordLen; ++ r) {
+	size_t b = base_b + r;
+	tPvWord pat = (b < nt) ? tv_array[b]->mPat[blk] : 0UL;
+	mat[kPvWordLen - 1 - r] = pat;
+      }
+      transpose_block(mat);
+      for (ymuint j = 0; j < ni1; ++ j) {
+	set_word(val_array[base_i + j], w, mat[j]);
+      }
+    }
+  }
+}
+
+// @brief 乱数パタンを入力ごとのビットベクタの形で直接作る．
+// @param[in] randgen 乱数生成器
+// @param[in] ni 入力数
+// @param[out] val_array 入力番号をキーにしたビットベクタの配列
+void
+TestVector::random_pack(RandGen& randgen,
+			ymuint ni,
+			vector<tPackedVal>& val_array)
+{
+  val_array.resize(ni);
+  for (ymuint i = 0; i < ni; ++ i) {
+    for (size_t w = 0; w < kPvWordNum; ++ w) {
+      set_word(val_array[i], w, randgen.ulong());
+    }
+  }
+}
+
 // @brief コンストラクタ
 // @param[in] 入力数を指定する．
 TestVector::TestVector(size_t ni) :
@@ -60,29 +143,29 @@ TestVector::set_from_hex(const string& hex_string)
   ymuint nl = hex_length(input_num());
   ymuint sft = 0;
   ymuint blk = 0;
-  tPackedVal pat = kPvAll0;
+  tPvWord pat = 0UL;
   for (ymuinnt i = 0; i < nl; ++ i) {
     char c = (i < hex_string.size()) ? hex_string[i] : '0';
-    tPackedVal pat1 = kPvAll0;
+    tPvWord pat1 = 0UL;
     if ( '0' <= c && c <= '9' ) {
-      pat1 = static_cast<tPackedVal>(c - '0');
+      pat1 = static_cast<tPvWord>(c - '0');
     }
     else if ( 'a' <= c && c <= 'f' ) {
-      pat1 = static_cast<tPackedVal>(c - 'a' + 10);
+      pat1 = static_cast<tPvWord>(c - 'a' + 10);
     }
     else if ( 'A' <= c && c <= 'F' ) {
-      pat1 = static_cast<tPackedVal>(c - 'A' + 10);
+      pat1 = static_cast<tPvWord>(c - 'A' + 10);
     }
     else {
       return false;
     }
     pat |= (pat1 << sft);
     sft += 4;
-    if ( sft == kPvBitLen ) {
+    if ( sft == kPvWordLen ) {
       mPat[blk] = pat;
       sft = 0;
       blk ++;
-      pat = kPvAll0;
+      pat = 0UL;
     }
   }
   if ( sft != 0 ) {
@@ -125,7 +208,7 @@ TestVector::dump_hex(ostream& s) const
   // よく問題になるが，ここでは最下位ビット側から出力する．
   ymuint nl = hex_length(input_num());
   ymuint prev_blk = block_num(input_num());
-  tPackedVal prev_pat = kPvAll0;
+  tPvWord prev_pat = 0UL;
   for (ymuint i = 0; i < nl; ++ i) {
     ymuint blk = i / HPW;
     if ( blk != prev_blk ) {
@@ -133,7 +216,7 @@ TestVector::dump_hex(ostream& s) const
       prev_blk = blk;
     }
     ymuint sft = (i % HPW) * 4;
-    tPackedVal pat1 = (prev_pat >> sft) & 0xF;
+    tPvWord pat1 = (prev_pat >> sft) & 0xF;
     if ( pat1 <= 9 ) {
       s << static_cast<char>('0' + pat1);
     }